@@ -6,10 +6,15 @@
  */ 
 
 #include "PlatformADC.h"
+#include "PlatformADCOversample.h"
 #include "PlatformClock.h"
 #include "PlatformPowerSave.h"
+#include "PlatformTimer.h"
+#include "PlatformInterrupt.h"
+#include "PlatformRingBuffer.h"
 #include "require_macros.h"
 #include <avr/io.h>
+#include <avr/eeprom.h>
 
 //======================//
 //       Defines        //
@@ -18,30 +23,166 @@
 #define PLATFORM_ADC_INPUT_CLOCK_MIN_HZ  ( 50000  )
 #define PLATFORM_ADC_INPUT_CLOCK_MAX_HZ  ( 200000 )
 
+// Above 200kHz the ADC no longer gives full 10-bit accuracy, but the upper bits remain usable
+#define PLATFORM_ADC_8BIT_INPUT_CLOCK_MAX_HZ ( 1000000 )
+
 #define PLATFORM_ADC_MAX_PRESCALER_VALUE ( 7 )
 #define PLATFORM_ADC_INVALID_PRESCALER   ( PLATFORM_ADC_MAX_PRESCALER_VALUE + 1 )
 
 #define PLATFORM_ADC_INVALID_DIV_FACTOR  ( 0 )
 
-#define PLATFORM_ADC_GET_MASK( X )       ( 1 << ( X ))
+#define PLATFORM_ADC_GET_MASK( X )       ( 1U << ( X ))
+
+// Only ADC0 - ADC5 have digital input buffers
+#define PLATFORM_ADC_HAS_INPUT_BUFFER( X ) (( X ) <= PlatformADC_ADC5 )
+
+// The temperature sensor and bandgap are internal inputs, which need time to settle after being selected
+#define PLATFORM_ADC_IS_INTERNAL_INPUT( X ) (( X ) >= PlatformADC_Temperature )
 
 #define PLATFORM_ADC_MUX_PIN_MASK        (( 1 << MUX0 ) | ( 1 << MUX1 ) | ( 1 << MUX2 ) | ( 1 << MUX3 ))
 
 #define PLATFORM_ADC_MUX_REF_MASK        (( 1 << REFS0 ) | ( 1 << REFS1 ))
 #define PLATFORM_ADC_VCC_AS_AREF         ( 1 << REFS0 )
+#define PLATFORM_ADC_INTERNAL_AS_AREF    (( 1 << REFS1 ) | ( 1 << REFS0 ))
+#define PLATFORM_ADC_EXTERNAL_AS_AREF    ( 0 )
+
+#define PLATFORM_ADC_MUX_TEMPERATURE     ( 1 << MUX3 )
+#define PLATFORM_ADC_MUX_BANDGAP         (( 1 << MUX3 ) | ( 1 << MUX2 ) | ( 1 << MUX1 ))
+
+// Conversions to discard after switching the reference or selecting the bandgap, about 1ms at a 125kHz ADC clock.
+// The bandgap needs time to start up, and a capacitor on AREF needs time to charge to the new reference.
+#define PLATFORM_ADC_SETTLE_CONVERSIONS  ( 10 )
+
+#define PLATFORM_ADC_BANDGAP_NOMINAL_MV  ( 1100 )
+#define PLATFORM_ADC_10BIT_RESULT_BITS   ( 10 )
+
+#define PLATFORM_ADC_TEMPERATURE_CALIBRATION_MAGIC ( 0x7C01 )
+#define PLATFORM_ADC_8BIT_RESULT_BITS    ( 8 )
+
+#define PLATFORM_ADC_PRESCALER_MASK      (( 1 << ADPS2 ) | ( 1 << ADPS1 ) | ( 1 << ADPS0 ))
+#define PLATFORM_ADC_TRIGGER_SOURCE_MASK (( 1 << ADTS2 ) | ( 1 << ADTS1 ) | ( 1 << ADTS0 ))
+
+#define PLATFORM_ADC_TRIGGER_SOURCE_FREE_RUNNING     ( 0 )
+#define PLATFORM_ADC_TRIGGER_SOURCE_TIMER0_COMPARE_A (( 1 << ADTS1 ) | ( 1 << ADTS0 ))
+#define PLATFORM_ADC_TRIGGER_SOURCE_TIMER1_COMPARE_B (( 1 << ADTS2 ) | ( 1 << ADTS0 ))
+
+// An auto triggered conversion takes 13.5 ADC clock cycles. See the ADC conversion timing in the ATmega328p datasheet.
+#define PLATFORM_ADC_TRIGGERED_CONVERSION_HALF_CYCLES ( 27 )
+
+#define PLATFORM_ADC_TIMER0_MAX_COUNTS   ( 256 )
+#define PLATFORM_ADC_TIMER1_TRIGGER_HZ   ( 1000 )
+
+//================//
+//    Typedefs    //
+//================//
+
+typedef enum
+{
+	PlatformADCSamplingMode_None,
+	PlatformADCSamplingMode_Triggered,
+	PlatformADCSamplingMode_Conversions,
+	PlatformADCSamplingMode_FreeRunning,
+	PlatformADCSamplingMode_Scan,
+	PlatformADCSamplingMode_NoiseReduction,
+} PlatformADCSamplingMode_t;
+
+typedef struct
+{
+	volatile PlatformADCSamplingMode_t mode;             // Changed in ISR
+	volatile size_t                    sampleIndex;      // Changed in ISR
+	volatile bool                      isComplete;       // Changed in ISR
+	uint16_t                          *samples;
+	size_t                             numSamples;
+	bool                               isContinuous;
+	PlatformADCTrigger_t               trigger;
+	volatile uint8_t                  *triggerFlagReg;   // Interrupt flag register of the trigger source, cleared after each conversion
+	uint8_t                            triggerFlagMask;
+	PlatformADC_SamplingCompleteCb     completeCb;
+	PlatformRingBuffer                *ringBuffer;       // Free running mode only
+	volatile uint16_t                  numDroppedSamples; // Changed in ISR
+	PlatformADCOversampler_t           oversampler;       // Buffered modes only; changed in ISR
+} PlatformADCSampling_t;
+
+typedef struct
+{
+	PlatformADC_t    inputs[ PLATFORM_ADC_SCAN_MAX_INPUTS ];
+	uint16_t         workingFrame[ PLATFORM_ADC_SCAN_MAX_INPUTS ];   // Filled by the ISR during a scan
+	uint16_t         completedFrame[ PLATFORM_ADC_SCAN_MAX_INPUTS ]; // Copied from the working frame at the end of each scan
+	uint8_t          numInputs;
+	uint8_t          inputIndex;
+	bool             discardFirstSample;
+	bool             isDiscarding;
+	volatile uint8_t frameCount;                                    // Changed in ISR
+} PlatformADCScan_t;
 
 //======================//
 //   Static Variables   //
 //======================//
 
-static uint8_t mPlatformADCInitializedADCs;
+static uint16_t                mPlatformADCInitializedADCs;
+static PlatformADCSampling_t   mPlatformADCSampling;
+static PlatformADCScan_t       mPlatformADCScan;
+static uint8_t                 mPlatformADCOversampleExtraBits[ PlatformADC_Max ];
+static PlatformADCResolution_t mPlatformADCResolution;
+static PlatformADCReference_t  mPlatformADCReference;
+static uint16_t                mPlatformADCVccMillivolts;              // Cached from the last PlatformADC_MeasureVcc(); 0 if never measured
+static uint16_t                mPlatformADCBandgapMillivolts = PLATFORM_ADC_BANDGAP_NOMINAL_MV;
+static uint16_t                mPlatformADCExternalReferenceMillivolts;
+
+static PlatformADCTemperatureCalibration_t mPlatformADCTemperatureCalibration;
+static bool                                mPlatformADCIsTemperatureCalibrationLoaded;
+
+// Stored as a magic number followed by the calibration, so an erased EEPROM falls back to the typical values
+static uint16_t                            EEMEM mPlatformADCTemperatureCalibrationMagicEEPROM;
+static PlatformADCTemperatureCalibration_t EEMEM mPlatformADCTemperatureCalibrationEEPROM;
+
+// Typical temperature sensor output from the ATmega328p datasheet: 242mV at -45C and 380mV at 85C, converted to counts against the 1.1V reference
+static const PlatformADCTemperatureCalibration_t kPlatformADCDefaultTemperatureCalibration = 
+{
+	.counts1      = 225,
+	.deciCelsius1 = -450,
+	.counts2      = 354,
+	.deciCelsius2 = 850,
+};
+
+static const uint8_t kPlatformADCMuxBits[ PlatformADC_Max ] = 
+{
+	0, 1, 2, 3, 4, 5, 6, 7,       // PlatformADC_ADC0 - PlatformADC_ADC7
+	PLATFORM_ADC_MUX_TEMPERATURE, // PlatformADC_Temperature
+	PLATFORM_ADC_MUX_BANDGAP,     // PlatformADC_Bandgap
+};
+
+static const uint8_t kPlatformADCReferenceBits[ PlatformADCReference_Max ] = 
+{
+	PLATFORM_ADC_VCC_AS_AREF,      // PlatformADCReference_AVcc
+	PLATFORM_ADC_INTERNAL_AS_AREF, // PlatformADCReference_Internal1V1
+	PLATFORM_ADC_EXTERNAL_AS_AREF, // PlatformADCReference_External
+};
+
+static const uint16_t kPlatformADCTimer0Prescalers[]   = { 1, 8, 64, 256, 1024 };
+static const uint8_t  kPlatformADCTimer0PrescaleBits[] = { 1, 2, 3, 4, 5 };
 
 //==================================//
 //   Static Function Declarations   //
 //==================================//
 
-static uint8_t _PlatformADC_GetInputClockPrescaler( void );
+static uint8_t _PlatformADC_GetInputClockPrescaler( uint32_t inMaxClockHz );
+static inline uint16_t _PlatformADC_GetResult( void );
+static uint16_t _PlatformADC_Convert( void );
+static void _PlatformADC_Settle( void );
+static PlatformStatus _PlatformADC_SelectInput( PlatformADC_t inADC );
+static void _PlatformADC_LoadTemperatureCalibration( void );
 static uint8_t _PlatformADC_GetDivisionFactorFromPrescaler( uint8_t inPrescaler );
+static uint32_t _PlatformADC_GetMaxTriggeredSampleRateHz( void );
+static PlatformStatus _PlatformADC_StartTimer0Trigger( uint32_t inRequestedSampleRateHz, uint32_t *const outActualSampleRateHz );
+static PlatformStatus _PlatformADC_PrepareSampling( PlatformADC_t                  inADC,
+                                                    uint16_t *const                outSamples,
+                                                    size_t                         inNumSamples,
+                                                    bool                           inContinuous,
+                                                    PlatformADC_SamplingCompleteCb inOptionalCompleteCb );
+static void _PlatformADC_StoreBufferedSample( uint16_t inSample );
+static void _PlatformADC_StoreScanSample( uint16_t inSample );
+static void _PlatformADC_StopSampling( void );
 
 //==================================//
 //   Public Function Definitions    //
@@ -65,18 +206,20 @@ PlatformStatus PlatformADC_Init( PlatformADC_t inADC )
 		require_noerr_quiet( status, exit );
 		
 		// Enable the ADC block and configure the ADC clock prescaler
-		uint8_t chosenPrescaler = _PlatformADC_GetInputClockPrescaler();
+		uint8_t chosenPrescaler = _PlatformADC_GetInputClockPrescaler( PLATFORM_ADC_INPUT_CLOCK_MAX_HZ );
 		require_quiet( chosenPrescaler != PLATFORM_ADC_INVALID_PRESCALER, exit );	
 		
-		ADCSRA |= ( 1 << ADEN ) | chosenPrescaler;
+		ADCSRA = ( ADCSRA & ~PLATFORM_ADC_PRESCALER_MASK ) | ( 1 << ADEN ) | chosenPrescaler;
 		
-		// Set the voltage reference source as Vcc
-		ADMUX &= ~PLATFORM_ADC_MUX_REF_MASK;
+		// Set the voltage reference source as Vcc, with full resolution right adjusted results
+		ADMUX &= ~( PLATFORM_ADC_MUX_REF_MASK | ( 1 << ADLAR ));
 		ADMUX |= PLATFORM_ADC_VCC_AS_AREF;
+		mPlatformADCResolution = PlatformADCResolution_10Bit;
+		mPlatformADCReference  = PlatformADCReference_AVcc;
 	}
 	
-	// Regardless, disable the specific input buffer to save power ( ADC6 and ADC7 do not have buffers )
-	if (( inADC != PlatformADC_ADC6 ) && ( inADC != PlatformADC_ADC7 ))
+	// Regardless, disable the specific input buffer to save power ( ADC6, ADC7 and the internal inputs do not have buffers )
+	if ( PLATFORM_ADC_HAS_INPUT_BUFFER( inADC ))
 	{
 		DIDR0 |= PLATFORM_ADC_GET_MASK( inADC );
 	}
@@ -91,7 +234,9 @@ exit:
 
 PlatformStatus PlatformADC_Read( PlatformADC_t inADC, uint16_t *const outADCValue )
 {
-	PlatformStatus status = PlatformStatus_Failed;
+	PlatformStatus           status = PlatformStatus_Failed;
+	PlatformADCOversampler_t oversampler;
+	uint16_t                 sample;
 	
 	require_quiet( inADC < PlatformADC_Max, exit );
 	require_quiet( outADCValue,             exit );
@@ -99,58 +244,265 @@ PlatformStatus PlatformADC_Read( PlatformADC_t inADC, uint16_t *const outADCValu
 	// Check that this ADC is initialized
 	require_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( inADC ), exit );
 	
+	// Check that the ADC is not busy sampling in the background
+	require_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit );
+	
 	// Sanity check that there is no conversion currently in progress
 	require_quiet(( ADCSRA & ( 1 << ADSC )) == 0, exit );
 	
-	// Clear the previous ADC input MUX selection
-	ADMUX &= ~( PLATFORM_ADC_MUX_PIN_MASK );
-	
 	// Select the ADC input from the MUX
-	ADMUX |= inADC;
+	status = _PlatformADC_SelectInput( inADC );
+	require_noerr_quiet( status, exit );
+	status = PlatformStatus_Failed;
 	
-	// Start a new conversion
-	ADCSRA |= ( 1 << ADSC );
+	require_noerr_quiet( PlatformADCOversample_Init( &oversampler, mPlatformADCOversampleExtraBits[ inADC ] ), exit );
 	
-	// Wait for conversion complete
-	while( ADCSRA & ( 1 << ADSC ));
+	// Convert until the oversampler has a result; a single conversion if oversampling is off
+	do
+	{
+		sample = _PlatformADC_Convert();
+	} while ( !PlatformADCOversample_AddSample( &oversampler, sample, outADCValue ));
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_ReadNoiseReduced( PlatformADC_t inADC, uint16_t *const outADCValue )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	status = _PlatformADC_PrepareSampling( inADC, outADCValue, 1, false, NULL );
+	require_noerr_quiet( status, exit );
+	
+	mPlatformADCSampling.mode = PlatformADCSamplingMode_NoiseReduction;
+	
+	// Clear any stale conversion complete flag, and enable the conversion complete interrupt to wake the CPU up
+	ADCSRA |= ( 1 << ADIF );
+	ADCSRA |= ( 1 << ADIE );
+	
+	// Entering ADC Noise Reduction mode starts the conversion automatically. If another interrupt wakes the CPU up first,
+	// the conversion keeps running, so sleep again until the ISR has stored the result.
+	PlatformInterrupt_DisableGlobalInterrupts();
+	while ( !mPlatformADCSampling.isComplete )
+	{
+		PlatformPowerSave_Sleep( PlatformPowerSaveSleepMode_ADCNoiseReduction );
+		PlatformInterrupt_DisableGlobalInterrupts();
+	}
+	PlatformInterrupt_EnableGlobalInterrupts();
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_StartTriggeredSampling( PlatformADC_t                  inADC,
+                                                   PlatformADCTrigger_t           inTrigger,
+                                                   uint32_t                       inRequestedSampleRateHz,
+                                                   uint32_t *const                outActualSampleRateHz,
+                                                   uint16_t *const                outSamples,
+                                                   size_t                         inNumSamples,
+                                                   bool                           inContinuous,
+                                                   PlatformADC_SamplingCompleteCb inOptionalCompleteCb )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	uint32_t actualSampleRateHz;
+	uint32_t ticks;
+	
+	require_quiet( inTrigger < PlatformADCTrigger_Max, exit );
+	
+	status = _PlatformADC_PrepareSampling( inADC, outSamples, inNumSamples, inContinuous, inOptionalCompleteCb );
+	require_noerr_quiet( status, exit );
+	
+	mPlatformADCSampling.trigger = inTrigger;
+	
+	// Set up the trigger source
+	if ( inTrigger == PlatformADCTrigger_Timer0CompareA )
+	{
+		require_action_quiet( inRequestedSampleRateHz && ( inRequestedSampleRateHz <= _PlatformADC_GetMaxTriggeredSampleRateHz()), exit, status = PlatformStatus_InvalidArgument );
+		
+		status = _PlatformADC_StartTimer0Trigger( inRequestedSampleRateHz, &actualSampleRateHz );
+		require_noerr_quiet( status, exit );
+		
+		mPlatformADCSampling.triggerFlagReg  = &TIFR0;
+		mPlatformADCSampling.triggerFlagMask = ( 1 << OCF0A );
+		
+		ADCSRB = ( ADCSRB & ~PLATFORM_ADC_TRIGGER_SOURCE_MASK ) | PLATFORM_ADC_TRIGGER_SOURCE_TIMER0_COMPARE_A;
+	}
+	else
+	{
+		// Timer1 is owned by PlatformTimer, and must already be running
+		status = PlatformTimer_GetTicks( &ticks );
+		require_noerr_quiet( status, exit );
+		
+		// Match at the start of every millisecond period
+		OCR1B = 0;
+		actualSampleRateHz = PLATFORM_ADC_TIMER1_TRIGGER_HZ;
+		
+		mPlatformADCSampling.triggerFlagReg  = &TIFR1;
+		mPlatformADCSampling.triggerFlagMask = ( 1 << OCF1B );
+		
+		ADCSRB = ( ADCSRB & ~PLATFORM_ADC_TRIGGER_SOURCE_MASK ) | PLATFORM_ADC_TRIGGER_SOURCE_TIMER1_COMPARE_B;
+	}
 	
-	// Get the ADC Value; LSB Register must be read first.
-	*outADCValue = ADCL;
-	*outADCValue |= ADCH << 8;
+	if ( outActualSampleRateHz )
+	{
+		*outActualSampleRateHz = actualSampleRateHz;
+	}
+	
+	// A conversion is only triggered on a rising edge of the trigger flag, so clear any flag that is already set
+	*mPlatformADCSampling.triggerFlagReg = mPlatformADCSampling.triggerFlagMask;
+	
+	mPlatformADCSampling.mode = PlatformADCSamplingMode_Triggered;
+	
+	// Clear any stale conversion complete flag, then enable the conversion complete interrupt and auto triggering
+	ADCSRA |= ( 1 << ADIF );
+	ADCSRA |= ( 1 << ADIE ) | ( 1 << ADATE );
+	PlatformInterrupt_EnableGlobalInterrupts();
 	
 	status = PlatformStatus_Success;
 exit:
 	return status;
 }
 
-PlatformStatus PlatformADC_Deinit( PlatformADC_t inADC )
+PlatformStatus PlatformADC_StartConversions( PlatformADC_t                  inADC,
+                                            uint16_t *const                outSamples,
+                                            size_t                         inNumSamples,
+                                            PlatformADC_SamplingCompleteCb inOptionalCompleteCb )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	status = _PlatformADC_PrepareSampling( inADC, outSamples, inNumSamples, false, inOptionalCompleteCb );
+	require_noerr_quiet( status, exit );
+	
+	mPlatformADCSampling.mode = PlatformADCSamplingMode_Conversions;
+	
+	// Clear any stale conversion complete flag, enable the conversion complete interrupt, and start the first conversion.
+	// The ISR starts each following conversion.
+	ADCSRA |= ( 1 << ADIF );
+	ADCSRA |= ( 1 << ADIE );
+	PlatformInterrupt_EnableGlobalInterrupts();
+	ADCSRA |= ( 1 << ADSC );
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_StartFreeRunning( PlatformADC_t inADC, PlatformRingBuffer *const inRingBuffer )
 {
 	PlatformStatus status = PlatformStatus_Failed;
 	
-	// Check this is a valid ADC
 	require_quiet( inADC < PlatformADC_Max, exit );
+	require_quiet( inRingBuffer,            exit );
 	
 	// Check that this ADC is initialized
-	require_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( inADC ), exit );
+	require_action_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( inADC ), exit, status = PlatformStatus_NotInitialized );
+	
+	// Check that the ADC is idle
+	require_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit );
+	require_quiet(( ADCSRA & ( 1 << ADSC )) == 0, exit );
+	
+	mPlatformADCSampling.ringBuffer        = inRingBuffer;
+	mPlatformADCSampling.numDroppedSamples = 0;
+	mPlatformADCSampling.isComplete        = false;
+	
+	// Select the ADC input from the MUX
+	status = _PlatformADC_SelectInput( inADC );
+	require_noerr_quiet( status, exit );
+	status = PlatformStatus_Failed;
 	
-	// Enable the specific input buffer for future digital inputs (ADC6 and ADC7 do not have buffers)
-	if (( inADC != PlatformADC_ADC6 ) && ( inADC != PlatformADC_ADC7 ))
+	// In free running mode, each conversion complete flag triggers the next conversion
+	ADCSRB = ( ADCSRB & ~PLATFORM_ADC_TRIGGER_SOURCE_MASK ) | PLATFORM_ADC_TRIGGER_SOURCE_FREE_RUNNING;
+	
+	mPlatformADCSampling.mode = PlatformADCSamplingMode_FreeRunning;
+	
+	// Clear any stale conversion complete flag, enable the interrupt and auto triggering, and start the first conversion
+	ADCSRA |= ( 1 << ADIF );
+	ADCSRA |= ( 1 << ADIE ) | ( 1 << ADATE );
+	PlatformInterrupt_EnableGlobalInterrupts();
+	ADCSRA |= ( 1 << ADSC );
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_ReadStreamedSamples( uint16_t *const outSamples, size_t inNumSamples, uint16_t *const outOptionalNumDropped )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( outSamples,   exit );
+	require_quiet( inNumSamples, exit );
+	require_quiet( mPlatformADCSampling.ringBuffer, exit );
+	
+	if ( mPlatformADCResolution == PlatformADCResolution_8Bit )
 	{
-		DIDR0 &= ~PLATFORM_ADC_GET_MASK( inADC );	
+		uint8_t *const sampleBytes = ( uint8_t* )outSamples;
+		size_t index;
+		
+		// Each 8-bit sample is stored in the ring buffer as one byte. Read them into the front of the output,
+		// then widen them in place from the end, so no byte is overwritten before it is read.
+		status = PlatformRingBuffer_ReadBuffer( mPlatformADCSampling.ringBuffer, sampleBytes, inNumSamples );
+		require_noerr_quiet( status, exit );
+		
+		for ( index = inNumSamples; index > 0; index-- )
+		{
+			outSamples[ index - 1 ] = sampleBytes[ index - 1 ];
+		}
+	}
+	else
+	{
+		// Each sample is stored in the ring buffer as two bytes, LSB first
+		status = PlatformRingBuffer_ReadBuffer( mPlatformADCSampling.ringBuffer, ( uint8_t* )outSamples, inNumSamples * sizeof( uint16_t ));
+		require_noerr_quiet( status, exit );
 	}
+	
+	if ( outOptionalNumDropped )
+	{
+		// Disable Global Interrupts, if enabled, since the count cannot be read and cleared atomically
+		if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+		{
+			PlatformInterrupt_DisableGlobalInterrupts();
+			didDisableInterrupts = true;
+		}
 		
-	// Remove from the list of initialized ADC inputs
-	mPlatformADCInitializedADCs &= ~PLATFORM_ADC_GET_MASK( inADC );
+		*outOptionalNumDropped = mPlatformADCSampling.numDroppedSamples;
+		mPlatformADCSampling.numDroppedSamples = 0;
+	}
 	
-	// If there are no more initialized ADC inputs:
-	if ( mPlatformADCInitializedADCs == 0 )
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
 	{
-		// Disable the ADC block
-		ADCSRA &= ~( 1 << ADEN );
-				
-		// Enable PowerSave
-		status = PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_ADC );
-		require_noerr_quiet( status, exit );
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformADC_SetReference( PlatformADCReference_t inReference, uint16_t inExternalReferenceMillivolts )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inReference < PlatformADCReference_Max, exit );
+	require_quiet(( inReference != PlatformADCReference_External ) || inExternalReferenceMillivolts, exit );
+	
+	// The ADC block must be enabled and idle
+	require_action_quiet( mPlatformADCInitializedADCs, exit, status = PlatformStatus_NotInitialized );
+	require_action_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit, status = PlatformStatus_Failed );
+	require_action_quiet(( ADCSRA & ( 1 << ADSC )) == 0, exit, status = PlatformStatus_Failed );
+	
+	if ( inReference == PlatformADCReference_External )
+	{
+		mPlatformADCExternalReferenceMillivolts = inExternalReferenceMillivolts;
+	}
+	
+	if ( inReference != mPlatformADCReference )
+	{
+		ADMUX = ( ADMUX & ~PLATFORM_ADC_MUX_REF_MASK ) | kPlatformADCReferenceBits[ inReference ];
+		mPlatformADCReference = inReference;
+		
+		// The first conversions after changing the reference may be inaccurate
+		_PlatformADC_Settle();
 	}
 	
 	status = PlatformStatus_Success;
@@ -158,47 +510,816 @@ exit:
 	return status;
 }
 
-//==================================//
-//   Static Function Definitions    //
-//==================================//
+PlatformStatus PlatformADC_MeasureVcc( uint16_t *const outOptionalVccMillivolts )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	uint8_t        savedADMUX;
+	uint16_t       bandgapCounts;
+	uint8_t        resultBits;
+	
+	// The ADC block must be enabled and idle
+	require_action_quiet( mPlatformADCInitializedADCs, exit, status = PlatformStatus_NotInitialized );
+	require_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit );
+	require_quiet(( ADCSRA & ( 1 << ADSC )) == 0, exit );
+	
+	// Switching to AVcc would short it to an external voltage applied on AREF
+	require_action_quiet( mPlatformADCReference != PlatformADCReference_External, exit, status = PlatformStatus_NotSupported );
+	
+	// Measure the bandgap against AVcc: counts = ( VBandgap * 2^bits ) / Vcc
+	savedADMUX = ADMUX;
+	ADMUX = ( ADMUX & ~( PLATFORM_ADC_MUX_REF_MASK | PLATFORM_ADC_MUX_PIN_MASK )) | PLATFORM_ADC_VCC_AS_AREF | PLATFORM_ADC_MUX_BANDGAP;
+	
+	_PlatformADC_Settle();
+	bandgapCounts = _PlatformADC_Convert();
+	
+	// Restore the reference and input, and let the reference settle again if it was changed
+	ADMUX = savedADMUX;
+	if ( mPlatformADCReference != PlatformADCReference_AVcc )
+	{
+		_PlatformADC_Settle();
+	}
+	
+	require_quiet( bandgapCounts, exit );
+	
+	resultBits = ( mPlatformADCResolution == PlatformADCResolution_8Bit ) ? PLATFORM_ADC_8BIT_RESULT_BITS : PLATFORM_ADC_10BIT_RESULT_BITS;
+	mPlatformADCVccMillivolts = ( uint16_t )(((( uint32_t )mPlatformADCBandgapMillivolts << resultBits ) + ( bandgapCounts / 2 )) / bandgapCounts );
+	
+	if ( outOptionalVccMillivolts )
+	{
+		*outOptionalVccMillivolts = mPlatformADCVccMillivolts;
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
 
-static uint8_t _PlatformADC_GetInputClockPrescaler( void )
+PlatformStatus PlatformADC_SetBandgapMillivolts( uint16_t inBandgapMillivolts )
 {
-	uint8_t minDivisionFactor;
-	uint8_t chosenDivisionFactor;
-	uint8_t chosenPrescaler = PLATFORM_ADC_INVALID_PRESCALER;
+	PlatformStatus status = PlatformStatus_InvalidArgument;
 	
-	// Calculate the min division factor needed for the prescaler to the ADC input clock.
-	minDivisionFactor = F_CPU / PLATFORM_ADC_INPUT_CLOCK_MAX_HZ;
-			
-	// Loop and find the fastest acceptable prescaler setting
-	for ( uint8_t i = 1; i <= PLATFORM_ADC_MAX_PRESCALER_VALUE; i++ )
+	require_quiet( inBandgapMillivolts, exit );
+	
+	mPlatformADCBandgapMillivolts = inBandgapMillivolts;
+	
+	// The cached Vcc was calculated from the old value
+	mPlatformADCVccMillivolts = 0;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_CountsToMillivolts( PlatformADC_t inADC, uint16_t inCounts, uint16_t *const outMillivolts )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint16_t       referenceMillivolts;
+	uint8_t        resultBits;
+	
+	require_quiet( inADC < PlatformADC_Max, exit );
+	require_quiet( outMillivolts,           exit );
+	
+	switch ( mPlatformADCReference )
 	{
-		chosenDivisionFactor = _PlatformADC_GetDivisionFactorFromPrescaler( i );
-		require_quiet( chosenDivisionFactor != PLATFORM_ADC_INVALID_DIV_FACTOR, exit );
-		
-		if ( chosenDivisionFactor > minDivisionFactor )
+		case PlatformADCReference_Internal1V1:
 		{
-			chosenPrescaler = i;
+			referenceMillivolts = mPlatformADCBandgapMillivolts;
+			break;
+		}
+		case PlatformADCReference_External:
+		{
+			referenceMillivolts = mPlatformADCExternalReferenceMillivolts;
+			break;
+		}
+		case PlatformADCReference_AVcc:
+		default:
+		{
+			referenceMillivolts = mPlatformADCVccMillivolts;
 			break;
 		}
 	}
+	require_action_quiet( referenceMillivolts, exit, status = PlatformStatus_NotInitialized );
+	
+	// The full scale of a result depends on the resolution and the input's oversampling
+	resultBits  = ( mPlatformADCResolution == PlatformADCResolution_8Bit ) ? PLATFORM_ADC_8BIT_RESULT_BITS : PLATFORM_ADC_10BIT_RESULT_BITS;
+	resultBits += mPlatformADCOversampleExtraBits[ inADC ];
+	
+	// mV = ( counts * VRef ) / 2^bits, rounded. Fits in 32 bits for any 16-bit count and reference.
+	*outMillivolts = ( uint16_t )(((( uint32_t )inCounts * referenceMillivolts ) + ( 1UL << ( resultBits - 1 ))) >> resultBits );
 	
+	status = PlatformStatus_Success;
 exit:
-	return chosenPrescaler;
+	return status;
 }
 
-static uint8_t _PlatformADC_GetDivisionFactorFromPrescaler( uint8_t inPrescaler )
+PlatformStatus PlatformADC_ReadTemperature( int16_t *const outDeciCelsius )
 {
-	uint8_t divFactor = PLATFORM_ADC_INVALID_DIV_FACTOR;
+	PlatformStatus                                   status             = PlatformStatus_InvalidArgument;
+	bool                                             didSwitchReference = false;
+	const PlatformADCTemperatureCalibration_t *const calibration        = &mPlatformADCTemperatureCalibration;
+	uint16_t                                         counts;
+	uint8_t                                          extraBits;
+	int32_t                                          countsOffset;
+	int32_t                                          countsSpan;
 	
-	if ( inPrescaler == 0 )
+	require_quiet( outDeciCelsius, exit );
+	
+	// Check that the temperature sensor input is initialized
+	require_action_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( PlatformADC_Temperature ), exit, status = PlatformStatus_NotInitialized );
+	
+	// The calibration is in 10-bit counts, and switching away from an external reference would short it
+	require_action_quiet( mPlatformADCResolution == PlatformADCResolution_10Bit, exit, status = PlatformStatus_NotSupported );
+	require_action_quiet( mPlatformADCReference != PlatformADCReference_External, exit, status = PlatformStatus_NotSupported );
+	
+	// The temperature sensor must be measured against the internal reference
+	if ( mPlatformADCReference != PlatformADCReference_Internal1V1 )
 	{
-		divFactor = 2;
+		status = PlatformADC_SetReference( PlatformADCReference_Internal1V1, 0 );
+		require_noerr_quiet( status, exit );
+		didSwitchReference = true;
 	}
-	else if ( inPrescaler <= PLATFORM_ADC_MAX_PRESCALER_VALUE )
+	
+	status = PlatformADC_Read( PlatformADC_Temperature, &counts );
+	require_noerr_quiet( status, exit );
+	
+	_PlatformADC_LoadTemperatureCalibration();
+	
+	// Interpolate linearly between the two calibration points, scaling them up to the input's oversampled counts
+	extraBits    = mPlatformADCOversampleExtraBits[ PlatformADC_Temperature ];
+	countsOffset = ( int32_t )counts - (( int32_t )calibration->counts1 << extraBits );
+	countsSpan   = ( int32_t )( calibration->counts2 - calibration->counts1 ) << extraBits;
+	
+	*outDeciCelsius = ( int16_t )( calibration->deciCelsius1 + (( countsOffset * ( calibration->deciCelsius2 - calibration->deciCelsius1 )) / countsSpan ));
+	
+exit:
+	// Restore the reference, if we switched it
+	if ( didSwitchReference )
 	{
-		divFactor = ( 1 << inPrescaler);
+		PlatformADC_SetReference( PlatformADCReference_AVcc, 0 );
+	}
+	return status;
+}
+
+PlatformStatus PlatformADC_SetTemperatureCalibration( const PlatformADCTemperatureCalibration_t *const inCalibration )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inCalibration, exit );
+	
+	// The second point must be hotter, with a higher count, for the interpolation
+	require_quiet( inCalibration->counts2 > inCalibration->counts1,                                   exit );
+	require_quiet( inCalibration->deciCelsius2 > inCalibration->deciCelsius1,                         exit );
+	require_quiet( inCalibration->deciCelsius1 >= PLATFORM_ADC_TEMPERATURE_CALIBRATION_MIN_DECI_CELSIUS, exit );
+	require_quiet( inCalibration->deciCelsius2 <= PLATFORM_ADC_TEMPERATURE_CALIBRATION_MAX_DECI_CELSIUS, exit );
+	
+	// Only bytes that changed are written, to save EEPROM wear
+	eeprom_update_block( inCalibration, &mPlatformADCTemperatureCalibrationEEPROM, sizeof( *inCalibration ));
+	eeprom_update_word( &mPlatformADCTemperatureCalibrationMagicEEPROM, PLATFORM_ADC_TEMPERATURE_CALIBRATION_MAGIC );
+	
+	mPlatformADCTemperatureCalibration         = *inCalibration;
+	mPlatformADCIsTemperatureCalibrationLoaded = true;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_GetTemperatureCalibration( PlatformADCTemperatureCalibration_t *const outCalibration )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( outCalibration, exit );
+	
+	_PlatformADC_LoadTemperatureCalibration();
+	*outCalibration = mPlatformADCTemperatureCalibration;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_SetOversampling( PlatformADC_t inADC, uint8_t inExtraBits )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inADC < PlatformADC_Max,                               exit );
+	require_quiet( inExtraBits <= PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS, exit );
+	
+	// Check that this ADC is initialized
+	require_action_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( inADC ), exit, status = PlatformStatus_NotInitialized );
+	
+	// Don't change the setting under a sampling that is in progress
+	require_action_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit, status = PlatformStatus_Failed );
+	
+	mPlatformADCOversampleExtraBits[ inADC ] = inExtraBits;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_SetResolution( PlatformADCResolution_t inResolution )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint8_t        chosenPrescaler;
+	
+	require_quiet( inResolution < PlatformADCResolution_Max, exit );
+	
+	// The ADC block must be enabled and idle
+	require_action_quiet( mPlatformADCInitializedADCs, exit, status = PlatformStatus_NotInitialized );
+	require_action_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit, status = PlatformStatus_Failed );
+	require_action_quiet(( ADCSRA & ( 1 << ADSC )) == 0, exit, status = PlatformStatus_Failed );
+	
+	if ( inResolution == PlatformADCResolution_8Bit )
+	{
+		chosenPrescaler = _PlatformADC_GetInputClockPrescaler( PLATFORM_ADC_8BIT_INPUT_CLOCK_MAX_HZ );
+	}
+	else
+	{
+		chosenPrescaler = _PlatformADC_GetInputClockPrescaler( PLATFORM_ADC_INPUT_CLOCK_MAX_HZ );
+	}
+	require_action_quiet( chosenPrescaler != PLATFORM_ADC_INVALID_PRESCALER, exit, status = PlatformStatus_Failed );
+	
+	// Left adjust the result in 8-bit mode, so the 8 most significant bits can be read from ADCH alone
+	if ( inResolution == PlatformADCResolution_8Bit )
+	{
+		ADMUX |= ( 1 << ADLAR );
+	}
+	else
+	{
+		ADMUX &= ~( 1 << ADLAR );
+	}
+	
+	ADCSRA = ( ADCSRA & ~PLATFORM_ADC_PRESCALER_MASK ) | chosenPrescaler;
+	mPlatformADCResolution = inResolution;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_StartScan( const PlatformADC_t *const     inInputs,
+                                     uint8_t                        inNumInputs,
+                                     bool                           inDiscardFirstSample,
+                                     bool                           inContinuous,
+                                     PlatformADC_SamplingCompleteCb inOptionalFrameCompleteCb )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	require_quiet( inInputs, exit );
+	require_quiet(( inNumInputs > 0 ) && ( inNumInputs <= PLATFORM_ADC_SCAN_MAX_INPUTS ), exit );
+	
+	// Check that the ADC is idle before touching the input list, since a running scan's ISR reads from it
+	require_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit );
+	require_quiet(( ADCSRA & ( 1 << ADSC )) == 0, exit );
+	
+	// Check that every input is valid and initialized
+	for ( uint8_t i = 0; i < inNumInputs; i++ )
+	{
+		require_quiet( inInputs[i] < PlatformADC_Max, exit );
+		require_action_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( inInputs[i] ), exit, status = PlatformStatus_NotInitialized );
+		
+		// The temperature sensor is only valid against the internal reference
+		require_action_quiet(( inInputs[i] != PlatformADC_Temperature ) || ( mPlatformADCReference == PlatformADCReference_Internal1V1 ), exit, status = PlatformStatus_NotSupported );
+		
+		mPlatformADCScan.inputs[i] = inInputs[i];
+	}
+	
+	mPlatformADCScan.numInputs          = inNumInputs;
+	mPlatformADCScan.inputIndex         = 0;
+	mPlatformADCScan.discardFirstSample = inDiscardFirstSample;
+	mPlatformADCScan.isDiscarding       = inDiscardFirstSample;
+	mPlatformADCScan.frameCount         = 0;
+	
+	mPlatformADCSampling.isContinuous = inContinuous;
+	mPlatformADCSampling.isComplete   = false;
+	mPlatformADCSampling.completeCb   = inOptionalFrameCompleteCb;
+	
+	// Select the first ADC input from the MUX
+	ADMUX = ( ADMUX & ~PLATFORM_ADC_MUX_PIN_MASK ) | kPlatformADCMuxBits[ mPlatformADCScan.inputs[0] ];
+	
+	mPlatformADCSampling.mode = PlatformADCSamplingMode_Scan;
+	
+	// Clear any stale conversion complete flag, enable the conversion complete interrupt, and start the first conversion.
+	// The ISR switches the MUX and starts each following conversion.
+	ADCSRA |= ( 1 << ADIF );
+	ADCSRA |= ( 1 << ADIE );
+	PlatformInterrupt_EnableGlobalInterrupts();
+	ADCSRA |= ( 1 << ADSC );
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformADC_GetScanFrame( uint16_t *const outFrame, uint8_t *const outOptionalFrameCount )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( outFrame, exit );
+	require_quiet( mPlatformADCScan.numInputs, exit );
+	
+	// Disable Global Interrupts, if enabled, so the frame cannot be updated part way through the copy
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	// Check that at least one scan has completed
+	require_quiet( mPlatformADCScan.frameCount, exit );
+	
+	for ( uint8_t i = 0; i < mPlatformADCScan.numInputs; i++ )
+	{
+		outFrame[i] = mPlatformADCScan.completedFrame[i];
+	}
+	
+	if ( outOptionalFrameCount )
+	{
+		*outOptionalFrameCount = mPlatformADCScan.frameCount;
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformADC_GetSamplingProgress( size_t *const outNumSamples, bool *const outIsComplete )
+{
+	bool didDisableInterrupts = false;
+	
+	// Disable Global Interrupts, if enabled, since the sample index cannot be read atomically
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	if ( outNumSamples )
+	{
+		*outNumSamples = mPlatformADCSampling.sampleIndex;
+	}
+	
+	if ( outIsComplete )
+	{
+		*outIsComplete = mPlatformADCSampling.isComplete;
+	}
+	
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformADC_StopSampling( void )
+{
+	bool didDisableInterrupts = false;
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	if ( mPlatformADCSampling.mode != PlatformADCSamplingMode_None )
+	{
+		_PlatformADC_StopSampling();
+	}
+	
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformADC_Deinit( PlatformADC_t inADC )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	// Check this is a valid ADC
+	require_quiet( inADC < PlatformADC_Max, exit );
+	
+	// Check that this ADC is initialized
+	require_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( inADC ), exit );
+	
+	// Enable the specific input buffer for future digital inputs (ADC6, ADC7 and the internal inputs do not have buffers)
+	if ( PLATFORM_ADC_HAS_INPUT_BUFFER( inADC ))
+	{
+		DIDR0 &= ~PLATFORM_ADC_GET_MASK( inADC );	
+	}
+		
+	// Remove from the list of initialized ADC inputs, and reset its oversampling
+	mPlatformADCInitializedADCs &= ~PLATFORM_ADC_GET_MASK( inADC );
+	mPlatformADCOversampleExtraBits[ inADC ] = 0;
+	
+	// If there are no more initialized ADC inputs:
+	if ( mPlatformADCInitializedADCs == 0 )
+	{
+		// Stop any sampling in the background
+		PlatformADC_StopSampling();
+		
+		// Disable the ADC block
+		ADCSRA &= ~( 1 << ADEN );
+				
+		// Enable PowerSave
+		status = PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_ADC );
+		require_noerr_quiet( status, exit );
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+//==================================//
+//   Static Function Definitions    //
+//==================================//
+
+static uint8_t _PlatformADC_GetInputClockPrescaler( uint32_t inMaxClockHz )
+{
+	uint8_t minDivisionFactor;
+	uint8_t chosenDivisionFactor;
+	uint8_t chosenPrescaler = PLATFORM_ADC_INVALID_PRESCALER;
+	
+	// Calculate the min division factor needed for the prescaler to the ADC input clock.
+	minDivisionFactor = F_CPU / inMaxClockHz;
+			
+	// Loop and find the fastest acceptable prescaler setting
+	for ( uint8_t i = 1; i <= PLATFORM_ADC_MAX_PRESCALER_VALUE; i++ )
+	{
+		chosenDivisionFactor = _PlatformADC_GetDivisionFactorFromPrescaler( i );
+		require_quiet( chosenDivisionFactor != PLATFORM_ADC_INVALID_DIV_FACTOR, exit );
+		
+		if ( chosenDivisionFactor >= minDivisionFactor )
+		{
+			chosenPrescaler = i;
+			break;
+		}
+	}
+	
+exit:
+	return chosenPrescaler;
+}
+
+static uint8_t _PlatformADC_GetDivisionFactorFromPrescaler( uint8_t inPrescaler )
+{
+	uint8_t divFactor = PLATFORM_ADC_INVALID_DIV_FACTOR;
+	
+	if ( inPrescaler == 0 )
+	{
+		divFactor = 2;
+	}
+	else if ( inPrescaler <= PLATFORM_ADC_MAX_PRESCALER_VALUE )
+	{
+		divFactor = ( 1 << inPrescaler);
+	}
+	return divFactor;
+}
+
+static PlatformStatus _PlatformADC_PrepareSampling( PlatformADC_t                  inADC,
+                                                    uint16_t *const                outSamples,
+                                                    size_t                         inNumSamples,
+                                                    bool                           inContinuous,
+                                                    PlatformADC_SamplingCompleteCb inOptionalCompleteCb )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	require_quiet( inADC < PlatformADC_Max, exit );
+	require_quiet( outSamples,              exit );
+	require_quiet( inNumSamples,            exit );
+	
+	// Check that this ADC is initialized
+	require_action_quiet( mPlatformADCInitializedADCs & PLATFORM_ADC_GET_MASK( inADC ), exit, status = PlatformStatus_NotInitialized );
+	
+	// Check that the ADC is idle
+	require_quiet( mPlatformADCSampling.mode == PlatformADCSamplingMode_None, exit );
+	require_quiet(( ADCSRA & ( 1 << ADSC )) == 0, exit );
+	
+	mPlatformADCSampling.samples      = outSamples;
+	mPlatformADCSampling.numSamples   = inNumSamples;
+	mPlatformADCSampling.sampleIndex  = 0;
+	mPlatformADCSampling.isContinuous = inContinuous;
+	mPlatformADCSampling.isComplete   = false;
+	mPlatformADCSampling.completeCb   = inOptionalCompleteCb;
+	
+	require_noerr_quiet( PlatformADCOversample_Init( &mPlatformADCSampling.oversampler, mPlatformADCOversampleExtraBits[ inADC ] ), exit );
+	
+	// Select the ADC input from the MUX
+	status = _PlatformADC_SelectInput( inADC );
+	require_noerr_quiet( status, exit );
+	status = PlatformStatus_Failed;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+static void _PlatformADC_StoreBufferedSample( uint16_t inSample )
+{
+	uint16_t result;
+	
+	// Only store once the oversampler has decimated enough samples
+	if ( !PlatformADCOversample_AddSample( &mPlatformADCSampling.oversampler, inSample, &result ))
+	{
+		return;
+	}
+	
+	mPlatformADCSampling.samples[ mPlatformADCSampling.sampleIndex ] = result;
+	mPlatformADCSampling.sampleIndex++;
+	
+	if ( mPlatformADCSampling.sampleIndex >= mPlatformADCSampling.numSamples )
+	{
+		if ( mPlatformADCSampling.isContinuous )
+		{
+			mPlatformADCSampling.sampleIndex = 0;
+		}
+		else
+		{
+			_PlatformADC_StopSampling();
+			mPlatformADCSampling.isComplete = true;
+		}
+		
+		// Callback, if it exists
+		if ( mPlatformADCSampling.completeCb )
+		{
+			mPlatformADCSampling.completeCb( mPlatformADCSampling.samples, mPlatformADCSampling.numSamples );
+		}
+	}
+}
+
+static void _PlatformADC_StoreScanSample( uint16_t inSample )
+{
+	PlatformADCScan_t *const scan = &mPlatformADCScan;
+	
+	// The first conversion after a MUX change may not have settled; convert the same input again
+	if ( scan->isDiscarding )
+	{
+		scan->isDiscarding = false;
+		ADCSRA |= ( 1 << ADSC );
+		return;
+	}
+	
+	scan->workingFrame[ scan->inputIndex ] = inSample;
+	scan->inputIndex++;
+	
+	// Publish the frame at the end of each scan
+	if ( scan->inputIndex >= scan->numInputs )
+	{
+		for ( uint8_t i = 0; i < scan->numInputs; i++ )
+		{
+			scan->completedFrame[i] = scan->workingFrame[i];
+		}
+		
+		scan->inputIndex = 0;
+		scan->frameCount++;
+		
+		// Never report a frame count of 0 once a frame has completed
+		if ( scan->frameCount == 0 )
+		{
+			scan->frameCount = 1;
+		}
+		
+		if ( !mPlatformADCSampling.isContinuous )
+		{
+			_PlatformADC_StopSampling();
+			mPlatformADCSampling.isComplete = true;
+		}
+		
+		// Callback, if it exists
+		if ( mPlatformADCSampling.completeCb )
+		{
+			mPlatformADCSampling.completeCb( scan->completedFrame, scan->numInputs );
+		}
+		
+		if ( !mPlatformADCSampling.isContinuous )
+		{
+			return;
+		}
+	}
+	
+	// Switch the MUX to the next input, and start its conversion. The MUX can be changed freely while no conversion is running.
+	ADMUX = ( ADMUX & ~PLATFORM_ADC_MUX_PIN_MASK ) | kPlatformADCMuxBits[ scan->inputs[ scan->inputIndex ] ];
+	
+	// Only discard after an actual MUX change
+	if ( scan->numInputs > 1 )
+	{
+		scan->isDiscarding = scan->discardFirstSample;
+	}
+	
+	ADCSRA |= ( 1 << ADSC );
+}
+
+static inline uint16_t _PlatformADC_GetResult( void )
+{
+	uint16_t result;
+	
+	if ( mPlatformADCResolution == PlatformADCResolution_8Bit )
+	{
+		// Left adjusted; ADCH holds the 8 most significant bits
+		result = ADCH;
+	}
+	else
+	{
+		// LSB Register must be read first.
+		result = ADCL;
+		result |= ADCH << 8;
+	}
+	
+	return result;
+}
+
+static uint16_t _PlatformADC_Convert( void )
+{
+	// Start a new conversion
+	ADCSRA |= ( 1 << ADSC );
+	
+	// Wait for conversion complete
+	while( ADCSRA & ( 1 << ADSC ));
+	
+	return _PlatformADC_GetResult();
+}
+
+static void _PlatformADC_Settle( void )
+{
+	for ( uint8_t i = 0; i < PLATFORM_ADC_SETTLE_CONVERSIONS; i++ )
+	{
+		( void )_PlatformADC_Convert();
+	}
+}
+
+static PlatformStatus _PlatformADC_SelectInput( PlatformADC_t inADC )
+{
+	PlatformStatus status = PlatformStatus_NotSupported;
+	
+	// The temperature sensor is only valid against the internal reference
+	require_quiet(( inADC != PlatformADC_Temperature ) || ( mPlatformADCReference == PlatformADCReference_Internal1V1 ), exit );
+	
+	ADMUX = ( ADMUX & ~PLATFORM_ADC_MUX_PIN_MASK ) | kPlatformADCMuxBits[ inADC ];
+	
+	// Let an internal input settle before it is converted
+	if ( PLATFORM_ADC_IS_INTERNAL_INPUT( inADC ))
+	{
+		_PlatformADC_Settle();
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+static void _PlatformADC_LoadTemperatureCalibration( void )
+{
+	if ( !mPlatformADCIsTemperatureCalibrationLoaded )
+	{
+		// Fall back to the typical values if no calibration was ever stored
+		if ( eeprom_read_word( &mPlatformADCTemperatureCalibrationMagicEEPROM ) == PLATFORM_ADC_TEMPERATURE_CALIBRATION_MAGIC )
+		{
+			eeprom_read_block( &mPlatformADCTemperatureCalibration, &mPlatformADCTemperatureCalibrationEEPROM, sizeof( mPlatformADCTemperatureCalibration ));
+		}
+		else
+		{
+			mPlatformADCTemperatureCalibration = kPlatformADCDefaultTemperatureCalibration;
+		}
+		
+		mPlatformADCIsTemperatureCalibrationLoaded = true;
+	}
+}
+
+static uint32_t _PlatformADC_GetMaxTriggeredSampleRateHz( void )
+{
+	uint32_t adcClockHz = F_CPU / _PlatformADC_GetDivisionFactorFromPrescaler( ADCSRA & PLATFORM_ADC_PRESCALER_MASK );
+	
+	return ( adcClockHz * 2 ) / PLATFORM_ADC_TRIGGERED_CONVERSION_HALF_CYCLES;
+}
+
+static PlatformStatus _PlatformADC_StartTimer0Trigger( uint32_t inRequestedSampleRateHz, uint32_t *const outActualSampleRateHz )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint32_t timerCounts = 0;
+	uint8_t  i;
+	
+	// Find the smallest prescaler, for the finest rate resolution, whose rounded period fits in the 8-bit compare register
+	for ( i = 0; i < ( sizeof( kPlatformADCTimer0Prescalers ) / sizeof( uint16_t )); i++ )
+	{
+		uint32_t prescaledClockHz = F_CPU / kPlatformADCTimer0Prescalers[i];
+		
+		timerCounts = ( prescaledClockHz + ( inRequestedSampleRateHz / 2 )) / inRequestedSampleRateHz;
+		
+		if (( timerCounts > 0 ) && ( timerCounts <= PLATFORM_ADC_TIMER0_MAX_COUNTS ))
+		{
+			break;
+		}
+	}
+	require_quiet( i < ( sizeof( kPlatformADCTimer0Prescalers ) / sizeof( uint16_t )), exit );
+	
+	// Disable Powersave on this timer
+	status = PlatformPowerSave_PowerOnPeripheral( PlatformPowerSavePeripheral_Timer0 );
+	require_noerr_quiet( status, exit );
+	
+	// Set CTC mode, with the compare match every timerCounts counts. From ATmega328p datasheet, section 14.7.2
+	TCCR0B = 0;
+	TCCR0A = ( 1 << WGM01 );
+	TCNT0  = 0;
+	OCR0A  = ( uint8_t )( timerCounts - 1 );
+	TCCR0B = kPlatformADCTimer0PrescaleBits[i];
+	
+	*outActualSampleRateHz = F_CPU / kPlatformADCTimer0Prescalers[i] / timerCounts;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+static void _PlatformADC_StopSampling( void )
+{
+	// Stop auto triggering and the conversion complete interrupt
+	ADCSRA &= ~(( 1 << ADATE ) | ( 1 << ADIE ));
+	
+	// Stop the trigger timer, if we own it
+	if (( mPlatformADCSampling.mode == PlatformADCSamplingMode_Triggered ) && ( mPlatformADCSampling.trigger == PlatformADCTrigger_Timer0CompareA ))
+	{
+		TCCR0B = 0;
+		TCCR0A = 0;
+		PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_Timer0 );
+	}
+	
+	// Wait for a conversion that was already started to finish, then discard it
+	while ( ADCSRA & ( 1 << ADSC ));
+	ADCSRA |= ( 1 << ADIF );
+	
+	mPlatformADCSampling.mode = PlatformADCSamplingMode_None;
+}
+
+ISR( ADC_vect )
+{
+	uint16_t sample = _PlatformADC_GetResult();
+	
+	switch ( mPlatformADCSampling.mode )
+	{
+		case PlatformADCSamplingMode_Triggered:
+		{
+			// Clear the trigger source's flag, so the next compare match triggers another conversion
+			*mPlatformADCSampling.triggerFlagReg = mPlatformADCSampling.triggerFlagMask;
+			
+			_PlatformADC_StoreBufferedSample( sample );
+			break;
+		}
+		case PlatformADCSamplingMode_Conversions:
+		{
+			_PlatformADC_StoreBufferedSample( sample );
+			
+			// Start the next conversion, unless the buffer was just filled
+			if ( mPlatformADCSampling.mode == PlatformADCSamplingMode_Conversions )
+			{
+				ADCSRA |= ( 1 << ADSC );
+			}
+			break;
+		}
+		case PlatformADCSamplingMode_NoiseReduction:
+		{
+			_PlatformADC_StoreBufferedSample( sample );
+			break;
+		}
+		case PlatformADCSamplingMode_Scan:
+		{
+			_PlatformADC_StoreScanSample( sample );
+			break;
+		}
+		case PlatformADCSamplingMode_FreeRunning:
+		{
+			PlatformStatus writeStatus;
+			
+			// Push the sample into the ring buffer. If it is full, the sample is dropped.
+			// 8-bit samples are stored as a single byte, so the interrupt keeps up with the faster conversions.
+			if ( mPlatformADCResolution == PlatformADCResolution_8Bit )
+			{
+				writeStatus = PlatformRingBuffer_WriteByte( mPlatformADCSampling.ringBuffer, ( uint8_t )sample );
+			}
+			else
+			{
+				writeStatus = PlatformRingBuffer_WriteBuffer( mPlatformADCSampling.ringBuffer, ( uint8_t* )&sample, sizeof( sample ));
+			}
+			
+			if ( writeStatus != PlatformStatus_Success )
+			{
+				mPlatformADCSampling.numDroppedSamples++;
+			}
+			break;
+		}
+		default:
+		{
+			break;
+		}
 	}
-	return divFactor;
 }
\ No newline at end of file
@@ -10,7 +10,11 @@
 #define PLATFORMADC_H_
 
 #include "PlatformStatus.h"
+#include "PlatformRingBuffer.h"
+#include "PlatformADCOversample.h"
 #include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
 
 typedef enum 
 {
@@ -22,9 +26,55 @@ typedef enum
 	PlatformADC_ADC5,
 	PlatformADC_ADC6,
 	PlatformADC_ADC7,
+	PlatformADC_Temperature, // Internal temperature sensor. Only valid against PlatformADCReference_Internal1V1.
+	PlatformADC_Bandgap,     // Internal 1.1V bandgap
 	PlatformADC_Max,
 } PlatformADC_t;
 
+#define PLATFORM_ADC_SCAN_MAX_INPUTS ( 8 )
+
+// Range of the temperature calibration points, in 0.1C
+#define PLATFORM_ADC_TEMPERATURE_CALIBRATION_MIN_DECI_CELSIUS ( -550 )
+#define PLATFORM_ADC_TEMPERATURE_CALIBRATION_MAX_DECI_CELSIUS ( 1500 )
+
+typedef struct
+{
+	uint16_t counts1;      // 10-bit temperature sensor counts at the first point, without oversampling
+	int16_t  deciCelsius1; // Temperature at the first point, in 0.1C
+	uint16_t counts2;      // 10-bit temperature sensor counts at the second, hotter, point
+	int16_t  deciCelsius2; // Temperature at the second point, in 0.1C
+} PlatformADCTemperatureCalibration_t;
+
+typedef enum
+{
+	PlatformADCReference_AVcc,        // AVcc, with a capacitor on AREF. Default.
+	PlatformADCReference_Internal1V1, // Internal 1.1V bandgap, with a capacitor on AREF
+	PlatformADCReference_External,    // Voltage applied on AREF
+	PlatformADCReference_Max,
+} PlatformADCReference_t;
+
+typedef enum
+{
+	PlatformADCResolution_10Bit, // ADC clock within 50 - 200kHz, for full accuracy. Default.
+	PlatformADCResolution_8Bit,  // ADC clock up to 1MHz, for higher sample rates
+	PlatformADCResolution_Max,
+} PlatformADCResolution_t;
+
+typedef enum
+{
+	PlatformADCTrigger_Timer0CompareA, // Any rate from ~31Hz up to the maximum conversion rate, using Timer0 in CTC mode. Timer0 cannot be used for PWM meanwhile.
+	PlatformADCTrigger_Timer1CompareB, // Fixed 1kHz, locked to the PlatformTimer millisecond tick. PlatformTimer must be initialized.
+	PlatformADCTrigger_Max,
+} PlatformADCTrigger_t;
+
+/*!
+ *\brief    Sampling complete callback; called from the ADC ISR when the sample buffer has been filled, so it should be kept short.
+ *
+ *\param    inSamples    - Sample buffer that was filled.
+ *\param    inNumSamples - Number of samples in the buffer.
+ */
+typedef void ( *PlatformADC_SamplingCompleteCb )( uint16_t *const inSamples, const size_t inNumSamples );
+
 /*!
  *\brief    Initializes the ADC for a specified input. Should be called before calling PlatformADC_Read().
  *
@@ -44,11 +94,294 @@ PlatformStatus PlatformADC_Init( PlatformADC_t inADC );
  *\param    inADC       - ADC input to read.
  *\param    outADCValue - Pointer to store the ADC value read. This value adheres to the formula:
  *                        outADCValue = ( VIn * 1024 ) / VRef 
+ *                        In 8-bit mode 1024 becomes 256, see PlatformADC_SetResolution().
+ *                        With oversampling enabled, it is further shifted left by n, see PlatformADC_SetOversampling().
  *
  *\return   PlatformStatus_Success if successful. PlatformStatus_Failed if anything failed.
  */
 PlatformStatus PlatformADC_Read( PlatformADC_t inADC, uint16_t *const outADCValue );
 
+/*!
+ *\brief    Reads an ADC input with the CPU asleep in ADC Noise Reduction mode, to reduce digital noise on the measurement.
+ *
+ *\details  The conversion is started by entering ADC Noise Reduction sleep mode, and the CPU is woken up by the ADC conversion complete interrupt.
+ *          The I/O clock is halted during the conversion, so Timer0, Timer1, SPI and USART stop while it runs and cannot wake the CPU;
+ *          PlatformTimer time does not advance for the duration of the conversion (about 13 ADC clock cycles, or 25 for the first conversion).
+ *          Do not call this while a peripheral on the I/O clock is transferring data. Global interrupts are enabled on return.
+ *          Other enabled wake-up sources, such as an asynchronous Timer2 or an external interrupt, are serviced and the CPU goes back to sleep.
+ *
+ *\param    inADC       - ADC input to read.
+ *\param    outADCValue - Pointer to store the ADC value.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success        if the conversion completed,
+ *                         - PlatformStatus_NotInitialized if the ADC input is not initialized,
+ *                         - PlatformStatus_Failed         if anything else failed, including if sampling is in progress.
+ */
+PlatformStatus PlatformADC_ReadNoiseReduced( PlatformADC_t inADC, uint16_t *const outADCValue );
+
+/*!
+ *\brief    Starts sampling an ADC input at a fixed rate, with each conversion started by a timer compare match instead of software.
+ *
+ *\details  Conversions are started by hardware, so the sample timing does not depend on the main loop. Each result is stored in 
+ *          outSamples from the ADC ISR. PlatformADC_Read() cannot be used until sampling completes or is stopped.
+ *
+ *\param    inADC                   - ADC input to sample. Must be initialized.
+ *\param    inTrigger               - Timer compare match that starts each conversion.
+ *\param    inRequestedSampleRateHz - Requested sample rate. Ignored for PlatformADCTrigger_Timer1CompareB, which always samples at 1kHz.
+ *\param    outActualSampleRateHz   - Optional pointer to store the closest achievable sample rate that was set. May be NULL.
+ *\param    outSamples              - Buffer to store the samples. Must remain valid until sampling completes or is stopped.
+ *\param    inNumSamples            - Number of samples to store.
+ *\param    inContinuous            - If true, sampling restarts at the beginning of the buffer each time it is filled, until stopped.
+ *\param    inOptionalCompleteCb    - Callback to call each time the buffer is filled. May be NULL.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if sampling was started,
+ *                         - PlatformStatus_NotInitialized  if the ADC input, or PlatformTimer for PlatformADCTrigger_Timer1CompareB, is not initialized,
+ *                         - PlatformStatus_InvalidArgument if the sample rate cannot be achieved,
+ *                         - PlatformStatus_Failed          if anything else failed, including if sampling is already in progress.
+ */
+PlatformStatus PlatformADC_StartTriggeredSampling( PlatformADC_t                  inADC,
+                                                   PlatformADCTrigger_t           inTrigger,
+                                                   uint32_t                       inRequestedSampleRateHz,
+                                                   uint32_t *const                outActualSampleRateHz,
+                                                   uint16_t *const                outSamples,
+                                                   size_t                         inNumSamples,
+                                                   bool                           inContinuous,
+                                                   PlatformADC_SamplingCompleteCb inOptionalCompleteCb );
+
+/*!
+ *\brief    Starts converting an ADC input into a buffer in the background, and returns without waiting for the conversions.
+ *
+ *\details  The ADC ISR stores each result and immediately starts the next conversion, until the buffer is filled.
+ *          Completion is signalled through the callback, or polled with PlatformADC_GetSamplingProgress().
+ *          PlatformADC_Read() cannot be used until the conversions complete or are stopped.
+ *
+ *\param    inADC                - ADC input to convert. Must be initialized.
+ *\param    outSamples           - Buffer to store the results. Must remain valid until the conversions complete or are stopped.
+ *\param    inNumSamples         - Number of conversions.
+ *\param    inOptionalCompleteCb - Callback to call when the buffer is filled. May be NULL.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success        if the conversions were started,
+ *                         - PlatformStatus_NotInitialized if the ADC input is not initialized,
+ *                         - PlatformStatus_Failed         if anything else failed, including if sampling is already in progress.
+ */
+PlatformStatus PlatformADC_StartConversions( PlatformADC_t                  inADC,
+                                            uint16_t *const                outSamples,
+                                            size_t                         inNumSamples,
+                                            PlatformADC_SamplingCompleteCb inOptionalCompleteCb );
+
+/*!
+ *\brief    Starts streaming continuous samples from an ADC input into a ring buffer, using the ADC free running mode.
+ *
+ *\details  Samples are taken back to back at the maximum conversion rate (13 ADC clock cycles each) until PlatformADC_StopSampling() is called.
+ *          Each sample takes two bytes of the ring buffer, or one byte in 8-bit mode. Samples that arrive while the ring buffer is full are dropped and counted.
+ *
+ *\param    inADC        - ADC input to sample. Must be initialized.
+ *\param    inRingBuffer - Ring buffer to store the samples.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success        if streaming was started,
+ *                         - PlatformStatus_NotInitialized if the ADC input is not initialized,
+ *                         - PlatformStatus_Failed         if anything else failed, including if sampling is already in progress.
+ */
+PlatformStatus PlatformADC_StartFreeRunning( PlatformADC_t inADC, PlatformRingBuffer *const inRingBuffer );
+
+/*!
+ *\brief    Reads samples streamed by PlatformADC_StartFreeRunning() from its ring buffer.
+ *
+ *\param    outSamples            - Buffer to store the samples. Must be at least of length inNumSamples.
+ *\param    inNumSamples          - Number of samples to read.
+ *\param    outOptionalNumDropped - Optional pointer to store the number of samples dropped since the last read. May be NULL.
+ *
+ *\return   PlatformStatus_Success if read successfully. PlatformStatus_Failed if fewer samples are available, or anything else failed.
+ */
+PlatformStatus PlatformADC_ReadStreamedSamples( uint16_t *const outSamples, size_t inNumSamples, uint16_t *const outOptionalNumDropped );
+
+/*!
+ *\brief    Selects the voltage reference for all ADC inputs.
+ *
+ *\details  A few conversions are discarded after a change, to let the reference settle. 
+ *          Only select PlatformADCReference_External if a voltage is applied on AREF, and never select another reference while it is;
+ *          the internal references would be shorted to it. The reference is reset to AVcc when the ADC is initialized again after the last input was deinitialized.
+ *
+ *\param    inReference                   - Reference to use.
+ *\param    inExternalReferenceMillivolts - Voltage applied on AREF, for PlatformADC_CountsToMillivolts(). Ignored unless inReference is External.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if successful,
+ *                         - PlatformStatus_NotInitialized  if no ADC input is initialized,
+ *                         - PlatformStatus_InvalidArgument if an argument is invalid,
+ *                         - PlatformStatus_Failed          if sampling is in progress.
+ */
+PlatformStatus PlatformADC_SetReference( PlatformADCReference_t inReference, uint16_t inExternalReferenceMillivolts );
+
+/*!
+ *\brief    Measures Vcc by converting the internal 1.1V bandgap against AVcc, and caches it for PlatformADC_CountsToMillivolts().
+ *
+ *\details  Call this periodically, e.g. as a battery discharges, to keep AVcc referenced conversions accurate. 
+ *          The reference is temporarily switched to AVcc, so this takes a few conversions to settle, about 1 - 2ms.
+ *          The accuracy is that of the bandgap, which varies between devices; see PlatformADC_SetBandgapMillivolts().
+ *
+ *\param    outOptionalVccMillivolts - Optional pointer to store Vcc in millivolts. May be NULL.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success        if successful,
+ *                         - PlatformStatus_NotInitialized if no ADC input is initialized,
+ *                         - PlatformStatus_NotSupported   if the external reference is selected,
+ *                         - PlatformStatus_Failed         if sampling is in progress, or anything else failed.
+ */
+PlatformStatus PlatformADC_MeasureVcc( uint16_t *const outOptionalVccMillivolts );
+
+/*!
+ *\brief    Sets the calibrated voltage of this device's bandgap, used for the internal reference and to measure Vcc. Defaults to 1100mV.
+ *
+ *\details  The bandgap can be found once per device by measuring Vcc with a meter and scaling: VBandgap = 1100 * VccMeter / VccMeasured.
+ *          Clears the cached Vcc, so PlatformADC_MeasureVcc() must be called again.
+ *
+ *\param    inBandgapMillivolts - Bandgap voltage in millivolts.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if inBandgapMillivolts is 0.
+ */
+PlatformStatus PlatformADC_SetBandgapMillivolts( uint16_t inBandgapMillivolts );
+
+/*!
+ *\brief    Converts a result from an ADC input to millivolts using integer math only, for the selected reference, resolution and the input's oversampling.
+ *
+ *\param    inADC         - ADC input that the result came from.
+ *\param    inCounts      - Result to convert.
+ *\param    outMillivolts - Pointer to store the voltage in millivolts.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if successful,
+ *                         - PlatformStatus_NotInitialized  if the reference is AVcc and PlatformADC_MeasureVcc() has not succeeded,
+ *                         - PlatformStatus_InvalidArgument if an argument is invalid.
+ */
+PlatformStatus PlatformADC_CountsToMillivolts( PlatformADC_t inADC, uint16_t inCounts, uint16_t *const outMillivolts );
+
+/*!
+ *\brief    Reads the internal temperature sensor, and converts it to a temperature with the two-point calibration.
+ *
+ *\details  PlatformADC_Init( PlatformADC_Temperature ) must have been called. If the reference is AVcc, it is switched to the internal 1.1V reference
+ *          for the reading and back afterwards, which takes a few milliseconds of settling. The input's oversampling is applied.
+ *          Uncalibrated devices use the typical sensor output from the datasheet, which can be off by several degrees.
+ *
+ *\param    outDeciCelsius - Pointer to store the temperature, in 0.1C.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if successful,
+ *                         - PlatformStatus_NotInitialized  if the temperature sensor input is not initialized,
+ *                         - PlatformStatus_NotSupported    if the resolution is 8-bit, or the external reference is selected,
+ *                         - PlatformStatus_InvalidArgument if outDeciCelsius is NULL,
+ *                         - PlatformStatus_Failed          if sampling is in progress, or anything else failed.
+ */
+PlatformStatus PlatformADC_ReadTemperature( int16_t *const outDeciCelsius );
+
+/*!
+ *\brief    Sets this device's temperature sensor calibration, and stores it in EEPROM so it survives a reset.
+ *
+ *\details  To calibrate, read PlatformADC_Temperature with PlatformADC_Read() against the internal reference at two known temperatures, 
+ *          with 10-bit resolution and no oversampling, as far apart as possible.
+ *
+ *\param    inCalibration - Calibration points. counts2 and deciCelsius2 must be greater than counts1 and deciCelsius1, and the temperatures within
+ *                          PLATFORM_ADC_TEMPERATURE_CALIBRATION_MIN_DECI_CELSIUS and PLATFORM_ADC_TEMPERATURE_CALIBRATION_MAX_DECI_CELSIUS.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the calibration is invalid.
+ */
+PlatformStatus PlatformADC_SetTemperatureCalibration( const PlatformADCTemperatureCalibration_t *const inCalibration );
+
+/*!
+ *\brief    Gets the temperature sensor calibration in use; the one stored in EEPROM, or the typical values if none was stored.
+ *
+ *\param    outCalibration - Pointer to store the calibration.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if outCalibration is NULL.
+ */
+PlatformStatus PlatformADC_GetTemperatureCalibration( PlatformADCTemperatureCalibration_t *const outCalibration );
+
+/*!
+ *\brief    Sets the resolution of all ADC results, trading accuracy for sample rate.
+ *
+ *\details  8-bit mode left adjusts the result and reads only ADCH, and raises the ADC clock to at most 1MHz (a prescaler of 8 at 8MHz),
+ *          for 8 times the 10-bit sample rate: one conversion takes 13 ADC clock cycles, about 77k samples per second free running.
+ *          That leaves the ADC interrupt about 100 CPU cycles to store each sample, so while free running, any other interrupt that runs
+ *          longer than that delays it past the next conversion, and the overwritten result is lost without being counted as dropped.
+ *          Results are 0 - 255, plus any oversampling bits. Outside 50 - 200kHz the ADC is not specified for 10-bit accuracy;
+ *          at 1MHz expect the lower 2 bits to be lost to noise and nonlinearity, leaving about 8 usable bits.
+ *          The sample and hold capacitor also has less time to charge, so drive the input from a low impedance source.
+ *          The resolution applies to every input, and is reset to 10 bits when the ADC is initialized again after the last input was deinitialized.
+ *
+ *\param    inResolution - Resolution to use.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if successful,
+ *                         - PlatformStatus_NotInitialized  if no ADC input is initialized,
+ *                         - PlatformStatus_InvalidArgument if the resolution is invalid,
+ *                         - PlatformStatus_Failed          if sampling is in progress, or no prescaler fits.
+ */
+PlatformStatus PlatformADC_SetResolution( PlatformADCResolution_t inResolution );
+
+/*!
+ *\brief    Sets the oversampling of an ADC input, to increase the resolution of its results beyond 10 bits.
+ *
+ *\details  Each result from PlatformADC_Read(), PlatformADC_ReadNoiseReduced(), PlatformADC_StartTriggeredSampling() and PlatformADC_StartConversions()
+ *          is then decimated from 4^n conversions, accumulated as integers in the ADC ISR (or in the polling loop for PlatformADC_Read()),
+ *          and has 10 + n bits. The result rate drops by the same factor of 4^n. This only gains resolution if the input has at least 1 LSB of noise on it.
+ *          Free running and scan sampling always return raw samples. The setting is reset to 0 when the input is deinitialized.
+ *
+ *\param    inADC       - ADC input to configure.
+ *\param    inExtraBits - Extra bits of resolution, n, from 0 (off) to PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if successful,
+ *                         - PlatformStatus_NotInitialized  if the ADC input is not initialized,
+ *                         - PlatformStatus_InvalidArgument if an argument is out of range,
+ *                         - PlatformStatus_Failed          if sampling is in progress.
+ */
+PlatformStatus PlatformADC_SetOversampling( PlatformADC_t inADC, uint8_t inExtraBits );
+
+/*!
+ *\brief    Starts scanning a list of ADC inputs in the background, producing one frame of samples per scan.
+ *
+ *\details  The ADC ISR switches the MUX to the next input and starts its conversion as soon as the previous conversion completes,
+ *          so a frame is converted at the maximum conversion rate. The latest complete frame is read with PlatformADC_GetScanFrame().
+ *          PlatformADC_Read() cannot be used until the scan completes or is stopped.
+ *
+ *\param    inInputs                  - List of ADC inputs to scan, in order. Each must be initialized. An input may appear more than once.
+ *\param    inNumInputs               - Number of inputs in the list, up to PLATFORM_ADC_SCAN_MAX_INPUTS.
+ *\param    inDiscardFirstSample      - If true, the first conversion after each MUX change is discarded, for sources that need time to settle.
+ *                                      This halves the frame rate. Recommended when scanning the internal inputs.
+ *\param    inContinuous              - If true, scanning restarts after each frame until stopped. Otherwise a single frame is scanned.
+ *\param    inOptionalFrameCompleteCb - Callback to call with each complete frame, from the ADC ISR. May be NULL.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success        if the scan was started,
+ *                         - PlatformStatus_NotInitialized if an ADC input is not initialized,
+ *                         - PlatformStatus_Failed         if anything else failed, including if sampling is already in progress.
+ */
+PlatformStatus PlatformADC_StartScan( const PlatformADC_t *const     inInputs,
+                                     uint8_t                        inNumInputs,
+                                     bool                           inDiscardFirstSample,
+                                     bool                           inContinuous,
+                                     PlatformADC_SamplingCompleteCb inOptionalFrameCompleteCb );
+
+/*!
+ *\brief    Copies the latest complete scan frame. All samples in the frame come from the same scan.
+ *
+ *\param    outFrame              - Buffer to store the frame, one sample per input in scan list order. Must be at least of length inNumInputs.
+ *\param    outOptionalFrameCount - Optional pointer to store a count that increments with each new frame, to detect new or missed frames. May be NULL.
+ *
+ *\return   PlatformStatus_Success if a frame was copied. PlatformStatus_Failed if no frame has completed yet, or anything else failed.
+ */
+PlatformStatus PlatformADC_GetScanFrame( uint16_t *const outFrame, uint8_t *const outOptionalFrameCount );
+
+/*!
+ *\brief    Gets the progress of the current or last sampling.
+ *
+ *\param    outNumSamples - Optional pointer to store the number of samples stored in the buffer so far. May be NULL.
+ *\param    outIsComplete - Optional pointer to store whether sampling has completed (always false while continuous sampling is running). May be NULL.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_Failed if anything failed.
+ */
+PlatformStatus PlatformADC_GetSamplingProgress( size_t *const outNumSamples, bool *const outIsComplete );
+
+/*!
+ *\brief    Stops sampling, if in progress. The samples stored so far remain in the buffer.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_Failed if anything failed.
+ */
+PlatformStatus PlatformADC_StopSampling( void );
+
 /*!
  *\brief    Deinitializes the ADC for a specified input.
  *
@@ -0,0 +1,55 @@
+/*
+ * PlatformADCOversample.c
+ *
+ * Created: 2026-10-18 2:15:02 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformADCOversample.h"
+#include "require_macros.h"
+#include <stddef.h>
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformADCOversample_Init( PlatformADCOversampler_t *const inOversampler, const uint8_t inExtraBits )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inOversampler,                                         exit );
+	require_quiet( inExtraBits <= PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS, exit );
+	
+	inOversampler->accumulator    = 0;
+	inOversampler->numAccumulated = 0;
+	inOversampler->extraBits      = inExtraBits;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+bool PlatformADCOversample_AddSample( PlatformADCOversampler_t *const inOversampler, const uint16_t inSample, uint16_t *const outResult )
+{
+	bool isResultReady = false;
+	
+	inOversampler->accumulator += inSample;
+	inOversampler->numAccumulated++;
+	
+	// 4^n samples are needed, i.e. 1 << ( 2 * n )
+	if ( inOversampler->numAccumulated >= PlatformADCOversample_GetNumSamplesPerResult( inOversampler->extraBits ))
+	{
+		*outResult = ( uint16_t )( inOversampler->accumulator >> inOversampler->extraBits );
+		
+		inOversampler->accumulator    = 0;
+		inOversampler->numAccumulated = 0;
+		isResultReady = true;
+	}
+	
+	return isResultReady;
+}
+
+uint16_t PlatformADCOversample_GetNumSamplesPerResult( const uint8_t inExtraBits )
+{
+	return ( uint16_t )( 1 << ( 2 * inExtraBits ));
+}
\ No newline at end of file
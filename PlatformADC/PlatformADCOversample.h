@@ -0,0 +1,62 @@
+/*
+ * PlatformADCOversample.h
+ *
+ * Oversampling and decimation arithmetic for PlatformADC. 
+ * This has no hardware dependencies, so it can also be compiled and exercised on a host machine.
+ *
+ * Created: 2026-10-18 2:14:37 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMADCOVERSAMPLE_H_
+#define PLATFORMADCOVERSAMPLE_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Each extra bit of resolution needs 4 times as many samples. 6 extra bits (4096 samples) gives a 16-bit result from the 10-bit ADC.
+#define PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS ( 6 )
+
+typedef struct
+{
+	uint32_t accumulator;
+	uint16_t numAccumulated;
+	uint8_t  extraBits;
+} PlatformADCOversampler_t;
+
+/*!
+ *\brief    Initializes an oversampler, clearing any accumulated samples.
+ *
+ *\param    inOversampler - Oversampler to initialize.
+ *\param    inExtraBits   - Extra bits of resolution, n. Each result is decimated from 4^n samples. 0 passes samples through unchanged.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if inExtraBits is above PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS.
+ */
+PlatformStatus PlatformADCOversample_Init( PlatformADCOversampler_t *const inOversampler, const uint8_t inExtraBits );
+
+/*!
+ *\brief    Accumulates a sample, and produces a decimated result once 4^n samples have been accumulated.
+ *
+ *\details  The result is the sum of the samples shifted right by n, so it has n more bits than the input samples. 
+ *          This only gains resolution if the input has at least 1 LSB of noise on it. The accumulator is cleared after each result.
+ *
+ *\param    inOversampler - Oversampler to add the sample to.
+ *\param    inSample      - Sample to add.
+ *\param    outResult     - Pointer to store the decimated result. Only written when this function returns true.
+ *
+ *\return   true if a result was produced.
+ */
+bool PlatformADCOversample_AddSample( PlatformADCOversampler_t *const inOversampler, const uint16_t inSample, uint16_t *const outResult );
+
+/*!
+ *\brief    Gets the number of samples needed for each decimated result.
+ *
+ *\param    inExtraBits - Extra bits of resolution, n.
+ *
+ *\return   4^n.
+ */
+uint16_t PlatformADCOversample_GetNumSamplesPerResult( const uint8_t inExtraBits );
+
+#endif /* PLATFORMADCOVERSAMPLE_H_ */
\ No newline at end of file
@@ -0,0 +1,148 @@
+/*
+ * PlatformDeferredWork.c
+ *
+ * Created: 2026-10-18 11:47:52 AM
+ *  Author: Felix
+ */ 
+
+#include "PlatformDeferredWork.h"
+#include "PlatformInterrupt.h"
+#include "require_macros.h"
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_DEFERRED_WORK_INDEX_MASK ( PLATFORM_DEFERRED_WORK_QUEUE_SIZE - 1 )
+#define PLATFORM_DEFERRED_WORK_MAX_COUNT  ( 0xFF )
+
+#if ( PLATFORM_DEFERRED_WORK_QUEUE_SIZE & PLATFORM_DEFERRED_WORK_INDEX_MASK ) || ( PLATFORM_DEFERRED_WORK_QUEUE_SIZE > 128 )
+#error PLATFORM_DEFERRED_WORK_QUEUE_SIZE must be a power of two, no larger than 128.
+#endif
+
+//================//
+//    Typedefs    //
+//================//
+
+typedef struct
+{
+	PlatformDeferredWork_Cb workCb;
+	uint16_t                arg;
+} PlatformDeferredWorkItem_t;
+
+//==================================//
+//    Static Structs & Variables    //
+//==================================//
+
+// The head index is only written by producers (ISRs, or the main context with interrupts disabled), and the tail index only by the consumer.
+// Both are single bytes, so they are read and written atomically. The indexes run freely and are masked when accessing the queue.
+static volatile PlatformDeferredWorkItem_t mPlatformDeferredWorkQueue[ PLATFORM_DEFERRED_WORK_QUEUE_SIZE ];
+static volatile uint8_t                    mPlatformDeferredWorkHead;
+static volatile uint8_t                    mPlatformDeferredWorkTail;
+static volatile uint8_t                    mPlatformDeferredWorkDroppedCount;
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformDeferredWork_PostFromISR( PlatformDeferredWork_Cb inWorkCb, const uint16_t inArg )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	uint8_t head = mPlatformDeferredWorkHead;
+	
+	require_action_quiet( inWorkCb, exit, status = PlatformStatus_InvalidArgument );
+	
+	// Check there is room in the queue
+	if (( uint8_t )( head - mPlatformDeferredWorkTail ) >= PLATFORM_DEFERRED_WORK_QUEUE_SIZE )
+	{
+		if ( mPlatformDeferredWorkDroppedCount < PLATFORM_DEFERRED_WORK_MAX_COUNT )
+		{
+			mPlatformDeferredWorkDroppedCount++;
+		}
+		goto exit;
+	}
+	
+	// Fill in the item before publishing it by advancing the head
+	mPlatformDeferredWorkQueue[ head & PLATFORM_DEFERRED_WORK_INDEX_MASK ].workCb = inWorkCb;
+	mPlatformDeferredWorkQueue[ head & PLATFORM_DEFERRED_WORK_INDEX_MASK ].arg    = inArg;
+	mPlatformDeferredWorkHead = head + 1;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformDeferredWork_Post( PlatformDeferredWork_Cb inWorkCb, const uint16_t inArg )
+{
+	PlatformStatus status;
+	bool didDisableInterrupts = false;
+	
+	// Disable Global Interrupts, if enabled, so an ISR cannot post in between
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	status = PlatformDeferredWork_PostFromISR( inWorkCb, inArg );
+	
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+bool PlatformDeferredWork_IsPending( void )
+{
+	return ( mPlatformDeferredWorkHead != mPlatformDeferredWorkTail ) ? true : false;
+}
+
+uint8_t PlatformDeferredWork_ProcessAll( void )
+{
+	uint8_t numProcessed = 0;
+	uint8_t tail         = mPlatformDeferredWorkTail;
+	
+	while ( tail != mPlatformDeferredWorkHead )
+	{
+		// Copy the item out, then release its slot before running it so the slot can be reused right away
+		PlatformDeferredWork_Cb workCb = mPlatformDeferredWorkQueue[ tail & PLATFORM_DEFERRED_WORK_INDEX_MASK ].workCb;
+		uint16_t                arg    = mPlatformDeferredWorkQueue[ tail & PLATFORM_DEFERRED_WORK_INDEX_MASK ].arg;
+		
+		tail++;
+		mPlatformDeferredWorkTail = tail;
+		
+		workCb( arg );
+		
+		if ( numProcessed < PLATFORM_DEFERRED_WORK_MAX_COUNT )
+		{
+			numProcessed++;
+		}
+	}
+	
+	return numProcessed;
+}
+
+uint8_t PlatformDeferredWork_GetAndClearDroppedCount( void )
+{
+	bool didDisableInterrupts = false;
+	uint8_t droppedCount;
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	droppedCount = mPlatformDeferredWorkDroppedCount;
+	mPlatformDeferredWorkDroppedCount = 0;
+	
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return droppedCount;
+}
\ No newline at end of file
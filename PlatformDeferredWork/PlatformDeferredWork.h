@@ -0,0 +1,69 @@
+/*
+ * PlatformDeferredWork.h
+ *
+ * A fixed-size queue of deferred work items, for moving work out of ISRs ("bottom halves").
+ * An ISR posts a function and a small argument in constant time, and the main context runs the items later with interrupts enabled.
+ * Posting and processing do not need to disable interrupts for each other, since only one side writes each queue index.
+ * PlatformScheduler_Run() processes the queue before running any task.
+ *
+ * Created: 2026-10-18 11:48:09 AM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMDEFERREDWORK_H_
+#define PLATFORMDEFERREDWORK_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Must be a power of two, no larger than 128
+#define PLATFORM_DEFERRED_WORK_QUEUE_SIZE ( 16 )
+
+typedef void ( *PlatformDeferredWork_Cb )( const uint16_t inArg );
+
+/*!
+ *\brief    Posts a work item from an ISR. Must be called with global interrupts disabled.
+ *
+ *\param    inWorkCb - Function to run from the main context.
+ *\param    inArg    - Argument to pass to the function.
+ *
+ *\return   PlatformStatus_Success if posted. PlatformStatus_Failed if the queue is full, in which case the item is counted as dropped.
+ */
+PlatformStatus PlatformDeferredWork_PostFromISR( PlatformDeferredWork_Cb inWorkCb, const uint16_t inArg );
+
+/*!
+ *\brief    Posts a work item from the main context.
+ *
+ *\param    inWorkCb - Function to run.
+ *\param    inArg    - Argument to pass to the function.
+ *
+ *\return   PlatformStatus_Success if posted. PlatformStatus_Failed if the queue is full, in which case the item is counted as dropped.
+ */
+PlatformStatus PlatformDeferredWork_Post( PlatformDeferredWork_Cb inWorkCb, const uint16_t inArg );
+
+/*!
+ *\brief    Checks whether any work items are waiting to be processed.
+ *
+ *\return   true if at least one work item is queued.
+ */
+bool PlatformDeferredWork_IsPending( void );
+
+/*!
+ *\brief    Runs every queued work item in the order they were posted. Must only be called from the main context.
+ *
+ *\details  Items posted while processing are also run before this function returns.
+ *
+ *\return   Number of work items run, saturated at 255.
+ */
+uint8_t PlatformDeferredWork_ProcessAll( void );
+
+/*!
+ *\brief    Gets the number of work items dropped because the queue was full, and resets the count.
+ *
+ *\return   Number of dropped work items, saturated at 255.
+ */
+uint8_t PlatformDeferredWork_GetAndClearDroppedCount( void );
+
+#endif /* PLATFORMDEFERREDWORK_H_ */
\ No newline at end of file
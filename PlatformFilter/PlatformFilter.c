@@ -0,0 +1,387 @@
+/*
+ * PlatformFilter.c
+ *
+ * Created: 2026-10-18 3:03:19 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformFilter.h"
+#include "require_macros.h"
+#include <stddef.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_FILTER_Q15_SHIFT       ( 15 )
+#define PLATFORM_FILTER_Q15_TO_Q7_SHIFT ( 8 )
+
+#define PLATFORM_FILTER_MEDIAN_MIN_WINDOW ( 3 )
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static inline int32_t _PlatformFilter_RoundingShift( const int32_t inValue, const uint8_t inShift );
+static inline int16_t _PlatformFilter_Saturate( const int32_t inValue );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformFilter_InitMovingAverageQ15( PlatformFilterMovingAverageQ15_t *const inFilter, int16_t *const inHistory, const uint8_t inWindowLog2 )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inFilter,                                                 exit );
+	require_quiet( inHistory,                                                exit );
+	require_quiet( inWindowLog2 <= PLATFORM_FILTER_MOVING_AVERAGE_MAX_LOG2, exit );
+	
+	inFilter->history    = inHistory;
+	inFilter->sum        = 0;
+	inFilter->windowLog2 = inWindowLog2;
+	inFilter->index      = 0;
+	inFilter->isFull     = false;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+bool PlatformFilter_ProcessMovingAverageQ15( PlatformFilterMovingAverageQ15_t *const inFilter, const int16_t inSample, int16_t *const outSample )
+{
+	const uint8_t windowSize = ( uint8_t )( 1 << inFilter->windowLog2 );
+	
+	// Replace the oldest sample in the running sum
+	if ( inFilter->isFull )
+	{
+		inFilter->sum -= inFilter->history[ inFilter->index ];
+	}
+	inFilter->sum += inSample;
+	inFilter->history[ inFilter->index ] = inSample;
+	
+	inFilter->index++;
+	if ( inFilter->index >= windowSize )
+	{
+		inFilter->index  = 0;
+		inFilter->isFull = true;
+	}
+	
+	if ( inFilter->isFull )
+	{
+		*outSample = ( int16_t )_PlatformFilter_RoundingShift( inFilter->sum, inFilter->windowLog2 );
+	}
+	else
+	{
+		// Still filling the window; the index is the number of samples so far
+		*outSample = ( int16_t )( inFilter->sum / inFilter->index );
+	}
+	
+	return true;
+}
+
+PlatformStatus PlatformFilter_InitMovingAverageQ7( PlatformFilterMovingAverageQ7_t *const inFilter, int8_t *const inHistory, const uint8_t inWindowLog2 )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inFilter,                                                 exit );
+	require_quiet( inHistory,                                                exit );
+	require_quiet( inWindowLog2 <= PLATFORM_FILTER_MOVING_AVERAGE_MAX_LOG2, exit );
+	
+	inFilter->history    = inHistory;
+	inFilter->sum        = 0;
+	inFilter->windowLog2 = inWindowLog2;
+	inFilter->index      = 0;
+	inFilter->isFull     = false;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+bool PlatformFilter_ProcessMovingAverageQ7( PlatformFilterMovingAverageQ7_t *const inFilter, const int8_t inSample, int8_t *const outSample )
+{
+	const uint8_t windowSize = ( uint8_t )( 1 << inFilter->windowLog2 );
+	
+	// Replace the oldest sample in the running sum. 128 samples of 8 bits fit in the 16-bit sum.
+	if ( inFilter->isFull )
+	{
+		inFilter->sum -= inFilter->history[ inFilter->index ];
+	}
+	inFilter->sum += inSample;
+	inFilter->history[ inFilter->index ] = inSample;
+	
+	inFilter->index++;
+	if ( inFilter->index >= windowSize )
+	{
+		inFilter->index  = 0;
+		inFilter->isFull = true;
+	}
+	
+	if ( inFilter->isFull )
+	{
+		*outSample = ( int8_t )_PlatformFilter_RoundingShift( inFilter->sum, inFilter->windowLog2 );
+	}
+	else
+	{
+		// Still filling the window; the index is the number of samples so far
+		*outSample = ( int8_t )( inFilter->sum / inFilter->index );
+	}
+	
+	return true;
+}
+
+PlatformStatus PlatformFilter_InitIIR( PlatformFilterIIR_t *const inFilter, const uint8_t inShift )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inFilter,                                                      exit );
+	require_quiet(( inShift > 0 ) && ( inShift <= PLATFORM_FILTER_IIR_MAX_SHIFT ), exit );
+	
+	inFilter->state    = 0;
+	inFilter->shift    = inShift;
+	inFilter->isPrimed = false;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+bool PlatformFilter_ProcessIIR( PlatformFilterIIR_t *const inFilter, const int16_t inSample, int16_t *const outSample )
+{
+	if ( inFilter->isPrimed )
+	{
+		// state = y * 2^shift, so state += x - y is y += ( x - y ) / 2^shift
+		inFilter->state += inSample - ( inFilter->state >> inFilter->shift );
+	}
+	else
+	{
+		// Start from the first sample
+		inFilter->state    = ( int32_t )inSample << inFilter->shift;
+		inFilter->isPrimed = true;
+	}
+	
+	*outSample = _PlatformFilter_Saturate( _PlatformFilter_RoundingShift( inFilter->state, inFilter->shift ));
+	
+	return true;
+}
+
+PlatformStatus PlatformFilter_InitMedian( PlatformFilterMedian_t *const inFilter, const uint8_t inWindowSize )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inFilter,                                          exit );
+	require_quiet( inWindowSize >= PLATFORM_FILTER_MEDIAN_MIN_WINDOW, exit );
+	require_quiet( inWindowSize <= PLATFORM_FILTER_MEDIAN_MAX_WINDOW, exit );
+	require_quiet( inWindowSize & 1,                                  exit );
+	
+	inFilter->windowSize = inWindowSize;
+	inFilter->index      = 0;
+	inFilter->numSamples = 0;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+bool PlatformFilter_ProcessMedian( PlatformFilterMedian_t *const inFilter, const int16_t inSample, int16_t *const outSample )
+{
+	int16_t sorted[ PLATFORM_FILTER_MEDIAN_MAX_WINDOW ];
+	
+	inFilter->history[ inFilter->index ] = inSample;
+	
+	inFilter->index++;
+	if ( inFilter->index >= inFilter->windowSize )
+	{
+		inFilter->index = 0;
+	}
+	
+	if ( inFilter->numSamples < inFilter->windowSize )
+	{
+		inFilter->numSamples++;
+	}
+	
+	// Insertion sort a copy of the window; the window is small, so this beats anything cleverer
+	for ( uint8_t i = 0; i < inFilter->numSamples; i++ )
+	{
+		int16_t value = inFilter->history[i];
+		uint8_t j     = i;
+		
+		while (( j > 0 ) && ( sorted[ j - 1 ] > value ))
+		{
+			sorted[j] = sorted[ j - 1 ];
+			j--;
+		}
+		sorted[j] = value;
+	}
+	
+	*outSample = sorted[ inFilter->numSamples / 2 ];
+	
+	return true;
+}
+
+PlatformStatus PlatformFilter_InitFIR( PlatformFilterFIR_t *const inFilter,
+                                       const int16_t *const       inCoefficients,
+                                       int16_t *const             inHistory,
+                                       const uint8_t              inNumTaps,
+                                       const uint8_t              inDecimation )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inFilter,       exit );
+	require_quiet( inCoefficients, exit );
+	require_quiet( inHistory,      exit );
+	require_quiet( inNumTaps,      exit );
+	require_quiet( inDecimation,   exit );
+	
+	for ( uint8_t i = 0; i < inNumTaps; i++ )
+	{
+		inHistory[i] = 0;
+	}
+	
+	inFilter->coefficients    = inCoefficients;
+	inFilter->history         = inHistory;
+	inFilter->numTaps         = inNumTaps;
+	inFilter->index           = 0;
+	inFilter->decimation      = inDecimation;
+	inFilter->decimationCount = 0;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+bool PlatformFilter_ProcessFIR( PlatformFilterFIR_t *const inFilter, const int16_t inSample, int16_t *const outSample )
+{
+	bool    isOutputReady = false;
+	uint8_t historyIndex;
+	int32_t accumulator;
+	
+	// The newest sample is at index
+	inFilter->history[ inFilter->index ] = inSample;
+	historyIndex = inFilter->index;
+	
+	inFilter->index++;
+	if ( inFilter->index >= inFilter->numTaps )
+	{
+		inFilter->index = 0;
+	}
+	
+	// Only compute the outputs that are kept
+	inFilter->decimationCount++;
+	if ( inFilter->decimationCount >= inFilter->decimation )
+	{
+		inFilter->decimationCount = 0;
+		
+		// y[n] = sum( c[k] * x[n - k] ), walking back through the history from the newest sample
+		accumulator = 0;
+		for ( uint8_t k = 0; k < inFilter->numTaps; k++ )
+		{
+			accumulator += ( int32_t )inFilter->coefficients[k] * inFilter->history[ historyIndex ];
+			
+			historyIndex = ( historyIndex == 0 ) ? ( inFilter->numTaps - 1 ) : ( historyIndex - 1 );
+		}
+		
+		*outSample = _PlatformFilter_Saturate( _PlatformFilter_RoundingShift( accumulator, PLATFORM_FILTER_Q15_SHIFT ));
+		isOutputReady = true;
+	}
+	
+	return isOutputReady;
+}
+
+bool PlatformFilter_ProcessChain( const PlatformFilterStage_t *const inStages, const uint8_t inNumStages, const int16_t inSample, int16_t *const outSample )
+{
+	bool    isOutputReady = true;
+	int16_t sample        = inSample;
+	
+	for ( uint8_t i = 0; ( i < inNumStages ) && isOutputReady; i++ )
+	{
+		switch ( inStages[i].type )
+		{
+			case PlatformFilterType_MovingAverageQ15:
+			{
+				isOutputReady = PlatformFilter_ProcessMovingAverageQ15( inStages[i].filter, sample, &sample );
+				break;
+			}
+			case PlatformFilterType_MovingAverageQ7:
+			{
+				int32_t sampleQ7 = _PlatformFilter_RoundingShift( sample, PLATFORM_FILTER_Q15_TO_Q7_SHIFT );
+				int8_t  averageQ7;
+				
+				// Rounding up can carry the largest samples past the Q7 range
+				if ( sampleQ7 > INT8_MAX )
+				{
+					sampleQ7 = INT8_MAX;
+				}
+				
+				isOutputReady = PlatformFilter_ProcessMovingAverageQ7( inStages[i].filter, ( int8_t )sampleQ7, &averageQ7 );
+				sample = ( int16_t )( averageQ7 * ( 1 << PLATFORM_FILTER_Q15_TO_Q7_SHIFT ));
+				break;
+			}
+			case PlatformFilterType_IIR:
+			{
+				isOutputReady = PlatformFilter_ProcessIIR( inStages[i].filter, sample, &sample );
+				break;
+			}
+			case PlatformFilterType_Median:
+			{
+				isOutputReady = PlatformFilter_ProcessMedian( inStages[i].filter, sample, &sample );
+				break;
+			}
+			case PlatformFilterType_FIR:
+			{
+				isOutputReady = PlatformFilter_ProcessFIR( inStages[i].filter, sample, &sample );
+				break;
+			}
+			default:
+			{
+				isOutputReady = false;
+				break;
+			}
+		}
+	}
+	
+	if ( isOutputReady )
+	{
+		*outSample = sample;
+	}
+	
+	return isOutputReady;
+}
+
+//==================================//
+//   Static Function Definitions    //
+//==================================//
+
+static inline int32_t _PlatformFilter_RoundingShift( const int32_t inValue, const uint8_t inShift )
+{
+	int32_t result = inValue;
+	
+	// Round to nearest, rather than always towards negative infinity
+	if ( inShift > 0 )
+	{
+		result = ( inValue + ( 1L << ( inShift - 1 ))) >> inShift;
+	}
+	
+	return result;
+}
+
+static inline int16_t _PlatformFilter_Saturate( const int32_t inValue )
+{
+	int16_t result;
+	
+	if ( inValue > INT16_MAX )
+	{
+		result = INT16_MAX;
+	}
+	else if ( inValue < INT16_MIN )
+	{
+		result = INT16_MIN;
+	}
+	else
+	{
+		result = ( int16_t )inValue;
+	}
+	
+	return result;
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+/*
+ * PlatformFilter.h
+ *
+ * Fixed-point streaming filters for sample streams such as ADC readings, and a way to chain them. 
+ * This has no hardware dependencies, so it can also be compiled and exercised on a host machine.
+ *
+ * Created: 2026-10-18 3:02:44 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMFILTER_H_
+#define PLATFORMFILTER_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Samples are signed 16-bit values. They can be raw ADC counts, or Q15 fractions (-1.0 to 1.0 - 2^-15).
+// Coefficients are Q15: 32767 is ~1.0.
+#define PLATFORM_FILTER_Q15_ONE                ( 32767 )
+
+#define PLATFORM_FILTER_MOVING_AVERAGE_MAX_LOG2 ( 7 )  // Up to 128 samples
+#define PLATFORM_FILTER_IIR_MAX_SHIFT           ( 15 )
+#define PLATFORM_FILTER_MEDIAN_MAX_WINDOW       ( 9 )
+
+typedef enum
+{
+	PlatformFilterType_MovingAverageQ15,
+	PlatformFilterType_MovingAverageQ7,
+	PlatformFilterType_IIR,
+	PlatformFilterType_Median,
+	PlatformFilterType_FIR,
+	PlatformFilterType_Max,
+} PlatformFilterType_t;
+
+typedef struct
+{
+	int16_t *history;   // Caller provided, ( 1 << windowLog2 ) samples
+	int32_t  sum;
+	uint8_t  windowLog2;
+	uint8_t  index;
+	bool     isFull;
+} PlatformFilterMovingAverageQ15_t;
+
+typedef struct
+{
+	int8_t  *history;   // Caller provided, ( 1 << windowLog2 ) samples
+	int16_t  sum;
+	uint8_t  windowLog2;
+	uint8_t  index;
+	bool     isFull;
+} PlatformFilterMovingAverageQ7_t;
+
+typedef struct
+{
+	int32_t state;      // Output scaled by 2^shift
+	uint8_t shift;
+	bool    isPrimed;
+} PlatformFilterIIR_t;
+
+typedef struct
+{
+	int16_t history[ PLATFORM_FILTER_MEDIAN_MAX_WINDOW ];
+	uint8_t windowSize;
+	uint8_t index;
+	uint8_t numSamples;
+} PlatformFilterMedian_t;
+
+typedef struct
+{
+	const int16_t *coefficients; // Caller provided, Q15, numTaps long
+	int16_t       *history;      // Caller provided, numTaps long
+	uint8_t        numTaps;
+	uint8_t        index;
+	uint8_t        decimation;
+	uint8_t        decimationCount;
+} PlatformFilterFIR_t;
+
+typedef struct
+{
+	PlatformFilterType_t type;
+	void                *filter; // Points to the filter struct matching type. Q7 moving averages take the top 8 bits of each Q15 sample and scale their output back up.
+} PlatformFilterStage_t;
+
+/*!
+ *\brief    Initializes a moving average over the last 2^inWindowLog2 Q15 samples.
+ *
+ *\details  The average is kept as a running sum, so each sample costs one add and one subtract regardless of the window size.
+ *          Until the window is full, the average is over the samples received so far.
+ *
+ *\param    inFilter     - Filter to initialize.
+ *\param    inHistory    - Buffer for the sample history, of length ( 1 << inWindowLog2 ). Must stay valid while the filter is used.
+ *\param    inWindowLog2 - Log2 of the window size, up to PLATFORM_FILTER_MOVING_AVERAGE_MAX_LOG2.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if an argument is invalid.
+ */
+PlatformStatus PlatformFilter_InitMovingAverageQ15( PlatformFilterMovingAverageQ15_t *const inFilter, int16_t *const inHistory, const uint8_t inWindowLog2 );
+
+/*!
+ *\brief    Adds a sample to a Q15 moving average, and gets the new average.
+ *
+ *\return   true, always. Every sample produces an output.
+ */
+bool PlatformFilter_ProcessMovingAverageQ15( PlatformFilterMovingAverageQ15_t *const inFilter, const int16_t inSample, int16_t *const outSample );
+
+/*!
+ *\brief    Initializes a moving average over the last 2^inWindowLog2 Q7 samples. Uses half the memory of the Q15 version, for 8-bit data.
+ *
+ *\param    inFilter     - Filter to initialize.
+ *\param    inHistory    - Buffer for the sample history, of length ( 1 << inWindowLog2 ). Must stay valid while the filter is used.
+ *\param    inWindowLog2 - Log2 of the window size, up to PLATFORM_FILTER_MOVING_AVERAGE_MAX_LOG2.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if an argument is invalid.
+ */
+PlatformStatus PlatformFilter_InitMovingAverageQ7( PlatformFilterMovingAverageQ7_t *const inFilter, int8_t *const inHistory, const uint8_t inWindowLog2 );
+
+/*!
+ *\brief    Adds a sample to a Q7 moving average, and gets the new average.
+ *
+ *\return   true, always. Every sample produces an output.
+ */
+bool PlatformFilter_ProcessMovingAverageQ7( PlatformFilterMovingAverageQ7_t *const inFilter, const int8_t inSample, int8_t *const outSample );
+
+/*!
+ *\brief    Initializes a single-pole IIR low-pass filter, y += ( x - y ) * alpha, where alpha = 1 / 2^inShift.
+ *
+ *\details  Restricting alpha to powers of two keeps the filter to shifts and adds, with no multiplies. The filter state keeps inShift
+ *          fractional bits so small steps are not lost to rounding. The time constant is roughly 2^inShift samples.
+ *          The filter starts at the first sample it receives, rather than ramping up from 0.
+ *
+ *\param    inFilter - Filter to initialize.
+ *\param    inShift  - Log2 of 1 / alpha, from 1 to PLATFORM_FILTER_IIR_MAX_SHIFT.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if an argument is invalid.
+ */
+PlatformStatus PlatformFilter_InitIIR( PlatformFilterIIR_t *const inFilter, const uint8_t inShift );
+
+/*!
+ *\brief    Adds a sample to a single-pole IIR low-pass filter, and gets the filtered output.
+ *
+ *\return   true, always. Every sample produces an output.
+ */
+bool PlatformFilter_ProcessIIR( PlatformFilterIIR_t *const inFilter, const int16_t inSample, int16_t *const outSample );
+
+/*!
+ *\brief    Initializes a median filter over a small window, to reject impulse noise while keeping edges.
+ *
+ *\details  Each sample sorts a copy of the window, so keep the window small. Until the window is full, the median is over the samples received so far.
+ *
+ *\param    inFilter     - Filter to initialize.
+ *\param    inWindowSize - Window size; odd, from 3 to PLATFORM_FILTER_MEDIAN_MAX_WINDOW.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if an argument is invalid.
+ */
+PlatformStatus PlatformFilter_InitMedian( PlatformFilterMedian_t *const inFilter, const uint8_t inWindowSize );
+
+/*!
+ *\brief    Adds a sample to a median filter, and gets the median of the window.
+ *
+ *\return   true, always. Every sample produces an output.
+ */
+bool PlatformFilter_ProcessMedian( PlatformFilterMedian_t *const inFilter, const int16_t inSample, int16_t *const outSample );
+
+/*!
+ *\brief    Initializes a decimating FIR filter with Q15 coefficients, producing one output for every inDecimation input samples.
+ *
+ *\details  Only the outputs that are kept are computed, so decimating by M costs 1 / M of the multiplies of filtering then discarding.
+ *          Products are accumulated in 32 bits. If the absolute values of the coefficients sum to at most 1.0 (32768) the accumulator cannot overflow;
+ *          the output is rounded and saturated to 16 bits.
+ *
+ *\param    inFilter       - Filter to initialize.
+ *\param    inCoefficients - Q15 coefficients, of length inNumTaps. Must stay valid while the filter is used.
+ *\param    inHistory      - Buffer for the sample history, of length inNumTaps. Must stay valid while the filter is used.
+ *\param    inNumTaps      - Number of taps, at least 1.
+ *\param    inDecimation   - Decimation factor, at least 1. 1 is a plain FIR filter.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if an argument is invalid.
+ */
+PlatformStatus PlatformFilter_InitFIR( PlatformFilterFIR_t *const inFilter,
+                                       const int16_t *const       inCoefficients,
+                                       int16_t *const             inHistory,
+                                       const uint8_t              inNumTaps,
+                                       const uint8_t              inDecimation );
+
+/*!
+ *\brief    Adds a sample to a decimating FIR filter, and gets the filtered output when one is due.
+ *
+ *\return   true if an output was produced, i.e. on every inDecimation'th sample.
+ */
+bool PlatformFilter_ProcessFIR( PlatformFilterFIR_t *const inFilter, const int16_t inSample, int16_t *const outSample );
+
+/*!
+ *\brief    Passes a sample through a chain of initialized filters, in order.
+ *
+ *\details  The chain stops early when a decimating stage does not produce an output, so later stages run at the decimated rate. 
+ *          A Q7 stage keeps only the top 8 bits of each sample, so scale raw ADC counts up to Q15 first if the chain has one, e.g. shift a 10-bit reading left by 5.
+ *          This can be called from a sampling complete callback or on samples read from a stream, e.g. PlatformADC_ReadStreamedSamples().
+ *
+ *\param    inStages    - Filter stages, in order.
+ *\param    inNumStages - Number of stages.
+ *\param    inSample    - Sample to filter.
+ *\param    outSample   - Pointer to store the output of the last stage. Only written when this function returns true.
+ *
+ *\return   true if the last stage produced an output.
+ */
+bool PlatformFilter_ProcessChain( const PlatformFilterStage_t *const inStages, const uint8_t inNumStages, const int16_t inSample, int16_t *const outSample );
+
+#endif /* PLATFORMFILTER_H_ */
\ No newline at end of file
@@ -6,19 +6,39 @@
  */ 
 
 #include "PlatformGPIO.h"
+#include "PlatformInterrupt.h"
 #include "require_macros.h"
 #include <stdint.h>
+#include <stddef.h>
+
+#if PLATFORM_GPIO_INTERRUPT_TIMESTAMPS_ENABLED
+#include "PlatformTimer.h"
+#endif
 
 //================//
 //    Defines     //
 //================//
 
-#define PLATFORM_GPIO_REG_BASE   ( 0x20 )
-#define PLATFORM_GPIO_REG_OFFSET ( 0x03 )
-
 #define PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( PORT ) ( PlatformPortRegGroup_t* )( PLATFORM_GPIO_REG_BASE + ( PORT ) * PLATFORM_GPIO_REG_OFFSET )
 #define PLATFORM_GPIO_GET_PIN_MASK( PIN )                  ( uint8_t )( 1 << ( PIN ))
 
+// PB6, PB7 and PC6 are used by the crystal and reset, so they aren't available as GPIO
+#define PLATFORM_GPIO_PORT_B_PINS                          ( 0x3F )
+#define PLATFORM_GPIO_PORT_C_PINS                          ( 0x3F )
+#define PLATFORM_GPIO_PORT_D_PINS                          ( 0xFF )
+
+#define PLATFORM_GPIO_NUM_GPIOS                            ( PlatformGPIO_PTD7 + 1 )
+#define PLATFORM_GPIO_NUM_PORTS                            ( 3 )
+
+// Pin change interrupt group n covers port B, C and D in order, e.g. PCINT0_vect and PCMSK0 for port B
+#define PLATFORM_GPIO_GET_PIN_CHANGE_GROUP( PORT )         (( PORT ) - PlatformPortB )
+
+#if PLATFORM_GPIO_INTERRUPT_TIMESTAMPS_ENABLED
+#define PLATFORM_GPIO_GET_TIMESTAMP()                      PlatformTimer_GetTicksFromCount( TCNT1 )
+#else
+#define PLATFORM_GPIO_GET_TIMESTAMP()                      ( 0 )
+#endif
+
 //================//
 //    Typedefs    //
 //================//
@@ -144,17 +164,29 @@ static const PlatformGPIOStruct_t platformGPIOList[] =
 	},
 };
 
+static const PlatformGPIO_t kPlatformGPIOFirstGPIOOfPort[ PLATFORM_GPIO_NUM_PORTS ] = { PlatformGPIO_PTB0, PlatformGPIO_PTC0, PlatformGPIO_PTD0 };
+
+static volatile uint8_t *const kPlatformGPIOPinChangeMaskRegs[ PLATFORM_GPIO_NUM_PORTS ] = { &PCMSK0, &PCMSK1, &PCMSK2 };
+
+static PlatformGPIO_InterruptCb       mPlatformGPIOInterruptCbs[ PLATFORM_GPIO_NUM_GPIOS ];
+static PlatformGPIOInterruptTrigger_t mPlatformGPIOInterruptTriggers[ PLATFORM_GPIO_NUM_GPIOS ];
+static uint8_t                        mPlatformGPIOPinChangeSnapshots[ PLATFORM_GPIO_NUM_PORTS ]; // Port levels last seen by the pin change ISR
+
 //====================================//
 //    Static Function Declarations    //
 //====================================//
 
-static PlatformStatus _PlatformGPIO_Configure(  PlatformPortRegGroup_t* inRegGroup, uint8_t inPin, PlatformGPIOConfig_t inConfig );
+static PlatformStatus _PlatformGPIO_Configure(  PlatformPortRegGroup_t* inRegGroup, uint8_t inPinMask, PlatformGPIOConfig_t inConfig );
 static PlatformStatus _PlatformGPIO_OutputHigh( PlatformPortRegGroup_t* inRegGroup, uint8_t inPin );
 static PlatformStatus _PlatformGPIO_OutputLow(  PlatformPortRegGroup_t* inRegGroup, uint8_t inPin );
 static PlatformStatus _PlatformGPIO_Toggle(     PlatformPortRegGroup_t* inRegGroup, uint8_t inPin );
 static PlatformStatus _PlatformGPIO_GetInput(   PlatformPortRegGroup_t* inRegGroup, uint8_t inPin, bool *const outLogicLevel );
 
 static inline bool _PlatformGPIO_IsConfiguredAsOutput( PlatformPortRegGroup_t* inRegGroup, uint8_t inPin );
+static inline bool _PlatformGPIO_IsValidPortMask( PlatformGPIOPort_t inPort, uint8_t inPinMask );
+
+static void _PlatformGPIO_HandlePinChange( uint8_t inPort, uint32_t inTimestamp );
+static void _PlatformGPIO_HandleExternalInterrupt( PlatformGPIO_t inGPIO, uint32_t inTimestamp );
 
 //====================================//
 //    Public Function Definitions     //
@@ -164,7 +196,7 @@ PlatformStatus PlatformGPIO_Configure( PlatformGPIO_t inGPIO, PlatformGPIOConfig
 {
 	const PlatformGPIOStruct_t *const gpioStruct = &platformGPIOList[ inGPIO ];
 	
-	return _PlatformGPIO_Configure( PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( gpioStruct->portName ), gpioStruct->pin, inConfig );
+	return _PlatformGPIO_Configure( PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( gpioStruct->portName ), PLATFORM_GPIO_GET_PIN_MASK( gpioStruct->pin ), inConfig );
 }
 
 PlatformStatus PlatformGPIO_OutputHigh( PlatformGPIO_t inGPIO )
@@ -195,11 +227,160 @@ PlatformStatus PlatformGPIO_GetInput( PlatformGPIO_t inGPIO, bool *const outLogi
 	return _PlatformGPIO_GetInput( PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( gpioStruct->portName ), gpioStruct->pin, outLogicLevel );
 }
 
+PlatformStatus PlatformGPIO_ConfigurePort( PlatformGPIOPort_t inPort, uint8_t inPinMask, PlatformGPIOConfig_t inConfig )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( _PlatformGPIO_IsValidPortMask( inPort, inPinMask ), exit );
+	
+	status = _PlatformGPIO_Configure( PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( inPort ), inPinMask, inConfig );
+exit:
+	return status;
+}
+
+PlatformStatus PlatformGPIO_WritePort( PlatformGPIOPort_t inPort, uint8_t inPinMask, uint8_t inValue )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	PlatformPortRegGroup_t *regGroup;
+	
+	require_quiet( _PlatformGPIO_IsValidPortMask( inPort, inPinMask ), exit );
+	
+	regGroup = PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( inPort );
+	
+	// Verify every pin is configured as output
+	require_action_quiet(( regGroup->DIR & inPinMask ) == inPinMask, exit, status = PlatformStatus_Failed );
+	
+	// Toggle only the masked pins that differ from the new value, through the PIN register. 
+	// This changes them all in one store without a read-modify-write of PORTDATA, so pins outside the mask can't be clobbered.
+	regGroup->PINCTL = ( regGroup->PORTDATA ^ inValue ) & inPinMask;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformGPIO_ReadPort( PlatformGPIOPort_t inPort, uint8_t *const outValue )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	PlatformPortRegGroup_t *regGroup;
+	
+	require_quiet( _PlatformGPIO_IsValidPortMask( inPort, 0 ), exit );
+	require_quiet( outValue, exit );
+	
+	regGroup  = PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( inPort );
+	*outValue = regGroup->PINCTL;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformGPIO_EnableInterrupt( PlatformGPIO_t inGPIO, PlatformGPIOInterruptTrigger_t inTrigger, PlatformGPIO_InterruptCb inCb )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	const PlatformGPIOStruct_t *const gpioStruct = &platformGPIOList[ inGPIO ];
+	PlatformPortRegGroup_t *const regGroup = PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( gpioStruct->portName );
+	const uint8_t pinMask = PLATFORM_GPIO_GET_PIN_MASK( gpioStruct->pin );
+	const uint8_t group   = PLATFORM_GPIO_GET_PIN_CHANGE_GROUP( gpioStruct->portName );
+	const bool isExternalInterrupt = (( inGPIO == PlatformGPIO_PTD2 ) || ( inGPIO == PlatformGPIO_PTD3 )) ? true : false;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( inCb, exit );
+	require_action_quiet( inTrigger <= PlatformGPIOInterruptTrigger_RisingEdge, exit, status = PlatformStatus_NotSupported );
+	
+	// Pin change interrupts can't detect a level
+	require_action_quiet( isExternalInterrupt || ( inTrigger != PlatformGPIOInterruptTrigger_LowLevel ), exit, status = PlatformStatus_NotSupported );
+	require_action_quiet( !_PlatformGPIO_IsConfiguredAsOutput( regGroup, gpioStruct->pin ), exit, status = PlatformStatus_Failed );
+	
+	// Disable Global Interrupts, if enabled, so the ISR doesn't see a partly written callback
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	mPlatformGPIOInterruptCbs[ inGPIO ]      = inCb;
+	mPlatformGPIOInterruptTriggers[ inGPIO ] = inTrigger;
+	
+	if ( isExternalInterrupt )
+	{
+		const uint8_t intBit   = ( inGPIO == PlatformGPIO_PTD2 ) ? INT0 : INT1;
+		const uint8_t iscShift = ( inGPIO == PlatformGPIO_PTD2 ) ? ISC00 : ISC10;
+		
+		// Changing the sense control can set the flag, so disable the interrupt while changing it and clear the flag after
+		EIMSK &= ~( 1 << intBit );
+		EICRA  = ( uint8_t )(( EICRA & ~( 0x03 << iscShift )) | ( inTrigger << iscShift ));
+		EIFR   = ( 1 << intBit );
+		EIMSK |= ( 1 << intBit );
+	}
+	else
+	{
+		// Clear a stale flag if this is the first pin of the group
+		if ( !*kPlatformGPIOPinChangeMaskRegs[ group ] )
+		{
+			PCIFR = ( 1 << group );
+		}
+		
+		// Only take this pin's current level into the snapshot, so a pending change on another pin of the port isn't lost
+		mPlatformGPIOPinChangeSnapshots[ group ] = ( mPlatformGPIOPinChangeSnapshots[ group ] & ~pinMask ) | ( regGroup->PINCTL & pinMask );
+		
+		*kPlatformGPIOPinChangeMaskRegs[ group ] |= pinMask;
+		PCICR |= ( 1 << group );
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformGPIO_DisableInterrupt( PlatformGPIO_t inGPIO )
+{
+	const PlatformGPIOStruct_t *const gpioStruct = &platformGPIOList[ inGPIO ];
+	const uint8_t group = PLATFORM_GPIO_GET_PIN_CHANGE_GROUP( gpioStruct->portName );
+	bool didDisableInterrupts = false;
+	
+	// Disable Global Interrupts, if enabled, so the ISR doesn't see a partly written callback
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	if (( inGPIO == PlatformGPIO_PTD2 ) || ( inGPIO == PlatformGPIO_PTD3 ))
+	{
+		EIMSK &= ~( 1 << (( inGPIO == PlatformGPIO_PTD2 ) ? INT0 : INT1 ));
+	}
+	else
+	{
+		*kPlatformGPIOPinChangeMaskRegs[ group ] &= ~PLATFORM_GPIO_GET_PIN_MASK( gpioStruct->pin );
+		
+		// Turn off the group once its last pin is disabled
+		if ( !*kPlatformGPIOPinChangeMaskRegs[ group ] )
+		{
+			PCICR &= ~( 1 << group );
+		}
+	}
+	
+	mPlatformGPIOInterruptCbs[ inGPIO ] = NULL;
+	
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return PlatformStatus_Success;
+}
+
 //====================================//
 //    Static Function Definitions     //
 //====================================//
 
-static PlatformStatus _PlatformGPIO_Configure( PlatformPortRegGroup_t* inRegGroup, uint8_t inPin, PlatformGPIOConfig_t inConfig )
+static PlatformStatus _PlatformGPIO_Configure( PlatformPortRegGroup_t* inRegGroup, uint8_t inPinMask, PlatformGPIOConfig_t inConfig )
 {
 	PlatformStatus status = PlatformStatus_Failed;
 	
@@ -210,22 +391,23 @@ static PlatformStatus _PlatformGPIO_Configure( PlatformPortRegGroup_t* inRegGrou
 		case PlatformGPIOConfig_Output:
 		{
 			// Set the set as tri-state before setting the direction, so we drive low by default
-			inRegGroup->PORTDATA &= ~PLATFORM_GPIO_GET_PIN_MASK( inPin );
-			inRegGroup->DIR      |= PLATFORM_GPIO_GET_PIN_MASK( inPin );
+			inRegGroup->PORTDATA &= ~inPinMask;
+			inRegGroup->DIR      |= inPinMask;
 			break;
 		}
 		case PlatformGPIOConfig_InputHighZ:
 		{
 			// Set the direction as input pull-up before tri-stating, so we don't drive low
-			inRegGroup->DIR      &= ~PLATFORM_GPIO_GET_PIN_MASK( inPin );
-			inRegGroup->PORTDATA &= ~PLATFORM_GPIO_GET_PIN_MASK( inPin );
+			inRegGroup->DIR      &= ~inPinMask;
+			inRegGroup->PORTDATA &= ~inPinMask;
 			break;
 		}
 		case PlatformGPIOConfig_InputPullUp:
 		{
 			// Set as tri-state input before setting as pull up, so we don't drive high
-			inRegGroup->DIR      &= ~PLATFORM_GPIO_GET_PIN_MASK( inPin );
-			inRegGroup->PORTDATA |= PLATFORM_GPIO_GET_PIN_MASK( inPin );
+			inRegGroup->DIR      &= ~inPinMask;
+			inRegGroup->PORTDATA |= inPinMask;
+			break;
 		}
 		default:
 		{
@@ -285,7 +467,8 @@ static PlatformStatus _PlatformGPIO_Toggle( PlatformPortRegGroup_t* inRegGroup,
 	isConfiguredAsOutput = _PlatformGPIO_IsConfiguredAsOutput( inRegGroup, inPin );
 	require_quiet( isConfiguredAsOutput, exit );
 	
-	inRegGroup->PORTDATA ^= PLATFORM_GPIO_GET_PIN_MASK( inPin );
+	// Writing a 1 to the PIN register toggles the output in one store, so an interrupt can't come between the read and write
+	inRegGroup->PINCTL = PLATFORM_GPIO_GET_PIN_MASK( inPin );
 	
 	status = PlatformStatus_Success;
 exit:
@@ -315,4 +498,121 @@ exit:
 static inline bool _PlatformGPIO_IsConfiguredAsOutput( PlatformPortRegGroup_t* inRegGroup, uint8_t inPin )
 {
 	return ( inRegGroup->DIR & PLATFORM_GPIO_GET_PIN_MASK( inPin )) ? true : false;
+}
+
+static inline bool _PlatformGPIO_IsValidPortMask( PlatformGPIOPort_t inPort, uint8_t inPinMask )
+{
+	uint8_t portPins;
+	
+	switch ( inPort )
+	{
+		case PlatformGPIOPort_B:
+		{
+			portPins = PLATFORM_GPIO_PORT_B_PINS;
+			break;
+		}
+		case PlatformGPIOPort_C:
+		{
+			portPins = PLATFORM_GPIO_PORT_C_PINS;
+			break;
+		}
+		case PlatformGPIOPort_D:
+		{
+			portPins = PLATFORM_GPIO_PORT_D_PINS;
+			break;
+		}
+		default:
+		{
+			return false;
+		}
+	}
+	
+	return (( inPinMask & ~portPins ) == 0 ) ? true : false;
+}
+
+static void _PlatformGPIO_HandlePinChange( uint8_t inPort, uint32_t inTimestamp )
+{
+	PlatformPortRegGroup_t *const regGroup = PLATFORM_GPIO_GET_REG_GROUP_FROM_PORT_NAME( inPort );
+	const uint8_t group     = PLATFORM_GPIO_GET_PIN_CHANGE_GROUP( inPort );
+	const uint8_t portValue = regGroup->PINCTL;
+	uint8_t changedPins;
+	
+	// One XOR against the last snapshot finds every enabled pin that changed since the last interrupt
+	changedPins = ( portValue ^ mPlatformGPIOPinChangeSnapshots[ group ] ) & *kPlatformGPIOPinChangeMaskRegs[ group ];
+	mPlatformGPIOPinChangeSnapshots[ group ] = portValue;
+	
+	for ( uint8_t pin = 0; changedPins; pin++, changedPins >>= 1 )
+	{
+		if ( changedPins & 0x01 )
+		{
+			const PlatformGPIO_t gpio = ( PlatformGPIO_t )( kPlatformGPIOFirstGPIOOfPort[ group ] + pin );
+			const bool logicLevel     = ( portValue & PLATFORM_GPIO_GET_PIN_MASK( pin )) ? true : false;
+			
+			// Pin change interrupts fire on any edge, so filter rising and falling edges by the new level
+			switch ( mPlatformGPIOInterruptTriggers[ gpio ] )
+			{
+				case PlatformGPIOInterruptTrigger_RisingEdge:
+				{
+					if ( !logicLevel )
+					{
+						continue;
+					}
+					break;
+				}
+				case PlatformGPIOInterruptTrigger_FallingEdge:
+				{
+					if ( logicLevel )
+					{
+						continue;
+					}
+					break;
+				}
+				default:
+				{
+					break;
+				}
+			}
+			
+			if ( mPlatformGPIOInterruptCbs[ gpio ] )
+			{
+				mPlatformGPIOInterruptCbs[ gpio ]( gpio, logicLevel, inTimestamp );
+			}
+		}
+	}
+}
+
+static void _PlatformGPIO_HandleExternalInterrupt( PlatformGPIO_t inGPIO, uint32_t inTimestamp )
+{
+	bool logicLevel;
+	
+	if ( mPlatformGPIOInterruptCbs[ inGPIO ] )
+	{
+		logicLevel = PLATFORM_GPIO_READ( inGPIO );
+		mPlatformGPIOInterruptCbs[ inGPIO ]( inGPIO, logicLevel, inTimestamp );
+	}
+}
+
+ISR( INT0_vect )
+{
+	_PlatformGPIO_HandleExternalInterrupt( PlatformGPIO_PTD2, PLATFORM_GPIO_GET_TIMESTAMP() );
+}
+
+ISR( INT1_vect )
+{
+	_PlatformGPIO_HandleExternalInterrupt( PlatformGPIO_PTD3, PLATFORM_GPIO_GET_TIMESTAMP() );
+}
+
+ISR( PCINT0_vect )
+{
+	_PlatformGPIO_HandlePinChange( PlatformPortB, PLATFORM_GPIO_GET_TIMESTAMP() );
+}
+
+ISR( PCINT1_vect )
+{
+	_PlatformGPIO_HandlePinChange( PlatformPortC, PLATFORM_GPIO_GET_TIMESTAMP() );
+}
+
+ISR( PCINT2_vect )
+{
+	_PlatformGPIO_HandlePinChange( PlatformPortD, PLATFORM_GPIO_GET_TIMESTAMP() );
 }
\ No newline at end of file
@@ -11,6 +11,16 @@
 
 #include "PlatformStatus.h"
 #include <stdbool.h>
+#include <stdint.h>
+
+// Each port has PINx, DDRx and PORTx registers in a row, from PINB at 0x23 in data space
+#define PLATFORM_GPIO_REG_BASE   ( 0x20 )
+#define PLATFORM_GPIO_REG_OFFSET ( 0x03 )
+
+// If enabled, interrupt callbacks get a PlatformTimer tick timestamp of the event, so PlatformTimer_Init() must be called first
+#ifndef PLATFORM_GPIO_INTERRUPT_TIMESTAMPS_ENABLED
+#define PLATFORM_GPIO_INTERRUPT_TIMESTAMPS_ENABLED ( 0 )
+#endif
 
 typedef enum
 {
@@ -43,6 +53,33 @@ typedef enum
 	PlatformGPIOConfig_Output,
 } PlatformGPIOConfig_t;
 
+// Values match the port's register group index, as used for PLATFORM_GPIO_REG_BASE
+typedef enum
+{
+	PlatformGPIOPort_B = 1,
+	PlatformGPIOPort_C = 2,
+	PlatformGPIOPort_D = 3,
+} PlatformGPIOPort_t;
+
+// Values match the ISCn1:ISCn0 bits of the external interrupts
+typedef enum
+{
+	PlatformGPIOInterruptTrigger_LowLevel    = 0, // PD2 (INT0) and PD3 (INT1) only
+	PlatformGPIOInterruptTrigger_AnyEdge     = 1,
+	PlatformGPIOInterruptTrigger_FallingEdge = 2,
+	PlatformGPIOInterruptTrigger_RisingEdge  = 3,
+} PlatformGPIOInterruptTrigger_t;
+
+/*!
+ *\brief    GPIO interrupt callback; called from the INT0, INT1 or pin change ISR, so it should be kept short, 
+ *          e.g. post the event to PlatformDeferredWork.
+ *
+ *\param    inGPIO       - GPIO pin that triggered the interrupt.
+ *\param    inLogicLevel - Logic level of the pin when the interrupt was serviced.
+ *\param    inTimestamp  - PlatformTimer tick count when the interrupt was serviced. 0 unless PLATFORM_GPIO_INTERRUPT_TIMESTAMPS_ENABLED.
+ */
+typedef void ( *PlatformGPIO_InterruptCb )( PlatformGPIO_t inGPIO, bool inLogicLevel, uint32_t inTimestamp );
+
 
 /*!
  *\brief    Configures a GPIO to a setting. 
@@ -91,4 +128,98 @@ PlatformStatus PlatformGPIO_Toggle( PlatformGPIO_t inGPIO );
  */
 PlatformStatus PlatformGPIO_GetInput( PlatformGPIO_t inGPIO, bool *const outLogicLevel );
 
+/*!
+ *\brief    Configures a set of pins on one port to the same setting.
+ *
+ *\param    inPort    - Port of the pins.
+ *\param    inPinMask - Mask of the pins to configure, bit n for pin n. Port B and C have pins 0 to 5 only.
+ *\param    inConfig  - New configuration for the pins.
+ *
+ *\return   PlatformStatus_Success if configured successfully. PlatformStatus_InvalidArgument if the port or a pin doesn't exist.
+ */
+PlatformStatus PlatformGPIO_ConfigurePort( PlatformGPIOPort_t inPort, uint8_t inPinMask, PlatformGPIOConfig_t inConfig );
+
+/*!
+ *\brief    Outputs a value on a set of pins on one port. The pins should be configured as output prior to this call.
+ *
+ *\details  All pins in the mask change with a single store, so there is no intermediate state on the bus. 
+ *          Pins outside the mask are left untouched, even if an interrupt changes them during the call.
+ *
+ *\param    inPort    - Port of the pins.
+ *\param    inPinMask - Mask of the pins to write, bit n for pin n.
+ *\param    inValue   - Logic levels to output, bit n for pin n. Bits outside the mask are ignored.
+ *
+ *\return   PlatformStatus_Success if output successfully. PlatformStatus_InvalidArgument if the port or a pin doesn't exist.
+ *          PlatformStatus_Failed if a pin in the mask isn't configured as output.
+ */
+PlatformStatus PlatformGPIO_WritePort( PlatformGPIOPort_t inPort, uint8_t inPinMask, uint8_t inValue );
+
+/*!
+ *\brief    Reads the logic level of every pin on a port at once, whatever their configuration.
+ *
+ *\param    inPort   - Port to read.
+ *\param    outValue - Logic levels read, bit n for pin n.
+ *
+ *\return   PlatformStatus_Success if read successfully. PlatformStatus_InvalidArgument if the port doesn't exist.
+ */
+PlatformStatus PlatformGPIO_ReadPort( PlatformGPIOPort_t inPort, uint8_t *const outValue );
+
+/*!
+ *\brief    Enables an interrupt on a GPIO configured as input. Global interrupts must be enabled for the callback to be called.
+ *
+ *\details  PD2 and PD3 use the external interrupts INT0 and INT1, which support every trigger. 
+ *          Every other pin uses the pin change interrupt of its port, which fires on any edge; 
+ *          rising and falling edges are filtered in the ISR, by the level of the pin when it is serviced. 
+ *          Pulses shorter than the ISR latency may therefore be reported once with their final level, or not at all.
+ *          INT0 and INT1 can only wake the CPU from Power-down, Power-save and ADC Noise Reduction sleep on a low level, 
+ *          so while either is enabled on an edge, PlatformPowerSave_GetDeepestSleepMode() returns Idle. Pin change interrupts wake from any sleep mode.
+ *
+ *\param    inGPIO    - GPIO pin to enable the interrupt on.
+ *\param    inTrigger - Condition that triggers the interrupt.
+ *\param    inCb      - Callback to call on each interrupt.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if successful,
+ *                         - PlatformStatus_InvalidArgument if the callback is NULL,
+ *                         - PlatformStatus_NotSupported    if the trigger is not supported on this pin,
+ *                         - PlatformStatus_Failed          if the GPIO is configured as output.
+ */
+PlatformStatus PlatformGPIO_EnableInterrupt( PlatformGPIO_t inGPIO, PlatformGPIOInterruptTrigger_t inTrigger, PlatformGPIO_InterruptCb inCb );
+
+/*!
+ *\brief    Disables the interrupt on a GPIO.
+ *
+ *\param    inGPIO - GPIO pin to disable the interrupt on.
+ *
+ *\return   PlatformStatus_Success if successful.
+ */
+PlatformStatus PlatformGPIO_DisableInterrupt( PlatformGPIO_t inGPIO );
+
+//===========================//
+//    Compile-time Access    //
+//===========================//
+
+/*
+ * For a constant PlatformGPIO_t, these resolve to a fixed register and bit at compile time, 
+ * so PLATFORM_GPIO_SET, PLATFORM_GPIO_CLEAR, PLATFORM_GPIO_TOGGLE and PLATFORM_GPIO_READ compile to a single sbi, cbi, sbi on PINx, or sbis/sbic instruction.
+ * They don't check the pin's configuration; configure it with PlatformGPIO_Configure() first.
+ * Use the functions above when the pin is only known at run time.
+ */
+
+#define PLATFORM_GPIO_PORT_INDEX( GPIO ) (( GPIO ) < PlatformGPIO_PTC0 ? 1 : (( GPIO ) < PlatformGPIO_PTD0 ? 2 : 3 ))
+#define PLATFORM_GPIO_PIN_INDEX( GPIO )  (( GPIO ) < PlatformGPIO_PTC0 ? ( GPIO ) - PlatformGPIO_PTB0 : \
+                                         (( GPIO ) < PlatformGPIO_PTD0 ? ( GPIO ) - PlatformGPIO_PTC0 : ( GPIO ) - PlatformGPIO_PTD0 ))
+#define PLATFORM_GPIO_PIN_MASK( GPIO )   (( uint8_t )( 1 << PLATFORM_GPIO_PIN_INDEX( GPIO )))
+
+#define PLATFORM_GPIO_PIN_REG( GPIO )    ( *( volatile uint8_t* )( PLATFORM_GPIO_REG_BASE + PLATFORM_GPIO_PORT_INDEX( GPIO ) * PLATFORM_GPIO_REG_OFFSET ))
+#define PLATFORM_GPIO_DDR_REG( GPIO )    ( *( volatile uint8_t* )( PLATFORM_GPIO_REG_BASE + PLATFORM_GPIO_PORT_INDEX( GPIO ) * PLATFORM_GPIO_REG_OFFSET + 1 ))
+#define PLATFORM_GPIO_PORT_REG( GPIO )   ( *( volatile uint8_t* )( PLATFORM_GPIO_REG_BASE + PLATFORM_GPIO_PORT_INDEX( GPIO ) * PLATFORM_GPIO_REG_OFFSET + 2 ))
+
+#define PLATFORM_GPIO_SET( GPIO )        ( PLATFORM_GPIO_PORT_REG( GPIO ) |= PLATFORM_GPIO_PIN_MASK( GPIO ))
+#define PLATFORM_GPIO_CLEAR( GPIO )      ( PLATFORM_GPIO_PORT_REG( GPIO ) &= ( uint8_t )~PLATFORM_GPIO_PIN_MASK( GPIO ))
+#define PLATFORM_GPIO_READ( GPIO )       (( PLATFORM_GPIO_PIN_REG( GPIO ) & PLATFORM_GPIO_PIN_MASK( GPIO )) ? true : false )
+
+// Writing a 1 to a PINx bit toggles the PORTx bit in hardware. The |= compiles to a single sbi, which writes only the one bit,
+// so no other pin is toggled; a plain store would need the mask loaded into a register first.
+#define PLATFORM_GPIO_TOGGLE( GPIO )     ( PLATFORM_GPIO_PIN_REG( GPIO ) |= PLATFORM_GPIO_PIN_MASK( GPIO ))
+
 #endif /* PLATFORMGPIO_H_ */
\ No newline at end of file
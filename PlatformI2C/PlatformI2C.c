@@ -6,24 +6,71 @@
  */ 
 
 #include "PlatformI2C.h"
+#include "PlatformI2CBitRate.h"
 #include "PlatformStatus.h"
 #include "PlatformPowerSave.h"
 #include "PlatformClock.h"
+#include "PlatformTimer.h"
+#include "PlatformGPIO.h"
 #include "require_macros.h"
-#include <avr/io.h>
 #include <stdbool.h>
+#include <string.h>
+
+#ifdef PLATFORM_I2C_HOST
+// Simulated TWI registers and slave devices, for building and testing on a host machine
+#include "PlatformI2CHost.h"
+#else
+#include "PlatformInterrupt.h"
+#include <avr/io.h>
+#include <util/delay.h>
+
+// Every TWCR write goes through here, since writing TWINT starts the next bus action. The host backend simulates that action.
+#define PLATFORM_I2C_WRITE_TWCR( VALUE ) ( TWCR = ( VALUE ))
+#endif
 
-#define PLATFORM_I2C_FAST_MODE_HZ ( 400000 )
 #define PLATFORM_I2C_WRITE_BIT    ( 0 )
 #define PLATFORM_I2C_READ_BIT     ( 1 )
 
-#define PLATFORM_I2C_TWBR_MAX     ( 0xFF )
-#define PLATFORM_I2C_TWBR_MIN     ( 0x00 )
+#define PLATFORM_I2C_PRESCALER_MASK (( 1 << TWPS1 ) | ( 1 << TWPS0 ))
+
+#define PLATFORM_I2C_QUEUE_MASK   ( PLATFORM_I2C_QUEUE_SIZE - 1 )
+
+#define PLATFORM_I2C_TIMEOUT_TICKS ( PLATFORM_I2C_TIMEOUT_MS * PLATFORM_TIMER_TICKS_PER_MS )
+
+// PlatformTimer's millisecond count only advances in its ISR, so waits with global interrupts disabled count fixed delays instead
+#define PLATFORM_I2C_POLL_INTERVAL_US ( 10 )
+#define PLATFORM_I2C_TIMEOUT_POLLS    (( PLATFORM_I2C_TIMEOUT_MS * 1000UL ) / PLATFORM_I2C_POLL_INTERVAL_US )
+
+#define PLATFORM_I2C_SCL_GPIO      ( PlatformGPIO_PTC5 )
+#define PLATFORM_I2C_SDA_GPIO      ( PlatformGPIO_PTC4 )
+
+// Bus recovery is clocked at about 100kHz, which every slave supports
+#define PLATFORM_I2C_RECOVERY_HALF_PERIOD_US ( 5 )
+#define PLATFORM_I2C_RECOVERY_MAX_CLOCKS     ( 9 )
 
 #define GET_TWSR_STATUS_CODE() ( TWSR & (( 1 << TWS7 ) | ( 1 << TWS6 ) | ( 1 << TWS5 ) | ( 1 << TWS4 ) | ( 1 << TWS3 )))
 
+// TWCR values for each bus action. Writing TWINT as 1 clears the flag, which starts the action.
+#define PLATFORM_I2C_TWCR_IDLE       (( 1 << TWEN ) | ( 1 << TWIE ))
+#define PLATFORM_I2C_TWCR_CONTINUE   (( 1 << TWEN ) | ( 1 << TWIE ) | ( 1 << TWINT ))
+#define PLATFORM_I2C_TWCR_ACK        ( PLATFORM_I2C_TWCR_CONTINUE | ( 1 << TWEA ))
+#define PLATFORM_I2C_TWCR_START      ( PLATFORM_I2C_TWCR_CONTINUE | ( 1 << TWSTA ))
+#define PLATFORM_I2C_TWCR_STOP       ( PLATFORM_I2C_TWCR_CONTINUE | ( 1 << TWSTO ))
+#define PLATFORM_I2C_TWCR_STOP_START ( PLATFORM_I2C_TWCR_CONTINUE | ( 1 << TWSTO ) | ( 1 << TWSTA ))
+
+#if ( PLATFORM_I2C_QUEUE_SIZE & PLATFORM_I2C_QUEUE_MASK ) || ( PLATFORM_I2C_QUEUE_SIZE > 128 )
+#error PLATFORM_I2C_QUEUE_SIZE must be a power of 2, and at most 128
+#endif
+
+#define PLATFORM_I2C_TRACE_MASK   ( PLATFORM_I2C_TRACE_SIZE - 1 )
+
+#if ( PLATFORM_I2C_TRACE_SIZE & PLATFORM_I2C_TRACE_MASK ) || ( PLATFORM_I2C_TRACE_SIZE > 128 )
+#error PLATFORM_I2C_TRACE_SIZE must be a power of 2, and at most 128
+#endif
+
 enum TWSRStatus
 {
+	TWSRStatus_BusError                          = 0x00,
 	TWSRStatus_StartConditionTransmitted         = 0x08,
 	TWSRStatus_RepeatedStartConditionTransmitted = 0x10,
 	TWSRStatus_SLAW_ACKReceived                  = 0x18,
@@ -35,48 +82,145 @@ enum TWSRStatus
 	TWSRStatus_SLAR_NACKReceived                 = 0x48,
 	TWSRStatus_DataReceivedAndACKSent            = 0x50,
 	TWSRStatus_DataReceivedAndNACKSent           = 0x58,
-		
+	
+	// Slave mode. GC is the general call address.
+	TWSRStatus_SlaveFirst                        = 0x60,
+	TWSRStatus_OwnSLAW_ACKSent                   = 0x60,
+	TWSRStatus_ArbitrationLostOwnSLAW            = 0x68,
+	TWSRStatus_GeneralCall_ACKSent               = 0x70,
+	TWSRStatus_ArbitrationLostGeneralCall        = 0x78,
+	TWSRStatus_SlaveDataReceivedAndACKSent       = 0x80,
+	TWSRStatus_SlaveDataReceivedAndNACKSent      = 0x88,
+	TWSRStatus_GCDataReceivedAndACKSent          = 0x90,
+	TWSRStatus_GCDataReceivedAndNACKSent         = 0x98,
+	TWSRStatus_StopOrRepeatedStartReceived       = 0xA0,
+	TWSRStatus_OwnSLAR_ACKSent                   = 0xA8,
+	TWSRStatus_ArbitrationLostOwnSLAR            = 0xB0,
+	TWSRStatus_SlaveDataSentAndACKReceived       = 0xB8,
+	TWSRStatus_SlaveDataSentAndNACKReceived      = 0xC0,
+	TWSRStatus_SlaveLastDataSent                 = 0xC8,
+	TWSRStatus_SlaveLast                         = 0xC8,
 };
 
-static const uint8_t kPlatformI2CBitRatePrescalers[] = { 1, 4, 16, 64 };
+typedef enum
+{
+	PlatformI2CPhase_RegisterAddress,
+	PlatformI2CPhase_WriteData,
+	PlatformI2CPhase_ReadData,
+} PlatformI2CPhase_t;
+
+typedef struct
+{
+	PlatformI2CTransaction_t *volatile queue[ PLATFORM_I2C_QUEUE_SIZE ]; // Waiting transactions
+	volatile uint8_t                   queueHead;                        // Free running; only changed by PlatformI2C_Submit()
+	volatile uint8_t                   queueTail;                        // Free running; only changed in ISR
+	PlatformI2CTransaction_t *volatile current;                          // Transaction on the bus, or NULL if idle
+	uint8_t                            segmentIndex;                     // Segment of the current transaction on the bus
+	size_t                             dataIndex;                        // Next byte of the segment's data
+	uint8_t                            registerIndex;                    // Next byte of the segment's register address
+	PlatformI2CPhase_t                 phase;
+	bool                               isReadAddress;                    // Whether the next (repeated) START is followed by SLA+R rather than SLA+W
+	uint32_t                           lastProgressTicks;                // PlatformTimer ticks at the last bus event, for timeouts
+#if PLATFORM_I2C_TRACE_ENABLED
+	uint32_t                           startTicks;                       // PlatformTimer ticks when the current transaction started
+#endif
+} PlatformI2CEngine_t;
+
+typedef struct
+{
+	PlatformI2CSlaveConfig_t config;
+	bool                     isEnabled;
+	bool                     isAddressed;          // Between the host addressing us and the end of the transfer
+	bool                     isGeneralCall;
+	bool                     isPointerReceived;    // Whether the first byte of the host write, the register pointer, has arrived
+	uint8_t                  registerPointer;
+	uint8_t                  firstWrittenRegister;
+} PlatformI2CSlave_t;
+
 static bool mPlatformI2CIsInitialized;
+static PlatformI2CEngine_t mPlatformI2CEngine;
+static PlatformI2CRecoveryCounters_t mPlatformI2CRecoveryCounters;
+static PlatformI2CSlave_t mPlatformI2CSlave;
+
+#if PLATFORM_I2C_TRACE_ENABLED
+typedef struct
+{
+	PlatformI2CTraceRecord_t  records[ PLATFORM_I2C_TRACE_SIZE ];
+	uint8_t                   recordHead;  // Free running
+	uint8_t                   numRecords;
+	PlatformI2CTraceSummary_t summary;
+	uint32_t                  resetTicks;  // PlatformTimer ticks when tracing was last reset
+} PlatformI2CTrace_t;
+
+static PlatformI2CTrace_t mPlatformI2CTrace;
+
+static void _PlatformI2C_TraceTransaction( const PlatformI2CTransaction_t *const inTransaction, const PlatformStatus inStatus, const uint8_t inTWSRStatus );
+#endif
 
-static PlatformStatus        _PlatformI2C_ReadByte( uint8_t *const outDataByte, const bool isLastByteToRead );
-static PlatformStatus        _PlatformI2C_WriteByte( const uint8_t inDataByte );
-static inline PlatformStatus _PlatformI2C_SendRegisterAddress( const uint8_t inRegisterAddress );
-static PlatformStatus        _PlatformI2C_SendSlaveAddressAndReadWriteBit( const uint8_t inDeviceAddr, const bool inReadWriteBit );
-static void                  _PlatformI2C_SendStopCondition( void );
-static PlatformStatus        _PlatformI2C_SendStartCondition( const bool isRepeatedStart );
-static PlatformStatus        _PlatformI2C_GetClockPrescalerBitsAndBitRateValues( uint32_t inCPUFreq, uint8_t *const outPrescalerBits, uint8_t *const outBitRateVal );
+static bool           _PlatformI2C_IsValidTransaction( const PlatformI2CTransaction_t *const inTransaction );
+static void           _PlatformI2C_BeginTransaction( PlatformI2CTransaction_t *const inTransaction );
+static bool           _PlatformI2C_PrepareSegment( void );
+static void           _PlatformI2C_WriteNextByte( void );
+static bool           _PlatformI2C_IsLastReadByte( void );
+static void           _PlatformI2C_HandleEvent( void );
+static void           _PlatformI2C_CompleteTransaction( const PlatformStatus inStatus, const bool inSendStop, const uint8_t inTWSRStatus );
+static void           _PlatformI2C_HandleSlaveEvent( const uint8_t inTWSRStatus );
+static void           _PlatformI2C_FinishSlaveWrite( void );
+static inline uint8_t _PlatformI2C_GetIdleTWCR( void );
+static inline void    _PlatformI2C_MarkProgress( void );
+static bool           _PlatformI2C_HasTimedOut( void );
+static PlatformStatus _PlatformI2C_WaitForStop( void );
+static void           _PlatformI2C_TimeOutTransaction( void );
+static PlatformStatus _PlatformI2C_RecoverBus( void );
 
-PlatformStatus PlatformI2C_Init( void )
+PlatformStatus PlatformI2C_Init( const uint32_t inTargetSCLHz, uint32_t *const outOptionalActualSCLHz )
 {
 	PlatformStatus status = PlatformStatus_Failed;
 	
-	uint8_t clockPrescalerBits;
-	uint8_t bitRateRegisterValue;
+	uint8_t  clockPrescalerBits;
+	uint8_t  bitRateRegisterValue;
+	uint32_t actualSCLHz;
+	uint32_t ticks;
 	
 	require_action_quiet( !mPlatformI2CIsInitialized, exit, status = PlatformStatus_AlreadyInitialized );
 	
-	// Enable Power to the I2C peripheral
-	status = PlatformPowerSave_PowerOnPeripheral( PlatformPowerSavePeripheral_I2C );
+	// PlatformTimer must already be running, since timeouts are measured with it. Without it a hung bus would never time out.
+	status = PlatformTimer_GetTicks( &ticks );
 	require_noerr_quiet( status, exit );
 	
-	// Get the prescaler and bit rate values that create an SCL frequency of 400kHz
-	status = _PlatformI2C_GetClockPrescalerBitsAndBitRateValues( F_CPU, &clockPrescalerBits, &bitRateRegisterValue );
+	// Get the prescaler and bit rate values for the fastest SCL frequency up to the target
+	status = PlatformI2CBitRate_Calculate( F_CPU, inTargetSCLHz, &clockPrescalerBits, &bitRateRegisterValue, &actualSCLHz );
+	require_noerr_quiet( status, exit );
+	
+	// Enable Power to the I2C peripheral
+	status = PlatformPowerSave_PowerOnPeripheral( PlatformPowerSavePeripheral_I2C );
 	require_noerr_quiet( status, exit );
 	
 	// Set the prescaler bits
-	TWSR |= clockPrescalerBits;
+	TWSR = ( TWSR & ~PLATFORM_I2C_PRESCALER_MASK ) | clockPrescalerBits;
 	
 	// Set the bit rate register
 	TWBR = bitRateRegisterValue;
 	
-	// Enable the I2C peripheral
-	TWCR = ( 1 << TWEN );
+	// Start with an empty queue and no faults
+	mPlatformI2CRecoveryCounters.numTimeouts         = 0;
+	mPlatformI2CRecoveryCounters.numRecoveries       = 0;
+	mPlatformI2CRecoveryCounters.numFailedRecoveries = 0;
+	mPlatformI2CEngine.queueHead = 0;
+	mPlatformI2CEngine.queueTail = 0;
+	mPlatformI2CEngine.current   = NULL;
+	mPlatformI2CSlave.isEnabled  = false;
+	
+	// Enable the I2C peripheral and its interrupt
+	PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_IDLE );
 	
 	mPlatformI2CIsInitialized = true;
 	
+	if ( outOptionalActualSCLHz )
+	{
+		*outOptionalActualSCLHz = actualSCLHz;
+	}
+	
 	status = PlatformStatus_Success;
 exit:
 	return status;
@@ -88,8 +232,14 @@ PlatformStatus PlatformI2C_Deinit( void )
 	
 	require_action_quiet( mPlatformI2CIsInitialized, exit, status = PlatformStatus_NotInitialized );
 	
-	// Disable the I2C peripheral
-	TWCR &= ~( 1 << TWEN );
+	// Don't pull the bus out from under a transaction
+	require_quiet( !PlatformI2C_IsBusy(), exit );
+	
+	// Disable the I2C peripheral and its interrupt, and stop responding as a slave
+	PLATFORM_I2C_WRITE_TWCR( TWCR & ~(( 1 << TWEN ) | ( 1 << TWIE ) | ( 1 << TWEA )) );
+	TWAR  = 0;
+	mPlatformI2CSlave.isEnabled   = false;
+	mPlatformI2CSlave.isAddressed = false;
 	
 	// Disable power to the peripheral
 	status = PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_I2C );
@@ -102,263 +252,1039 @@ exit:
 	return status;
 }
 
-PlatformStatus PlatformI2C_WriteByte( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, const uint8_t inDataByte )
+PlatformStatus PlatformI2C_Submit( PlatformI2CTransaction_t *const inTransaction )
 {
-	return PlatformI2C_Write( inDeviceAddr, inRegisterAddress, &inDataByte, 1 );
-}
-
-PlatformStatus PlatformI2C_Write( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, const uint8_t *const inData, const size_t inDataLen )
-{
-	PlatformStatus status = PlatformStatus_Failed;
-	bool startConditionSent = false;
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	bool didDisableInterrupts = false;
 	
-	require_quiet( inData,    exit );
-	require_quiet( inDataLen, exit );
+	require_quiet( _PlatformI2C_IsValidTransaction( inTransaction ), exit );
 	
 	require_action_quiet( mPlatformI2CIsInitialized, exit, status = PlatformStatus_NotInitialized );
 	
-	// Sanity check that there is no current I2C action in progress, and that the write collision bit is cleared
-	require_quiet( !( TWCR & ( 1 << TWINT )), exit );
-	require_quiet( !( TWCR & ( 1 << TWWC )),  exit );
+	// Disable Global Interrupts, if enabled, so the ISR doesn't change the queue underneath us
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
 	
-	status = _PlatformI2C_SendStartCondition( false );
-	require_noerr_quiet( status, exit );
-	startConditionSent = true;
+	inTransaction->status     = PlatformStatus_Failed;
+	inTransaction->isComplete = false;
 	
-	status = _PlatformI2C_SendSlaveAddressAndReadWriteBit( inDeviceAddr, PLATFORM_I2C_WRITE_BIT );
-	require_noerr_quiet( status, exit );
+	if ( mPlatformI2CEngine.current == NULL )
+	{
+		// The bus is idle; start right away. Wait for a STOP from the last transaction to finish first.
+		// If the STOP never finishes the bus has been recovered, so carry on.
+		( void )_PlatformI2C_WaitForStop();
+		
+		_PlatformI2C_BeginTransaction( inTransaction );
+		
+		// While the host is using us as a slave, or about to, the START is sent once the slave transfer is done
+		if ( !mPlatformI2CSlave.isAddressed && !( TWCR & ( 1 << TWINT )))
+		{
+			PLATFORM_I2C_WRITE_TWCR( _PlatformI2C_GetIdleTWCR() | ( 1 << TWSTA ) | ( 1 << TWINT ) );
+		}
+	}
+	else
+	{
+		require_action_quiet(( uint8_t )( mPlatformI2CEngine.queueHead - mPlatformI2CEngine.queueTail ) < PLATFORM_I2C_QUEUE_SIZE, exit, status = PlatformStatus_Failed );
+		
+		mPlatformI2CEngine.queue[ mPlatformI2CEngine.queueHead & PLATFORM_I2C_QUEUE_MASK ] = inTransaction;
+		mPlatformI2CEngine.queueHead++;
+	}
 	
-	status = _PlatformI2C_SendRegisterAddress( inRegisterAddress );
-	require_noerr_quiet( status, exit );
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformI2C_CheckTimeout( void )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
 	
-	// Send each byte of data
-	for ( size_t i = 0; i < inDataLen; i++ )
-	{	
-		_PlatformI2C_WriteByte( inData[i] );
-		require_noerr_quiet( status, exit );
+	require_quiet( mPlatformI2CIsInitialized, exit );
+	
+	// Disable Global Interrupts, if enabled, so the transaction can't complete while it's being aborted
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
 	}
 	
 	status = PlatformStatus_Success;
-exit:
-	if ( startConditionSent )
+	
+	if (( mPlatformI2CEngine.current != NULL ) && _PlatformI2C_HasTimedOut() )
 	{
-		_PlatformI2C_SendStopCondition();
+		_PlatformI2C_TimeOutTransaction();
+		status = PlatformStatus_Timeout;
 	}
 	
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
 	return status;
 }
 
-PlatformStatus PlatformI2C_Read( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, uint8_t *const outData, const size_t inDataLen )
+PlatformStatus PlatformI2C_RecoverBus( void )
 {
 	PlatformStatus status = PlatformStatus_Failed;
-	bool startConditionSent = false;
-		
-	require_quiet( outData,   exit );
-	require_quiet( inDataLen, exit );
+	bool didDisableInterrupts = false;
 	
 	require_action_quiet( mPlatformI2CIsInitialized, exit, status = PlatformStatus_NotInitialized );
-		
-	// Sanity check that there is no current I2C action in progress, and that the write collision bit is cleared
-	require_quiet( !( TWCR & ( 1 << TWINT )), exit );
-	require_quiet( !( TWCR & ( 1 << TWWC )),  exit );
 	
-	status = _PlatformI2C_SendStartCondition( false );
-	require_noerr_quiet( status, exit );
-	startConditionSent = true;
+	// Disable Global Interrupts, if enabled, so a transaction can't be started part way through
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
 	
-	status = _PlatformI2C_SendSlaveAddressAndReadWriteBit( inDeviceAddr, PLATFORM_I2C_WRITE_BIT );
-	require_noerr_quiet( status, exit );
+	require_quiet( !PlatformI2C_IsBusy(), exit );
 	
-	status = _PlatformI2C_SendRegisterAddress( inRegisterAddress );
-	require_noerr_quiet( status, exit );
+	status = _PlatformI2C_RecoverBus();
 	
-	// Send Repeated Start Condition 
-	status = _PlatformI2C_SendStartCondition( true );
-	require_noerr_quiet( status, exit );
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformI2C_GetRecoveryCounters( PlatformI2CRecoveryCounters_t *const outCounters )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	bool didDisableInterrupts = false;
 	
-	status = _PlatformI2C_SendSlaveAddressAndReadWriteBit( inDeviceAddr, PLATFORM_I2C_READ_BIT );
-	require_noerr_quiet( status, exit );
+	require_quiet( outCounters, exit );
 	
-	// Read each byte
-	for ( size_t i = 0; i < inDataLen; i++ )
+	// Disable Global Interrupts, if enabled, so a timeout in the ISR can't update the counters while they're copied
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
 	{
-		bool isLastByte = ( i == ( inDataLen - 1 )) ? true : false;
-		
-		status = _PlatformI2C_ReadByte( &outData[i], isLastByte );
-		require_noerr_quiet( status, exit );
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
 	}
 	
-	status = PlatformStatus_Success;
+	*outCounters = mPlatformI2CRecoveryCounters;
 	
+	status = PlatformStatus_Success;
 exit:
-	if ( startConditionSent )
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
 	{
-		_PlatformI2C_SendStopCondition();
+		PlatformInterrupt_EnableGlobalInterrupts();
 	}
 	return status;
 }
 
-static PlatformStatus _PlatformI2C_SendStartCondition( const bool isRepeatedStart )
+PlatformStatus PlatformI2C_EnableSlave( const PlatformI2CSlaveConfig_t *const inConfig )
 {
-	PlatformStatus status = PlatformStatus_Failed;
-		
-	// Clear any stop condition and send start condition // TODO does this need to be on different clock cycles?
-	TWCR = ( TWCR & ~( 1 << TWSTO )) | ( 1 << TWSTA ) | ( 1 << TWINT );
-		
-	// Wait for interrupt flag, indicating the start condition was sent
-	while ( !( TWCR & ( 1 << TWINT )));
-		
-	// Check the status of the start condition
-	if ( isRepeatedStart )
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( inConfig,                   exit );
+	require_quiet( inConfig->ownAddr <= 0x7F,  exit );
+	require_quiet( inConfig->registers,        exit );
+	require_quiet( inConfig->numRegisters,     exit );
+	
+	require_action_quiet( mPlatformI2CIsInitialized, exit, status = PlatformStatus_NotInitialized );
+	
+	// Disable Global Interrupts, if enabled, so the ISR doesn't see a partly copied configuration
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
 	{
-		require_quiet( GET_TWSR_STATUS_CODE() == TWSRStatus_RepeatedStartConditionTransmitted, exit );	
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
 	}
-	else
+	
+	mPlatformI2CSlave.config      = *inConfig;
+	mPlatformI2CSlave.isEnabled   = true;
+	mPlatformI2CSlave.isAddressed = false;
+	
+	TWAR = ( uint8_t )(( inConfig->ownAddr << 1 ) | ( inConfig->isGeneralCallEnabled ? ( 1 << TWGCE ) : 0 ));
+	
+	// Start acknowledging our address. While a master transaction is running, this is done when it completes.
+	if ( mPlatformI2CEngine.current == NULL )
 	{
-		require_quiet( GET_TWSR_STATUS_CODE() == TWSRStatus_StartConditionTransmitted, exit );
+		PLATFORM_I2C_WRITE_TWCR( _PlatformI2C_GetIdleTWCR() );
 	}
 	
 	status = PlatformStatus_Success;
 exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
 	return status;
 }
 
-static void _PlatformI2C_SendStopCondition( void )
+PlatformStatus PlatformI2C_DisableSlave( void )
 {
-	// Clear start condition, disable ACK, write stop condition, set interrupt flag to send stop condition
-	TWCR = ( TWCR & ~(( 1 << TWSTA ) | ( 1 << TWEA ))) | ( 1 << TWSTO ) | ( 1 << TWINT );
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( mPlatformI2CIsInitialized, exit );
+	
+	// Disable Global Interrupts, if enabled, so TWCR isn't changed underneath the ISR
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	mPlatformI2CSlave.isEnabled = false;
+	
+	// Clearing TWEA without touching TWINT stops acknowledging our address. While a master transaction is running, 
+	// TWEA is what ACKs the bytes it reads, so it is left to be cleared when the transaction completes.
+	if ( mPlatformI2CEngine.current == NULL )
+	{
+		PLATFORM_I2C_WRITE_TWCR( TWCR & ~(( 1 << TWEA ) | ( 1 << TWINT )) );
+	}
+	TWAR  = 0;
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
 }
 
-static PlatformStatus _PlatformI2C_SendSlaveAddressAndReadWriteBit( const uint8_t inDeviceAddr, const bool inReadWriteBit )
+#if PLATFORM_I2C_TRACE_ENABLED
+
+PlatformStatus PlatformI2C_GetTraceRecords( PlatformI2CTraceRecord_t *const outRecords, const uint8_t inMaxRecords, uint8_t *const outNumRecords )
 {
-	PlatformStatus status = PlatformStatus_Failed;
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	bool didDisableInterrupts = false;
+	uint8_t numRecords;
+	
+	require_quiet( outRecords,    exit );
+	require_quiet( outNumRecords, exit );
+	
+	// Disable Global Interrupts, if enabled, so records aren't added while they're copied
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
 	
-	// Set the device address and write/read bit (SLA+R/W)
-	TWDR = ( inDeviceAddr << 1 ) | inReadWriteBit;
+	numRecords = ( mPlatformI2CTrace.numRecords < inMaxRecords ) ? mPlatformI2CTrace.numRecords : inMaxRecords;
 	
-	// Clear any Start/Stop Condition and write the interrupt flag in order to send SLA+W
-	TWCR = ( TWCR & ~(( 1 << TWSTA ) | ( 1 << TWSTO ))) | ( 1 << TWINT );
+	for ( uint8_t i = 0; i < numRecords; i++ )
+	{
+		outRecords[ i ] = mPlatformI2CTrace.records[ ( uint8_t )( mPlatformI2CTrace.recordHead - numRecords + i ) & PLATFORM_I2C_TRACE_MASK ];
+	}
 	
-	// Wait for interrupt flag, indicating SLA+W was sent
-	while ( !( TWCR & ( 1 << TWINT )));
+	*outNumRecords = numRecords;
 	
-	// Check if ACK was received
-	if ( inReadWriteBit == PLATFORM_I2C_WRITE_BIT )
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
 	{
-		require_quiet( GET_TWSR_STATUS_CODE() == TWSRStatus_SLAW_ACKReceived, exit );
+		PlatformInterrupt_EnableGlobalInterrupts();
 	}
-	else 
+	return status;
+}
+
+PlatformStatus PlatformI2C_GetTraceSummary( PlatformI2CTraceSummary_t *const outSummary )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	bool didDisableInterrupts = false;
+	uint32_t currentTicks = 0;
+	
+	require_quiet( outSummary, exit );
+	
+	// Disable Global Interrupts, if enabled, so the statistics aren't updated while they're copied
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
 	{
-		require_quiet( GET_TWSR_STATUS_CODE() == TWSRStatus_SLAR_ACKReceived, exit );
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	*outSummary = mPlatformI2CTrace.summary;
+	
+	( void )PlatformTimer_GetTicks( &currentTicks );
+	outSummary->elapsedTicks        = currentTicks - mPlatformI2CTrace.resetTicks;
+	outSummary->utilizationPermille = 0;
+	
+	// Divide by a thousandth of the elapsed time rather than multiplying, which could overflow
+	if ( outSummary->elapsedTicks >= 1000 )
+	{
+		outSummary->utilizationPermille = ( uint16_t )( outSummary->busyTicks / ( outSummary->elapsedTicks / 1000 ));
+		if ( outSummary->utilizationPermille > 1000 )
+		{
+			outSummary->utilizationPermille = 1000;
+		}
 	}
 	
 	status = PlatformStatus_Success;
 exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
 	return status;
 }
 
-static inline PlatformStatus _PlatformI2C_SendRegisterAddress( const uint8_t inRegisterAddress )
+PlatformStatus PlatformI2C_ResetTrace( void )
+{
+	bool didDisableInterrupts = false;
+	
+	// Disable Global Interrupts, if enabled, so a transaction can't be recorded part way through
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	memset( &mPlatformI2CTrace, 0, sizeof( mPlatformI2CTrace ));
+	( void )PlatformTimer_GetTicks( &mPlatformI2CTrace.resetTicks );
+	
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return PlatformStatus_Success;
+}
+
+#else
+
+PlatformStatus PlatformI2C_GetTraceRecords( PlatformI2CTraceRecord_t *const outRecords, const uint8_t inMaxRecords, uint8_t *const outNumRecords )
 {
-	return _PlatformI2C_WriteByte( inRegisterAddress );
+	( void )outRecords;
+	( void )inMaxRecords;
+	( void )outNumRecords;
+	
+	return PlatformStatus_NotSupported;
 }
 
-static PlatformStatus _PlatformI2C_WriteByte( const uint8_t inDataByte )
+PlatformStatus PlatformI2C_GetTraceSummary( PlatformI2CTraceSummary_t *const outSummary )
 {
-	PlatformStatus status = PlatformStatus_Failed;
+	( void )outSummary;
+	
+	return PlatformStatus_NotSupported;
+}
+
+PlatformStatus PlatformI2C_ResetTrace( void )
+{
+	return PlatformStatus_NotSupported;
+}
+
+#endif
+
+bool PlatformI2C_IsBusy( void )
+{
+	return ( mPlatformI2CEngine.current != NULL );
+}
+
+PlatformStatus PlatformI2C_WriteByte( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, const uint8_t inDataByte )
+{
+	return PlatformI2C_Write( inDeviceAddr, inRegisterAddress, &inDataByte, 1 );
+}
+
+PlatformStatus PlatformI2C_Write( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, const uint8_t *const inData, const size_t inDataLen )
+{
+	PlatformI2CSegment_t segment = 
+	{
+		.direction          = PlatformI2CDirection_Write,
+		.registerAddress    = inRegisterAddress,
+		.registerAddressLen = 1,
+		.data               = ( uint8_t* )inData, // The engine never writes to the buffer of a write segment
+		.dataLen            = inDataLen,
+	};
 	
-	// Set the data to be sent
-	TWDR = inDataByte;
+	return PlatformI2C_Transfer( inDeviceAddr, &segment, 1 );
+}
+
+PlatformStatus PlatformI2C_Read( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, uint8_t *const outData, const size_t inDataLen )
+{
+	PlatformI2CSegment_t segment = 
+	{
+		.direction          = PlatformI2CDirection_Read,
+		.registerAddress    = inRegisterAddress,
+		.registerAddressLen = 1,
+		.data               = outData,
+		.dataLen            = inDataLen,
+	};
 	
-	// Clear any start/stop condition and write the interrupt flag in order to send the data
-	TWCR = ( TWCR & ~(( 1 << TWSTA ) | ( 1 << TWSTO ))) | ( 1 << TWINT );
+	return PlatformI2C_Transfer( inDeviceAddr, &segment, 1 );
+}
+
+PlatformStatus PlatformI2C_Probe( const uint8_t inDeviceAddr )
+{
+	// An empty write completes as soon as the address is acknowledged
+	PlatformI2CSegment_t segment = 
+	{
+		.direction          = PlatformI2CDirection_Write,
+		.registerAddressLen = 0,
+		.data               = NULL,
+		.dataLen            = 0,
+	};
 	
-	// Wait for interrupt flag, indicating the data was sent
-	while ( !( TWCR & ( 1 << TWINT )));
+	return PlatformI2C_Transfer( inDeviceAddr, &segment, 1 );
+}
+
+PlatformStatus PlatformI2C_Transfer( const uint8_t inDeviceAddr, const PlatformI2CSegment_t *const inSegments, const uint8_t inNumSegments )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	uint32_t numPolls = 0;
+	PlatformI2CTransaction_t transaction = 
+	{
+		.deviceAddr  = inDeviceAddr,
+		.segments    = inSegments,
+		.numSegments = inNumSegments,
+		.completeCb  = NULL,
+	};
 	
-	// Check if ACK was received
-	require_quiet( GET_TWSR_STATUS_CODE() == TWSRStatus_DataACKReceived, exit );
+	status = PlatformI2C_Submit( &transaction );
+	require_noerr_quiet( status, exit );
 	
-	status = PlatformStatus_Success;
+	while ( !transaction.isComplete )
+	{
+		if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+		{
+			// Completes the transaction with a timeout if the bus is stuck
+			( void )PlatformI2C_CheckTimeout();
+		}
+		// With global interrupts disabled the TWI ISR cannot run, so drive the engine from here. 
+		// PlatformTimer doesn't advance either, so the timeout is counted in fixed delays since the last bus event.
+		else if ( TWCR & ( 1 << TWINT ))
+		{
+			_PlatformI2C_HandleEvent();
+			numPolls = 0;
+		}
+		else if ( numPolls < PLATFORM_I2C_TIMEOUT_POLLS )
+		{
+			_delay_us( PLATFORM_I2C_POLL_INTERVAL_US );
+			numPolls++;
+		}
+		else
+		{
+			_PlatformI2C_TimeOutTransaction();
+			numPolls = 0;
+		}
+	}
+	
+	status = transaction.status;
 exit:
 	return status;
 }
 
-static PlatformStatus _PlatformI2C_ReadByte( uint8_t *const outDataByte, const bool isLastByteToRead )
+static bool _PlatformI2C_IsValidTransaction( const PlatformI2CTransaction_t *const inTransaction )
 {
-	PlatformStatus status = PlatformStatus_Failed;
+	bool isValid = false;
+	
+	require_quiet( inTransaction,              exit );
+	require_quiet( inTransaction->segments,    exit );
+	require_quiet( inTransaction->numSegments, exit );
+	
+	for ( uint8_t i = 0; i < inTransaction->numSegments; i++ )
+	{
+		const PlatformI2CSegment_t *const segment = &inTransaction->segments[ i ];
+		
+		require_quiet( segment->direction <= PlatformI2CDirection_Read, exit );
+		require_quiet( segment->registerAddressLen <= sizeof( segment->registerAddress ), exit );
+		require_quiet(( segment->dataLen == 0 ) || segment->data, exit );
 		
-	require_quiet( outDataByte, exit );
+		// The ACK for each read byte depends on whether another follows, so empty reads can't be chained
+		require_quiet(( segment->direction == PlatformI2CDirection_Write ) || segment->dataLen, exit );
+	}
 	
-	// If this is the last byte to read, set up the TWCR to send a NACK; otherwise send an ACK
-	if ( isLastByteToRead )
+	isValid = true;
+exit:
+	return isValid;
+}
+
+static void _PlatformI2C_BeginTransaction( PlatformI2CTransaction_t *const inTransaction )
+{
+	mPlatformI2CEngine.current      = inTransaction;
+	mPlatformI2CEngine.segmentIndex = 0;
+	( void )_PlatformI2C_PrepareSegment();
+	_PlatformI2C_MarkProgress();
+	
+#if PLATFORM_I2C_TRACE_ENABLED
+	mPlatformI2CEngine.startTicks = mPlatformI2CEngine.lastProgressTicks;
+#endif
+}
+
+// Sets up the engine for the segment at segmentIndex. Returns true if it must begin with a (repeated) START.
+static bool _PlatformI2C_PrepareSegment( void )
+{
+	PlatformI2CEngine_t *const        engine  = &mPlatformI2CEngine;
+	const PlatformI2CSegment_t *const segment = &engine->current->segments[ engine->segmentIndex ];
+	bool needsStart = true;
+	
+	engine->dataIndex     = 0;
+	engine->registerIndex = 0;
+	
+	if ( segment->registerAddressLen )
 	{
-		TWCR &= ~( 1 << TWEA );
+		engine->phase         = PlatformI2CPhase_RegisterAddress;
+		engine->isReadAddress = false;
 	}
 	else
 	{
-		TWCR |= ( 1 << TWEA );	
+		const bool isRead = ( segment->direction == PlatformI2CDirection_Read );
+		
+		// Carry on from the previous segment if the bus is already going the right way
+		needsStart            = ( engine->segmentIndex == 0 ) || ( isRead != engine->isReadAddress );
+		engine->phase         = isRead ? PlatformI2CPhase_ReadData : PlatformI2CPhase_WriteData;
+		engine->isReadAddress = isRead;
 	}
+	
+	return needsStart;
+}
+
+// Called once the slave has acknowledged SLA+W or a byte, to send the next register address or data byte
+static void _PlatformI2C_WriteNextByte( void )
+{
+	PlatformI2CEngine_t *const      engine      = &mPlatformI2CEngine;
+	PlatformI2CTransaction_t *const transaction = engine->current;
+	
+	// Loops over segments that continue the write, and have nothing to send
+	for ( ;; )
+	{
+		const PlatformI2CSegment_t *const segment = &transaction->segments[ engine->segmentIndex ];
 		
-	// Clear any start/stop condition and write the interrupt flag in order to receive data
-	TWCR = ( TWCR & ~(( 1 << TWSTA ) | ( 1 << TWSTO ))) | ( 1 << TWINT );
+		if ( engine->phase == PlatformI2CPhase_RegisterAddress )
+		{
+			if ( engine->registerIndex < segment->registerAddressLen )
+			{
+				// MSB first
+				TWDR = ( uint8_t )( segment->registerAddress >> ( 8 * ( segment->registerAddressLen - 1 - engine->registerIndex )));
+				engine->registerIndex++;
+				PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_CONTINUE );
+				return;
+			}
+			
+			if ( segment->direction == PlatformI2CDirection_Read )
+			{
+				// The register address was sent; send a repeated start to read from it
+				engine->phase         = PlatformI2CPhase_ReadData;
+				engine->isReadAddress = true;
+				PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_START );
+				return;
+			}
+			
+			engine->phase = PlatformI2CPhase_WriteData;
+		}
+		
+		if ( engine->dataIndex < segment->dataLen )
+		{
+			TWDR = segment->data[ engine->dataIndex ];
+			engine->dataIndex++;
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_CONTINUE );
+			return;
+		}
 		
-	// Wait for interrupt flag, indicating the data was sent
-	while ( !( TWCR & ( 1 << TWINT )));
+		// This segment is done
+		engine->segmentIndex++;
+		if ( engine->segmentIndex >= transaction->numSegments )
+		{
+			_PlatformI2C_CompleteTransaction( PlatformStatus_Success, true, GET_TWSR_STATUS_CODE() );
+			return;
+		}
+		
+		if ( _PlatformI2C_PrepareSegment() )
+		{
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_START );
+			return;
+		}
+	}
+}
+
+// Whether the byte about to be read is the last before a repeated START or STOP, which the slave must be told with a NACK
+static bool _PlatformI2C_IsLastReadByte( void )
+{
+	const PlatformI2CEngine_t *const     engine      = &mPlatformI2CEngine;
+	const PlatformI2CTransaction_t *const transaction = engine->current;
+	const PlatformI2CSegment_t *const     segment     = &transaction->segments[ engine->segmentIndex ];
+	const PlatformI2CSegment_t           *nextSegment;
+	
+	if ( engine->dataIndex < ( segment->dataLen - 1 ))
+	{
+		return false;
+	}
+	
+	if (( engine->segmentIndex + 1 ) >= transaction->numSegments )
+	{
+		return true;
+	}
+	
+	// The read continues into the next segment, matching _PlatformI2C_PrepareSegment()
+	nextSegment = &transaction->segments[ engine->segmentIndex + 1 ];
+	return ( nextSegment->registerAddressLen || ( nextSegment->direction != PlatformI2CDirection_Read ));
+}
+
+static void _PlatformI2C_HandleEvent( void )
+{
+	PlatformI2CEngine_t *const      engine      = &mPlatformI2CEngine;
+	PlatformI2CTransaction_t *const transaction = engine->current;
+	const uint8_t                   twsrStatus  = GET_TWSR_STATUS_CODE();
+	
+	if (( twsrStatus >= TWSRStatus_SlaveFirst ) && ( twsrStatus <= TWSRStatus_SlaveLast ))
+	{
+		_PlatformI2C_HandleSlaveEvent( twsrStatus );
+		return;
+	}
+	
+	// A bus error ends any slave transfer, and the TWI only recovers from it once TWSTO is written.
+	// A master transaction is failed with a STOP below.
+	if ( twsrStatus == TWSRStatus_BusError )
+	{
+		mPlatformI2CSlave.isAddressed = false;
 		
-	// Check if data was received successfully
-	if ( isLastByteToRead )
+		if ( transaction == NULL )
+		{
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_STOP | _PlatformI2C_GetIdleTWCR() );
+			return;
+		}
+	}
+	
+	// Nothing in progress; just clear the flag
+	if ( transaction == NULL )
+	{
+		PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_CONTINUE | _PlatformI2C_GetIdleTWCR() );
+		return;
+	}
+	
+	_PlatformI2C_MarkProgress();
+	
+	switch ( twsrStatus )
+	{
+		case TWSRStatus_StartConditionTransmitted:
+		case TWSRStatus_RepeatedStartConditionTransmitted:
+		{
+			// Send SLA+W to write a register address or data, or SLA+R to read
+			TWDR = ( transaction->deviceAddr << 1 ) | ( engine->isReadAddress ? PLATFORM_I2C_READ_BIT : PLATFORM_I2C_WRITE_BIT );
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_CONTINUE );
+			break;
+		}
+		case TWSRStatus_SLAW_ACKReceived:
+		case TWSRStatus_DataACKReceived:
+		{
+			_PlatformI2C_WriteNextByte();
+			break;
+		}
+		case TWSRStatus_SLAR_ACKReceived:
+		{
+			// ACK every byte but the last, so the slave knows when to release the bus
+			PLATFORM_I2C_WRITE_TWCR( _PlatformI2C_IsLastReadByte() ? PLATFORM_I2C_TWCR_CONTINUE : PLATFORM_I2C_TWCR_ACK );
+			break;
+		}
+		case TWSRStatus_DataReceivedAndACKSent:
+		case TWSRStatus_DataReceivedAndNACKSent:
+		{
+			transaction->segments[ engine->segmentIndex ].data[ engine->dataIndex ] = TWDR;
+			engine->dataIndex++;
+			
+			if ( engine->dataIndex >= transaction->segments[ engine->segmentIndex ].dataLen )
+			{
+				// This segment is done. After an ACK the next one continues the read; after a NACK it needs a START, or this was the last.
+				engine->segmentIndex++;
+				if ( engine->segmentIndex >= transaction->numSegments )
+				{
+					_PlatformI2C_CompleteTransaction( PlatformStatus_Success, true, twsrStatus );
+					break;
+				}
+				
+				if ( _PlatformI2C_PrepareSegment() )
+				{
+					PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_START );
+					break;
+				}
+			}
+			
+			PLATFORM_I2C_WRITE_TWCR( _PlatformI2C_IsLastReadByte() ? PLATFORM_I2C_TWCR_CONTINUE : PLATFORM_I2C_TWCR_ACK );
+			break;
+		}
+		case TWSRStatus_ArbitrationLost:
+		{
+			// Another master has the bus; release it without a STOP
+			_PlatformI2C_CompleteTransaction( PlatformStatus_Failed, false, twsrStatus );
+			break;
+		}
+		case TWSRStatus_SLAW_NACKReceived:
+		case TWSRStatus_DataNACKReceived:
+		case TWSRStatus_SLAR_NACKReceived:
+		case TWSRStatus_BusError:
+		default:
+		{
+			_PlatformI2C_CompleteTransaction( PlatformStatus_Failed, true, twsrStatus );
+			break;
+		}
+	}
+}
+
+static void _PlatformI2C_CompleteTransaction( const PlatformStatus inStatus, const bool inSendStop, const uint8_t inTWSRStatus )
+{
+	PlatformI2CEngine_t *const      engine      = &mPlatformI2CEngine;
+	PlatformI2CTransaction_t *const transaction = engine->current;
+	
+#if PLATFORM_I2C_TRACE_ENABLED
+	// Before the next transaction takes over the start time
+	_PlatformI2C_TraceTransaction( transaction, inStatus, inTWSRStatus );
+#else
+	( void )inTWSRStatus;
+#endif
+	
+	// Start the next queued transaction, if any, before calling back so the bus is kept busy
+	if ( engine->queueHead != engine->queueTail )
 	{
-		require_quiet( GET_TWSR_STATUS_CODE() == TWSRStatus_DataReceivedAndNACKSent, exit );
+		_PlatformI2C_BeginTransaction( engine->queue[ engine->queueTail & PLATFORM_I2C_QUEUE_MASK ] );
+		engine->queueTail++;
+		
+		// With both set, the TWI sends a STOP followed by a START
+		PLATFORM_I2C_WRITE_TWCR( inSendStop ? PLATFORM_I2C_TWCR_STOP_START : PLATFORM_I2C_TWCR_START );
 	}
 	else
 	{
-		require_quiet( GET_TWSR_STATUS_CODE() == TWSRStatus_DataReceivedAndACKSent, exit );
+		engine->current = NULL;
+		
+		PLATFORM_I2C_WRITE_TWCR( ( inSendStop ? PLATFORM_I2C_TWCR_STOP : PLATFORM_I2C_TWCR_CONTINUE ) | _PlatformI2C_GetIdleTWCR() );
+	}
+	
+	transaction->status     = inStatus;
+	transaction->isComplete = true;
+	
+	// Callback, if it exists
+	if ( transaction->completeCb )
+	{
+		transaction->completeCb( transaction, inStatus );
 	}
+}
+
+static void _PlatformI2C_HandleSlaveEvent( const uint8_t inTWSRStatus )
+{
+	PlatformI2CSlave_t *const             slave  = &mPlatformI2CSlave;
+	const PlatformI2CSlaveConfig_t *const config = &slave->config;
+	PlatformI2CEngine_t *const            engine = &mPlatformI2CEngine;
 	
-	// Get read data
-	*outDataByte = TWDR;
+	// A master transaction waiting for the bus shouldn't time out while the host is using it
+	if ( engine->current )
+	{
+		_PlatformI2C_MarkProgress();
+	}
+	
+	switch ( inTWSRStatus )
+	{
+		case TWSRStatus_ArbitrationLostOwnSLAW:
+		case TWSRStatus_ArbitrationLostGeneralCall:
+		{
+			// Our transaction lost the bus while still sending the address, so nothing was transferred; start it over once the host is done
+			if ( engine->current )
+			{
+				_PlatformI2C_BeginTransaction( engine->current );
+			}
+		}
+		// Fall through
+		case TWSRStatus_OwnSLAW_ACKSent:
+		case TWSRStatus_GeneralCall_ACKSent:
+		{
+			slave->isAddressed       = true;
+			slave->isPointerReceived = false;
+			slave->isGeneralCall     = ( inTWSRStatus == TWSRStatus_GeneralCall_ACKSent ) || ( inTWSRStatus == TWSRStatus_ArbitrationLostGeneralCall );
+			
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_ACK );
+			break;
+		}
+		case TWSRStatus_SlaveDataReceivedAndACKSent:
+		case TWSRStatus_GCDataReceivedAndACKSent:
+		{
+			const uint8_t data = TWDR;
+			
+			if ( !slave->isPointerReceived )
+			{
+				slave->registerPointer      = data;
+				slave->firstWrittenRegister = data;
+				slave->isPointerReceived    = true;
+			}
+			else if ( slave->registerPointer < config->numRegisters )
+			{
+				// Read-only registers are skipped over, so a block write can span them
+				if (( config->writableMask == NULL ) || ( config->writableMask[ slave->registerPointer / 8 ] & ( 1 << ( slave->registerPointer % 8 ))))
+				{
+					config->registers[ slave->registerPointer ] = data;
+				}
+				slave->registerPointer++;
+			}
+			
+			// Don't acknowledge bytes past the end of the map
+			PLATFORM_I2C_WRITE_TWCR( ( slave->registerPointer < config->numRegisters ) ? PLATFORM_I2C_TWCR_ACK : PLATFORM_I2C_TWCR_CONTINUE );
+			break;
+		}
+		case TWSRStatus_SlaveDataReceivedAndNACKSent:
+		case TWSRStatus_GCDataReceivedAndNACKSent:
+		case TWSRStatus_StopOrRepeatedStartReceived:
+		{
+			_PlatformI2C_FinishSlaveWrite();
+			
+			// Start a master transaction held off by the host, once the bus is free
+			slave->isAddressed = false;
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_CONTINUE | _PlatformI2C_GetIdleTWCR() | ( engine->current ? ( 1 << TWSTA ) : 0 ) );
+			break;
+		}
+		case TWSRStatus_ArbitrationLostOwnSLAR:
+		{
+			// As above, start our transaction over once the host is done
+			if ( engine->current )
+			{
+				_PlatformI2C_BeginTransaction( engine->current );
+			}
+		}
+		// Fall through
+		case TWSRStatus_OwnSLAR_ACKSent:
+		case TWSRStatus_SlaveDataSentAndACKReceived:
+		{
+			slave->isAddressed = true;
+			
+			if ( slave->registerPointer < config->numRegisters )
+			{
+				TWDR = config->registers[ slave->registerPointer ];
+				slave->registerPointer++;
+			}
+			else
+			{
+				TWDR = 0xFF;
+			}
+			
+			// Keep sending until the host stops acknowledging
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_ACK );
+			break;
+		}
+		case TWSRStatus_SlaveDataSentAndNACKReceived:
+		case TWSRStatus_SlaveLastDataSent:
+		default:
+		{
+			slave->isAddressed = false;
+			PLATFORM_I2C_WRITE_TWCR( PLATFORM_I2C_TWCR_CONTINUE | _PlatformI2C_GetIdleTWCR() | ( engine->current ? ( 1 << TWSTA ) : 0 ) );
+			break;
+		}
+	}
+}
+
+static void _PlatformI2C_FinishSlaveWrite( void )
+{
+	PlatformI2CSlave_t *const slave = &mPlatformI2CSlave;
+	
+	// Only call back if data followed the register pointer; a pointer alone just sets up a read
+	if ( slave->isPointerReceived && ( slave->registerPointer != slave->firstWrittenRegister ) && slave->config.writeCompleteCb )
+	{
+		slave->config.writeCompleteCb( slave->firstWrittenRegister, slave->registerPointer - slave->firstWrittenRegister, slave->isGeneralCall );
+	}
+	
+	slave->isPointerReceived = false;
+}
+
+// TWCR value when no master transaction is running: acknowledge our own address if the slave is enabled
+static inline uint8_t _PlatformI2C_GetIdleTWCR( void )
+{
+	return PLATFORM_I2C_TWCR_IDLE | ( mPlatformI2CSlave.isEnabled ? ( 1 << TWEA ) : 0 );
+}
+
+#if PLATFORM_I2C_TRACE_ENABLED
+static void _PlatformI2C_TraceTransaction( const PlatformI2CTransaction_t *const inTransaction, const PlatformStatus inStatus, const uint8_t inTWSRStatus )
+{
+	PlatformI2CTrace_t *const       trace  = &mPlatformI2CTrace;
+	PlatformI2CTraceRecord_t *const record = &trace->records[ trace->recordHead & PLATFORM_I2C_TRACE_MASK ];
+	PlatformI2CTraceDeviceStats_t  *device = NULL;
+	uint32_t currentTicks = 0;
+	
+	( void )PlatformTimer_GetTicks( &currentTicks );
+	
+	record->startTicks      = mPlatformI2CEngine.startTicks;
+	record->durationTicks   = currentTicks - mPlatformI2CEngine.startTicks;
+	record->deviceAddr      = inTransaction->deviceAddr;
+	record->registerAddress = inTransaction->segments[ 0 ].registerAddressLen ? inTransaction->segments[ 0 ].registerAddress : 0;
+	record->dataLen         = 0;
+	record->twsrStatus      = inTWSRStatus;
+	record->wasNACKed       = ( record->twsrStatus == TWSRStatus_SLAW_NACKReceived ) || 
+	                          ( record->twsrStatus == TWSRStatus_DataNACKReceived ) || 
+	                          ( record->twsrStatus == TWSRStatus_SLAR_NACKReceived );
+	record->status          = inStatus;
+	
+	for ( uint8_t i = 0; i < inTransaction->numSegments; i++ )
+	{
+		record->dataLen += inTransaction->segments[ i ].dataLen;
+	}
+	
+	trace->recordHead++;
+	if ( trace->numRecords < PLATFORM_I2C_TRACE_SIZE )
+	{
+		trace->numRecords++;
+	}
+	
+	trace->summary.busyTicks += record->durationTicks;
+	trace->summary.numTransactions++;
+	
+	// Find this device's statistics, adding it if there's room
+	for ( uint8_t i = 0; i < trace->summary.numDevices; i++ )
+	{
+		if ( trace->summary.devices[ i ].deviceAddr == record->deviceAddr )
+		{
+			device = &trace->summary.devices[ i ];
+			break;
+		}
+	}
+	
+	if (( device == NULL ) && ( trace->summary.numDevices < PLATFORM_I2C_TRACE_MAX_DEVICES ))
+	{
+		device = &trace->summary.devices[ trace->summary.numDevices ];
+		device->deviceAddr = record->deviceAddr;
+		trace->summary.numDevices++;
+	}
+	
+	if ( device )
+	{
+		device->numTransactions++;
+		device->numNACKs   += record->wasNACKed ? 1 : 0;
+		device->totalTicks += record->durationTicks;
+		if ( record->durationTicks > device->maxTicks )
+		{
+			device->maxTicks = record->durationTicks;
+		}
+	}
+}
+#endif
+
+static inline void _PlatformI2C_MarkProgress( void )
+{
+	// PlatformI2C_Init() checked that PlatformTimer is running
+	( void )PlatformTimer_GetTicks( &mPlatformI2CEngine.lastProgressTicks );
+}
+
+static bool _PlatformI2C_HasTimedOut( void )
+{
+	uint32_t currentTicks;
+	
+	// Unsigned subtraction is valid across the tick count wrapping
+	return ( PlatformTimer_GetTicks( &currentTicks ) == PlatformStatus_Success ) && 
+	       (( currentTicks - mPlatformI2CEngine.lastProgressTicks ) > PLATFORM_I2C_TIMEOUT_TICKS );
+}
+
+static PlatformStatus _PlatformI2C_WaitForStop( void )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	uint32_t numPolls = 0;
+	
+	// The STOP can be held off indefinitely by a slave stretching SCL. 
+	// This runs with global interrupts disabled, so count fixed delays rather than PlatformTimer ticks.
+	while (( TWCR & ( 1 << TWSTO )) && ( numPolls < PLATFORM_I2C_TIMEOUT_POLLS ))
+	{
+		_delay_us( PLATFORM_I2C_POLL_INTERVAL_US );
+		numPolls++;
+	}
+	
+	if ( TWCR & ( 1 << TWSTO ))
+	{
+		mPlatformI2CRecoveryCounters.numTimeouts++;
+		( void )_PlatformI2C_RecoverBus();
 		
-	status = PlatformStatus_Success;
-exit:
+		status = PlatformStatus_Timeout;
+	}
+	else
+	{
+		status = PlatformStatus_Success;
+	}
+	
 	return status;
 }
 
-static PlatformStatus _PlatformI2C_GetClockPrescalerBitsAndBitRateValues( uint32_t inCPUFreq, uint8_t *const outPrescalerBits, uint8_t *const outBitRateVal )
+static void _PlatformI2C_TimeOutTransaction( void )
+{
+	// The recovery disables the TWI, which resets TWSR; keep the status the transaction was stuck on for the trace
+	const uint8_t twsrStatus = GET_TWSR_STATUS_CODE();
+	
+	mPlatformI2CRecoveryCounters.numTimeouts++;
+	
+	( void )_PlatformI2C_RecoverBus();
+	
+	// The recovery already generated a STOP; move on to the next transaction
+	_PlatformI2C_CompleteTransaction( PlatformStatus_Timeout, false, twsrStatus );
+}
+
+static PlatformStatus _PlatformI2C_RecoverBus( void )
 {
 	PlatformStatus status = PlatformStatus_Failed;
+	bool isSDAHigh = false;
 	
-	uint32_t currentPrescalerUpperSpeed;
-	uint32_t currentPrescalerLowerSpeed;
-	uint8_t  prescalerIndex = 0;
+	// Releasing a line as a high-Z input turns its internal pull-up off, so note which ones the board relies on
+	const uint8_t pullUps = PORTC & ( PLATFORM_GPIO_PIN_MASK( PLATFORM_I2C_SCL_GPIO ) | PLATFORM_GPIO_PIN_MASK( PLATFORM_I2C_SDA_GPIO ));
 	
-	bool prescalerFound = false;
+	mPlatformI2CRecoveryCounters.numRecoveries++;
 	
-	require_quiet( outPrescalerBits,  exit );
-	require_quiet( outBitRateVal, exit );
+	// Take the pins back from the TWI. 
+	PLATFORM_I2C_WRITE_TWCR( 0 );
 	
-	for ( uint8_t prescalerIndex = 0; prescalerIndex < sizeof( kPlatformI2CBitRatePrescalers ); prescalerIndex++ )
+	// The lines are open drain: release a line by making it a high-Z input so the pull-up takes it high,
+	// and pull it low by making it an output, which drives low since PORT is cleared for a high-Z input.
+	PlatformGPIO_Configure( PLATFORM_I2C_SCL_GPIO, PlatformGPIOConfig_InputHighZ );
+	PlatformGPIO_Configure( PLATFORM_I2C_SDA_GPIO, PlatformGPIOConfig_InputHighZ );
+	_delay_us( PLATFORM_I2C_RECOVERY_HALF_PERIOD_US );
+	
+	// Clock SCL until the slave has shifted out the rest of its byte and releases SDA
+	for ( uint8_t i = 0; i < PLATFORM_I2C_RECOVERY_MAX_CLOCKS; i++ )
 	{
-		// The below formula is taken from Section 21.5.2 of the ATmega328p datasheet
-		currentPrescalerUpperSpeed = inCPUFreq / ( 16 + ( 2 * PLATFORM_I2C_TWBR_MIN * kPlatformI2CBitRatePrescalers[ prescalerIndex ] ));
-		currentPrescalerLowerSpeed = inCPUFreq / ( 16 + ( 2 * PLATFORM_I2C_TWBR_MAX * kPlatformI2CBitRatePrescalers[ prescalerIndex ] ));
-		
-		// If the current prescaler can accomodate the 400kHz of fast mode, break and use it
-		if (( currentPrescalerUpperSpeed >= PLATFORM_I2C_FAST_MODE_HZ ) || ( PLATFORM_I2C_FAST_MODE_HZ >= currentPrescalerLowerSpeed ))
+		PlatformGPIO_GetInput( PLATFORM_I2C_SDA_GPIO, &isSDAHigh );
+		if ( isSDAHigh )
 		{
-			prescalerFound = true;
 			break;
 		}
+		
+		PlatformGPIO_Configure( PLATFORM_I2C_SCL_GPIO, PlatformGPIOConfig_Output );
+		_delay_us( PLATFORM_I2C_RECOVERY_HALF_PERIOD_US );
+		PlatformGPIO_Configure( PLATFORM_I2C_SCL_GPIO, PlatformGPIOConfig_InputHighZ );
+		_delay_us( PLATFORM_I2C_RECOVERY_HALF_PERIOD_US );
 	}
 	
-	require_quiet( prescalerFound, exit );
+	// Generate a STOP: SDA rises while SCL is high. Pull SCL low first so pulling SDA low is not seen as a START.
+	PlatformGPIO_Configure( PLATFORM_I2C_SCL_GPIO, PlatformGPIOConfig_Output );
+	PlatformGPIO_Configure( PLATFORM_I2C_SDA_GPIO, PlatformGPIOConfig_Output );
+	_delay_us( PLATFORM_I2C_RECOVERY_HALF_PERIOD_US );
+	PlatformGPIO_Configure( PLATFORM_I2C_SCL_GPIO, PlatformGPIOConfig_InputHighZ );
+	_delay_us( PLATFORM_I2C_RECOVERY_HALF_PERIOD_US );
+	PlatformGPIO_Configure( PLATFORM_I2C_SDA_GPIO, PlatformGPIOConfig_InputHighZ );
+	_delay_us( PLATFORM_I2C_RECOVERY_HALF_PERIOD_US );
+	
+	PlatformGPIO_GetInput( PLATFORM_I2C_SDA_GPIO, &isSDAHigh );
+	
+	// Turn the internal pull-ups back on. The TWI leaves them as it finds them.
+	if ( pullUps & PLATFORM_GPIO_PIN_MASK( PLATFORM_I2C_SCL_GPIO ))
+	{
+		PlatformGPIO_Configure( PLATFORM_I2C_SCL_GPIO, PlatformGPIOConfig_InputPullUp );
+	}
+	if ( pullUps & PLATFORM_GPIO_PIN_MASK( PLATFORM_I2C_SDA_GPIO ))
+	{
+		PlatformGPIO_Configure( PLATFORM_I2C_SDA_GPIO, PlatformGPIOConfig_InputPullUp );
+	}
 	
-	// Set the returned prescaler bits as the index 0-3 into the array kPlatformI2CBitRatePrescalers
-	*outPrescalerBits = prescalerIndex;
+	// Give the pins back to the TWI. The bit rate and prescaler are kept while it is disabled.
+	mPlatformI2CSlave.isAddressed = false;
+	PLATFORM_I2C_WRITE_TWCR( _PlatformI2C_GetIdleTWCR() );
 	
-	// The below formula is rearranged from Section 21.5.2 from the Atmega328p datasheet
-	*outBitRateVal    = (( inCPUFreq / PLATFORM_I2C_FAST_MODE_HZ ) - 16 ) / ( 2 * kPlatformI2CBitRatePrescalers[ prescalerIndex ] );
+	require_action_quiet( isSDAHigh, exit, mPlatformI2CRecoveryCounters.numFailedRecoveries++ );
 	
 	status = PlatformStatus_Success;
 exit:
 	return status;
+}
+
+ISR( TWI_vect )
+{
+	_PlatformI2C_HandleEvent();
 }
\ No newline at end of file
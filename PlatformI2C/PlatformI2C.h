@@ -12,18 +12,283 @@
 #include "PlatformStatus.h"
 #include <stdint.h>
 #include <stddef.h>
+#include <stdbool.h>
+
+#define PLATFORM_I2C_STANDARD_MODE_HZ ( 100000UL )
+#define PLATFORM_I2C_FAST_MODE_HZ     ( 400000UL )
+#define PLATFORM_I2C_FASTEST_HZ       ( UINT32_MAX ) // As fast as the CPU clock allows, F_CPU / 16. Only for slaves that tolerate it.
+
+// Maximum number of transactions waiting behind the one in progress
+#define PLATFORM_I2C_QUEUE_SIZE ( 8 )
+
+// A transaction that makes no progress on the bus for this long is aborted, and the bus is recovered
+#ifndef PLATFORM_I2C_TIMEOUT_MS
+#define PLATFORM_I2C_TIMEOUT_MS ( 10 )
+#endif
+
+// Set to 1 to record each transaction, for PlatformI2C_GetTraceRecords() and PlatformI2C_GetTraceSummary()
+#ifndef PLATFORM_I2C_TRACE_ENABLED
+#define PLATFORM_I2C_TRACE_ENABLED ( 0 )
+#endif
+
+// Number of the most recent transactions kept by tracing
+#ifndef PLATFORM_I2C_TRACE_SIZE
+#define PLATFORM_I2C_TRACE_SIZE ( 8 )
+#endif
+
+// Number of devices tracing keeps statistics for; transactions with further devices only count towards bus utilization
+#ifndef PLATFORM_I2C_TRACE_MAX_DEVICES
+#define PLATFORM_I2C_TRACE_MAX_DEVICES ( 4 )
+#endif
+
+typedef struct
+{
+	uint16_t numTimeouts;         // Transactions aborted because the bus stopped making progress
+	uint16_t numRecoveries;       // Bus recoveries performed, after a timeout or by PlatformI2C_RecoverBus()
+	uint16_t numFailedRecoveries; // Recoveries after which SDA was still held low
+} PlatformI2CRecoveryCounters_t;
+
+typedef struct
+{
+	uint32_t       startTicks;      // PlatformTimer ticks when the transaction started
+	uint32_t       durationTicks;   // Ticks from the start to completion, including any wait for the bus
+	uint16_t       registerAddress; // Register address of the first segment, if it has one
+	uint16_t       dataLen;         // Data bytes over all segments
+	uint8_t        deviceAddr;
+	uint8_t        twsrStatus;      // TWSR status code of the last bus event
+	bool           wasNACKed;       // The device did not acknowledge its address or a byte
+	PlatformStatus status;
+} PlatformI2CTraceRecord_t;
+
+typedef struct
+{
+	uint8_t  deviceAddr;
+	uint16_t numTransactions;
+	uint16_t numNACKs;
+	uint32_t totalTicks;            // Sum of the transaction durations, for the average latency
+	uint32_t maxTicks;              // Longest transaction
+} PlatformI2CTraceDeviceStats_t;
+
+typedef struct
+{
+	uint32_t                      elapsedTicks;         // Since tracing was last reset
+	uint32_t                      busyTicks;            // Of elapsedTicks, time with a transaction in progress
+	uint16_t                      utilizationPermille;  // busyTicks / elapsedTicks, in 0.1%
+	uint16_t                      numTransactions;
+	uint8_t                       numDevices;
+	PlatformI2CTraceDeviceStats_t devices[ PLATFORM_I2C_TRACE_MAX_DEVICES ];
+} PlatformI2CTraceSummary_t;
+
+typedef enum
+{
+	PlatformI2CDirection_Write,
+	PlatformI2CDirection_Read,
+} PlatformI2CDirection_t;
+
+/*!
+ *\brief    One part of a transaction: an optional register address, then data in one direction.
+ *
+ *\details  The first segment starts with START and SLA+R/W. A later segment continues where the previous one left off,
+ *          with no START, when it has no register address and the same direction; this gathers writes from several buffers,
+ *          or scatters one read into several. Otherwise it begins with a repeated START.
+ *          A register address is always written after a (repeated) START and SLA+W; a read segment then sends another repeated START and SLA+R.
+ *          A write segment may have no data, e.g. to only set a register pointer, or to check that a device acknowledges its address.
+ */
+typedef struct
+{
+	PlatformI2CDirection_t direction;
+	uint16_t               registerAddress;
+	uint8_t                registerAddressLen; // 0 for none, 1 for an 8-bit or 2 for a 16-bit register address. 16-bit addresses are sent MSB first.
+	uint8_t               *data;               // Not written to for a write segment
+	size_t                 dataLen;            // Must not be 0 for a read segment
+} PlatformI2CSegment_t;
+
+typedef struct PlatformI2CTransaction PlatformI2CTransaction_t;
+
+/*!
+ *\brief    Transaction complete callback; called from the TWI ISR when a transaction finishes, so it should be kept short.
+ *          The next queued transaction has already been started. The transaction may be submitted again from the callback.
+ *
+ *\param    inTransaction - Transaction that finished. Its status is also stored in inTransaction->status.
+ *\param    inStatus      - PlatformStatus_Success if every byte was acknowledged as expected,
+ *                          PlatformStatus_Timeout if the bus stopped making progress, PlatformStatus_Failed otherwise.
+ */
+typedef void ( *PlatformI2C_TransactionCompleteCb )( PlatformI2CTransaction_t *const inTransaction, const PlatformStatus inStatus );
 
 /*!
- *\brief    Initializes I2C as fast mode (400kHz). 
+ *\brief    I2C transaction descriptor. The caller owns the memory, including the segments, which must stay valid until the transaction completes.
+ *
+ *\details  The segments run in order between a single START and STOP, e.g. writing several registers of a device,
+ *          or writing a 16-bit EEPROM address then reading from it. If any byte is not acknowledged as expected, the rest are skipped.
+ */
+struct PlatformI2CTransaction
+{
+	// Set by the caller
+	uint8_t                           deviceAddr;
+	const PlatformI2CSegment_t       *segments;
+	uint8_t                           numSegments;
+	PlatformI2C_TransactionCompleteCb completeCb; // May be NULL
+	void                             *context;    // For the caller's use; not touched by PlatformI2C
+	
+	// Set by PlatformI2C
+	volatile PlatformStatus           status;
+	volatile bool                     isComplete;
+};
+
+/*!
+ *\brief    Slave write complete callback; called from the TWI ISR once the host has finished writing registers, so it should be kept short.
+ *
+ *\param    inFirstRegister - First register written.
+ *\param    inNumRegisters  - Number of consecutive registers the host wrote. Read-only registers among them were left unchanged.
+ *\param    inIsGeneralCall - true if the host wrote to the general call address rather than the own address.
+ */
+typedef void ( *PlatformI2C_SlaveWriteCompleteCb )( const uint8_t inFirstRegister, const uint8_t inNumRegisters, const bool inIsGeneralCall );
+
+/*!
+ *\brief    Slave mode configuration. The host sees the register map as a device with 8-bit register addresses that auto-increment.
+ *
+ *\details  A host write starts with the register pointer, followed by data for consecutive registers. Bytes past the end of the map are not acknowledged.
+ *          A host read returns consecutive registers from the pointer, then 0xFF past the end of the map.
+ *          The map is read and written from the TWI ISR a byte at a time, so disable global interrupts to change multi-byte values consistently.
+ */
+typedef struct
+{
+	uint8_t                          ownAddr;              // 7-bit address to respond to
+	bool                             isGeneralCallEnabled; // Also accept writes to the general call address, 0
+	uint8_t                         *registers;            // Register map, owned by the caller
+	uint8_t                          numRegisters;
+	const uint8_t                   *writableMask;         // One bit per register, LSB of the first byte first, set if the host may write it. NULL if every register is writable.
+	PlatformI2C_SlaveWriteCompleteCb writeCompleteCb;      // May be NULL
+} PlatformI2CSlaveConfig_t;
+
+/*!
+ *\brief    Initializes I2C with the fastest SCL frequency that does not exceed a target. 
  *
  *\details  This function will enable power to the I2C peripheral block and any necessary configurations.
  *          This will also override previous configurations on the SDA/SCL pins.
+ *          PlatformTimer must be initialized first, since bus timeouts are measured with it.
+ *
+ *\param    inTargetSCLHz          - Maximum SCL frequency, e.g. PLATFORM_I2C_STANDARD_MODE_HZ, PLATFORM_I2C_FAST_MODE_HZ or PLATFORM_I2C_FASTEST_HZ.
+ *\param    outOptionalActualSCLHz - Optional pointer to store the SCL frequency achieved, before any slowdown from the bus rise time. May be NULL.
  *
  *\return   PlatformStatus - PlatformStatus_Success if successfully initialized. 
  *                         - PlatformStatus_AlreadyInitialized if I2C has already been initialized.
+ *                         - PlatformStatus_NotInitialized if PlatformTimer has not been initialized.
+ *                         - PlatformStatus_InvalidArgument if the target is slower than the clock can divide down to.
  *                         - PlatformStatus_Failed if anything else failed.
  */
-PlatformStatus PlatformI2C_Init( void );
+PlatformStatus PlatformI2C_Init( const uint32_t inTargetSCLHz, uint32_t *const outOptionalActualSCLHz );
+
+/*!
+ *\brief    Queues a transaction to run in the background, driven by the TWI interrupt.
+ *
+ *\details  The transaction starts immediately if the bus is idle, otherwise after the transactions queued before it. 
+ *          Completion is signalled by inTransaction->isComplete and the optional callback. Global interrupts must be enabled for it to progress.
+ *
+ *\param    inTransaction - Transaction to run. Must not already be queued or in progress.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success if the transaction was queued.
+ *                         - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+ *                         - PlatformStatus_InvalidArgument if the transaction is invalid.
+ *                         - PlatformStatus_Failed if the queue is full.
+ */
+PlatformStatus PlatformI2C_Submit( PlatformI2CTransaction_t *const inTransaction );
+
+/*!
+ *\brief    Aborts the transaction in progress if the bus has made no progress for PLATFORM_I2C_TIMEOUT_MS, and recovers the bus.
+ *
+ *\details  The blocking functions call this while they wait. When only using PlatformI2C_Submit(), call it periodically from the main loop.
+ *          The aborted transaction completes with PlatformStatus_Timeout, and the next queued transaction is started.
+ *          Timeouts are measured with PlatformTimer, so global interrupts must be enabled for this to time out. 
+ *          The blocking functions below time out on their own when called with global interrupts disabled.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success if no transaction timed out.
+ *                         - PlatformStatus_Timeout if a transaction was aborted.
+ *                         - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+ */
+PlatformStatus PlatformI2C_CheckTimeout( void );
+
+/*!
+ *\brief    Frees a bus held by a slave, e.g. one that was reset part way through sending a byte and is holding SDA low.
+ *
+ *\details  The TWI is disabled and SCL is clocked up to 9 times through PlatformGPIO until the slave releases SDA, 
+ *          then a STOP is generated and the TWI is enabled again. SCL is PC5 and SDA is PC4, which need external pull-ups.
+ *          This is done automatically when a transaction times out. Must not be called while a transaction is in progress.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success if SDA was released.
+ *                         - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+ *                         - PlatformStatus_Failed if a transaction is in progress, or SDA is still held low.
+ */
+PlatformStatus PlatformI2C_RecoverBus( void );
+
+/*!
+ *\brief    Gets the bus fault counters since initialization.
+ *
+ *\param    outCounters - Pointer to store the counters.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if outCounters is NULL.
+ */
+PlatformStatus PlatformI2C_GetRecoveryCounters( PlatformI2CRecoveryCounters_t *const outCounters );
+
+/*!
+ *\brief    Starts responding to a host as a slave, serving a register map entirely from the TWI ISR.
+ *
+ *\details  Master transactions can still be submitted; one that is held off while the host is using the bus starts once the host is done.
+ *
+ *\param    inConfig - Slave configuration, which is copied. The register map and writable mask must stay valid until the slave is disabled.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success if the slave was enabled.
+ *                         - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+ *                         - PlatformStatus_InvalidArgument if the configuration is invalid.
+ */
+PlatformStatus PlatformI2C_EnableSlave( const PlatformI2CSlaveConfig_t *const inConfig );
+
+/*!
+ *\brief    Stops responding to a host. A transfer with the host in progress is not acknowledged past the current byte.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if I2C has not yet been initialized.
+ */
+PlatformStatus PlatformI2C_DisableSlave( void );
+
+/*!
+ *\brief    Copies the most recent trace records, oldest first. Requires PLATFORM_I2C_TRACE_ENABLED.
+ *
+ *\details  Durations are measured with PlatformTimer, so it must be initialized for them to be valid.
+ *
+ *\param    outRecords    - Buffer to store the records.
+ *\param    inMaxRecords  - Number of records the buffer can hold.
+ *\param    outNumRecords - Pointer to store the number of records copied, up to PLATFORM_I2C_TRACE_SIZE.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if a pointer is NULL.
+ *          PlatformStatus_NotSupported if tracing is not enabled.
+ */
+PlatformStatus PlatformI2C_GetTraceRecords( PlatformI2CTraceRecord_t *const outRecords, const uint8_t inMaxRecords, uint8_t *const outNumRecords );
+
+/*!
+ *\brief    Gets bus utilization and per-device statistics since tracing was last reset. Requires PLATFORM_I2C_TRACE_ENABLED.
+ *
+ *\details  The tick counts wrap after about 536 seconds at 8MHz, so reset tracing more often than that.
+ *
+ *\param    outSummary - Pointer to store the summary.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if outSummary is NULL.
+ *          PlatformStatus_NotSupported if tracing is not enabled.
+ */
+PlatformStatus PlatformI2C_GetTraceSummary( PlatformI2CTraceSummary_t *const outSummary );
+
+/*!
+ *\brief    Clears the trace records and statistics, and starts measuring bus utilization from now. Requires PLATFORM_I2C_TRACE_ENABLED.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotSupported if tracing is not enabled.
+ */
+PlatformStatus PlatformI2C_ResetTrace( void );
+
+/*!
+ *\brief    Checks if a transaction is in progress or queued.
+ *
+ *\return   true if I2C is busy.
+ */
+bool PlatformI2C_IsBusy( void );
 
 /*!
  *\brief    Writes one byte to an I2C device.
@@ -34,12 +299,15 @@ PlatformStatus PlatformI2C_Init( void );
  *
  *\return   PlatformStatus - PlatformStatus_Success if the data was successfully written. 
                            - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+                           - PlatformStatus_Timeout if the bus stopped making progress. The bus was recovered.
                            - PlatformStatus_Failed if anything else failed.
  */
 PlatformStatus PlatformI2C_WriteByte( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, const uint8_t inDataByte );
 
 /*!
- *\brief    Writes data to an I2C device.
+ *\brief    Writes data to an I2C device, waiting until the transfer completes.
+ *
+ *\details  This queues a transaction with PlatformI2C_Submit() and waits for it. Must not be called from an interrupt or an I2C callback.
  *
  *\param    inDeviceAddr   - Address of the I2C device to write to.
  *\param    inRegisterAddr - Internal register address of the I2C device to write to.
@@ -48,12 +316,15 @@ PlatformStatus PlatformI2C_WriteByte( const uint8_t inDeviceAddr, const uint8_t
  *
  *\return   PlatformStatus - PlatformStatus_Success if the data was successfully written. 
                            - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+                           - PlatformStatus_Timeout if the bus stopped making progress. The bus was recovered.
                            - PlatformStatus_Failed if anything else failed.
  */
 PlatformStatus PlatformI2C_Write( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, const uint8_t *const inData, const size_t inDataLen );
 
 /*!
- *\brief    Reads data from an I2C device.
+ *\brief    Reads data from an I2C device, waiting until the transfer completes.
+ *
+ *\details  This queues a transaction with PlatformI2C_Submit() and waits for it. Must not be called from an interrupt or an I2C callback.
  *
  *\param    inDeviceAddr   - Address of the I2C device to read from.
  *\param    inRegisterAddr - Internal register address of the I2C device to read.
@@ -62,16 +333,48 @@ PlatformStatus PlatformI2C_Write( const uint8_t inDeviceAddr, const uint8_t inRe
  *
  *\return   PlatformStatus - PlatformStatus_Success if the data was read successfully.
                            - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+                           - PlatformStatus_Timeout if the bus stopped making progress. The bus was recovered.
                            - PlatformStatus_Failed if anything else failed.
  */
 PlatformStatus PlatformI2C_Read( const uint8_t inDeviceAddr, const uint8_t inRegisterAddress, uint8_t *const outData, const size_t inDataLen );
 
+/*!
+ *\brief    Checks whether a device acknowledges its address, e.g. to detect it, or to poll an EEPROM for the end of its write cycle.
+ *
+ *\details  This sends START, SLA+W and STOP, waiting until the transfer completes. Must not be called from an interrupt or an I2C callback.
+ *
+ *\param    inDeviceAddr - Address of the I2C device.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success if the device acknowledged.
+                           - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+                           - PlatformStatus_Timeout if the bus stopped making progress. The bus was recovered.
+                           - PlatformStatus_Failed if the device did not acknowledge, or anything else failed.
+ */
+PlatformStatus PlatformI2C_Probe( const uint8_t inDeviceAddr );
+
+/*!
+ *\brief    Runs a list of segments as one transaction with an I2C device, waiting until the transfer completes.
+ *
+ *\details  This queues a transaction with PlatformI2C_Submit() and waits for it. Must not be called from an interrupt or an I2C callback.
+ *
+ *\param    inDeviceAddr  - Address of the I2C device.
+ *\param    inSegments    - Segments to run in order. See PlatformI2CSegment_t.
+ *\param    inNumSegments - Number of segments.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success if every segment completed successfully.
+                           - PlatformStatus_NotInitialized if I2C has not yet been initialized.
+                           - PlatformStatus_InvalidArgument if a segment is invalid.
+                           - PlatformStatus_Timeout if the bus stopped making progress. The bus was recovered.
+                           - PlatformStatus_Failed if anything else failed.
+ */
+PlatformStatus PlatformI2C_Transfer( const uint8_t inDeviceAddr, const PlatformI2CSegment_t *const inSegments, const uint8_t inNumSegments );
+
 /*!
  *\brief    Deinitializes the I2C peripheral.
  *
  *\return   PlatformStatus - PlatformStatus_Success if deinitialized successfully. 
                            - PlatformStatus_NotInitialized if I2C has not yet been initialized.
-                           - PlatformStatus_Failed if anything else failed.
+                           - PlatformStatus_Failed if a transaction is in progress, or anything else failed.
  */
 PlatformStatus PlatformI2C_Deinit( void );
 
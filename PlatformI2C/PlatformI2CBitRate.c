@@ -0,0 +1,76 @@
+/*
+ * PlatformI2CBitRate.c
+ *
+ * Created: 2026-10-18 6:41:40 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformI2CBitRate.h"
+#include "require_macros.h"
+#include <stddef.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_I2C_BIT_RATE_TWBR_MAX        ( 0xFF )
+#define PLATFORM_I2C_BIT_RATE_FIXED_DIVIDER   ( 16 )
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+static const uint8_t kPlatformI2CBitRatePrescalers[] = { 1, 4, 16, 64 };
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformI2CBitRate_Calculate( const uint32_t inCPUFreqHz, 
+                                             const uint32_t inTargetSCLHz, 
+                                             uint8_t *const outPrescalerBits, 
+                                             uint8_t *const outBitRate, 
+                                             uint32_t *const outActualSCLHz )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint32_t       targetDivider;
+	uint32_t       bitRate = 0;
+	uint8_t        prescalerIndex;
+	
+	require_quiet( inTargetSCLHz,    exit );
+	require_quiet( outPrescalerBits, exit );
+	require_quiet( outBitRate,       exit );
+	require_quiet( outActualSCLHz,   exit );
+	
+	// Round the divider up, so the SCL frequency never exceeds the target
+	targetDivider = ( inCPUFreqHz / inTargetSCLHz ) + (( inCPUFreqHz % inTargetSCLHz ) ? 1 : 0 );
+	
+	for ( prescalerIndex = 0; prescalerIndex < sizeof( kPlatformI2CBitRatePrescalers ); prescalerIndex++ )
+	{
+		const uint32_t bitRateStep = 2UL * kPlatformI2CBitRatePrescalers[ prescalerIndex ];
+		
+		// Rearranged from SCL = CPU clock / ( 16 + 2 * TWBR * prescaler ), rounding TWBR up
+		bitRate = 0;
+		if ( targetDivider > PLATFORM_I2C_BIT_RATE_FIXED_DIVIDER )
+		{
+			bitRate = ( targetDivider - PLATFORM_I2C_BIT_RATE_FIXED_DIVIDER + bitRateStep - 1 ) / bitRateStep;
+		}
+		
+		// Use the smallest prescaler that fits, for the finest steps
+		if ( bitRate <= PLATFORM_I2C_BIT_RATE_TWBR_MAX )
+		{
+			break;
+		}
+	}
+	
+	require_quiet( prescalerIndex < sizeof( kPlatformI2CBitRatePrescalers ), exit );
+	
+	// The prescaler bits are the index 0-3 into kPlatformI2CBitRatePrescalers
+	*outPrescalerBits = prescalerIndex;
+	*outBitRate       = ( uint8_t )bitRate;
+	*outActualSCLHz   = inCPUFreqHz / ( PLATFORM_I2C_BIT_RATE_FIXED_DIVIDER + ( 2UL * bitRate * kPlatformI2CBitRatePrescalers[ prescalerIndex ] ));
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
\ No newline at end of file
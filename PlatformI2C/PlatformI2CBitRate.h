@@ -0,0 +1,38 @@
+/*
+ * PlatformI2CBitRate.h
+ *
+ * SCL bit rate calculation for PlatformI2C. 
+ * This has no hardware dependencies, so it can also be compiled and exercised on a host machine.
+ *
+ * Created: 2026-10-18 6:41:12 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMI2CBITRATE_H_
+#define PLATFORMI2CBITRATE_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+
+/*!
+ *\brief    Finds the TWI prescaler and bit rate register values for the fastest SCL frequency that does not exceed a target.
+ *
+ *\details  SCL = CPU clock / ( 16 + 2 * TWBR * prescaler ), from Section 21.5.2 of the ATmega328p datasheet.
+ *          The smallest prescaler that can reach the target is used, for the finest resolution. A target at or above CPU clock / 16 gives TWBR = 0.
+ *
+ *\param    inCPUFreqHz      - CPU clock frequency.
+ *\param    inTargetSCLHz    - Maximum SCL frequency.
+ *\param    outPrescalerBits - Pointer to store the TWPS1:0 bits, 0 - 3.
+ *\param    outBitRate       - Pointer to store the TWBR value.
+ *\param    outActualSCLHz   - Pointer to store the resulting SCL frequency.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the target is 0, below the slowest possible SCL frequency, or a pointer is NULL.
+ */
+PlatformStatus PlatformI2CBitRate_Calculate( const uint32_t inCPUFreqHz, 
+                                             const uint32_t inTargetSCLHz, 
+                                             uint8_t *const outPrescalerBits, 
+                                             uint8_t *const outBitRate, 
+                                             uint32_t *const outActualSCLHz );
+
+#endif /* PLATFORMI2CBITRATE_H_ */
\ No newline at end of file
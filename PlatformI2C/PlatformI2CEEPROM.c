@@ -0,0 +1,218 @@
+/*
+ * PlatformI2CEEPROM.c
+ *
+ * Created: 2026-10-18 8:04:52 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformI2CEEPROM.h"
+#include "PlatformI2C.h"
+#include "PlatformTimer.h"
+#include "require_macros.h"
+
+#ifdef PLATFORM_I2C_HOST
+#include "PlatformI2CHost.h"
+#else
+#include <util/delay.h>
+#endif
+
+//===============//
+//    Defines    //
+//===============//
+
+// Delay between polls of a device in its write cycle. Also bounds the polling when PlatformTimer is stopped with global interrupts disabled.
+#define PLATFORM_I2C_EEPROM_POLL_INTERVAL_US     ( 100 )
+#define PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_POLLS  (( PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_MS * 1000UL ) / PLATFORM_I2C_EEPROM_POLL_INTERVAL_US )
+
+#define PLATFORM_I2C_EEPROM_MAX_BLOCKS           ( 8UL ) // Three block select bits in the device address
+#define PLATFORM_I2C_EEPROM_BLOCK_SIZE( EEPROM ) ( 1UL << ( 8 * ( EEPROM )->addressLen ))
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static PlatformStatus _PlatformI2CEEPROM_Transfer( const PlatformI2CEEPROM_t *const inEEPROM, 
+                                                   const uint32_t inAddress, 
+                                                   uint8_t *const inData, 
+                                                   const size_t inDataLen, 
+                                                   const PlatformI2CDirection_t inDirection );
+static size_t         _PlatformI2CEEPROM_GetChunkLen( const uint32_t inAddress, const size_t inRemainingLen, const uint32_t inBoundary );
+static bool           _PlatformI2CEEPROM_IsValidRange( const PlatformI2CEEPROM_t *const inEEPROM, const uint32_t inAddress, const size_t inDataLen );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformI2CEEPROM_Init( PlatformI2CEEPROM_t *const outEEPROM, 
+                                       const uint8_t inDeviceAddr, 
+                                       const uint8_t inAddressLen, 
+                                       const uint16_t inPageSize, 
+                                       const uint32_t inSize )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( outEEPROM, exit );
+	require_quiet(( inAddressLen == 1 ) || ( inAddressLen == 2 ), exit );
+	require_quiet(( inPageSize & ( inPageSize - 1 )) == 0, exit );
+	require_quiet( inSize, exit );
+	require_quiet( inSize <= ( PLATFORM_I2C_EEPROM_MAX_BLOCKS << ( 8 * inAddressLen )), exit );
+	
+	outEEPROM->deviceAddr         = inDeviceAddr;
+	outEEPROM->addressLen         = inAddressLen;
+	outEEPROM->pageSize           = inPageSize;
+	outEEPROM->size               = inSize;
+	outEEPROM->isWriteCycleActive = false;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CEEPROM_Read( PlatformI2CEEPROM_t *const inEEPROM, const uint32_t inAddress, uint8_t *const outData, const size_t inDataLen )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint32_t address      = inAddress;
+	size_t   remainingLen = inDataLen;
+	uint8_t *data         = outData;
+	
+	require_quiet( _PlatformI2CEEPROM_IsValidRange( inEEPROM, inAddress, inDataLen ), exit );
+	require_quiet( outData || ( inDataLen == 0 ), exit );
+	
+	// The device doesn't respond until its write cycle is done
+	status = PlatformI2CEEPROM_Sync( inEEPROM );
+	require_noerr_quiet( status, exit );
+	
+	// Sequential reads run to the end of a block, since the next block has a different device address
+	while ( remainingLen )
+	{
+		const size_t chunkLen = _PlatformI2CEEPROM_GetChunkLen( address, remainingLen, PLATFORM_I2C_EEPROM_BLOCK_SIZE( inEEPROM ));
+		
+		status = _PlatformI2CEEPROM_Transfer( inEEPROM, address, data, chunkLen, PlatformI2CDirection_Read );
+		require_noerr_quiet( status, exit );
+		
+		address      += chunkLen;
+		data         += chunkLen;
+		remainingLen -= chunkLen;
+	}
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CEEPROM_Write( PlatformI2CEEPROM_t *const inEEPROM, const uint32_t inAddress, const uint8_t *const inData, const size_t inDataLen )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint32_t       address      = inAddress;
+	size_t         remainingLen = inDataLen;
+	const uint8_t *data         = inData;
+	
+	require_quiet( _PlatformI2CEEPROM_IsValidRange( inEEPROM, inAddress, inDataLen ), exit );
+	require_quiet( inData || ( inDataLen == 0 ), exit );
+	
+	status = PlatformStatus_Success;
+	
+	// A write past the end of a page wraps around to its start, so each page is written separately. FRAM only needs splitting at blocks.
+	while ( remainingLen )
+	{
+		const uint32_t boundary = inEEPROM->pageSize ? inEEPROM->pageSize : PLATFORM_I2C_EEPROM_BLOCK_SIZE( inEEPROM );
+		const size_t   chunkLen = _PlatformI2CEEPROM_GetChunkLen( address, remainingLen, boundary );
+		
+		status = PlatformI2CEEPROM_Sync( inEEPROM );
+		require_noerr_quiet( status, exit );
+		
+		// The engine never writes to the buffer of a write segment
+		status = _PlatformI2CEEPROM_Transfer( inEEPROM, address, ( uint8_t* )data, chunkLen, PlatformI2CDirection_Write );
+		require_noerr_quiet( status, exit );
+		
+		// Let the write cycle run while the caller gets on with something else
+		inEEPROM->isWriteCycleActive = ( inEEPROM->pageSize != 0 );
+		
+		address      += chunkLen;
+		data         += chunkLen;
+		remainingLen -= chunkLen;
+	}
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CEEPROM_Sync( PlatformI2CEEPROM_t *const inEEPROM )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint32_t startTime;
+	uint32_t currentTime;
+	uint32_t numPolls = 0;
+	
+	require_quiet( inEEPROM, exit );
+	
+	status = PlatformStatus_Success;
+	require_quiet( inEEPROM->isWriteCycleActive, exit );
+	
+	status = PlatformTimer_GetTime( &startTime );
+	require_noerr_quiet( status, exit );
+	
+	// The device doesn't acknowledge its address during the write cycle. 
+	// PlatformTimer doesn't advance with global interrupts disabled, so the number of polls is bounded too.
+	for ( ;; )
+	{
+		status = PlatformI2C_Probe( inEEPROM->deviceAddr );
+		if ( status == PlatformStatus_Success )
+		{
+			inEEPROM->isWriteCycleActive = false;
+			break;
+		}
+		
+		// A stuck bus already took a timeout of its own; don't keep trying
+		require_quiet( status != PlatformStatus_Timeout, exit );
+		
+		status = PlatformTimer_GetTime( &currentTime );
+		require_noerr_quiet( status, exit );
+		
+		require_action_quiet(( currentTime - startTime ) <= PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_MS, exit, status = PlatformStatus_Timeout );
+		require_action_quiet( numPolls < PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_POLLS, exit, status = PlatformStatus_Timeout );
+		
+		_delay_us( PLATFORM_I2C_EEPROM_POLL_INTERVAL_US );
+		numPolls++;
+	}
+	
+exit:
+	return status;
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static PlatformStatus _PlatformI2CEEPROM_Transfer( const PlatformI2CEEPROM_t *const inEEPROM, 
+                                                   const uint32_t inAddress, 
+                                                   uint8_t *const inData, 
+                                                   const size_t inDataLen, 
+                                                   const PlatformI2CDirection_t inDirection )
+{
+	PlatformI2CSegment_t segment = 
+	{
+		.direction          = inDirection,
+		.registerAddress    = ( uint16_t )inAddress,
+		.registerAddressLen = inEEPROM->addressLen,
+		.data               = inData,
+		.dataLen            = inDataLen,
+	};
+	
+	// The address bits above the memory address select the block through the device address
+	const uint8_t deviceAddr = inEEPROM->deviceAddr | ( uint8_t )( inAddress >> ( 8 * inEEPROM->addressLen ));
+	
+	return PlatformI2C_Transfer( deviceAddr, &segment, 1 );
+}
+
+// Length up to the next multiple of inBoundary, a power of 2, but no more than inRemainingLen
+static size_t _PlatformI2CEEPROM_GetChunkLen( const uint32_t inAddress, const size_t inRemainingLen, const uint32_t inBoundary )
+{
+	const uint32_t lenToBoundary = inBoundary - ( inAddress & ( inBoundary - 1 ));
+	
+	return ( lenToBoundary < inRemainingLen ) ? ( size_t )lenToBoundary : inRemainingLen;
+}
+
+static bool _PlatformI2CEEPROM_IsValidRange( const PlatformI2CEEPROM_t *const inEEPROM, const uint32_t inAddress, const size_t inDataLen )
+{
+	return inEEPROM && ( inAddress <= inEEPROM->size ) && ( inDataLen <= ( inEEPROM->size - inAddress ));
+}
\ No newline at end of file
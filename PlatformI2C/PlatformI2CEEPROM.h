@@ -0,0 +1,96 @@
+/*
+ * PlatformI2CEEPROM.h
+ *
+ * Block access to 24Cxx I2C EEPROMs and FRAMs through PlatformI2C.
+ * Writes are split at page boundaries, and the write cycle of each page is left to run in the background:
+ * the device is only polled for completion, by its address acknowledge, when it is next accessed or on PlatformI2CEEPROM_Sync().
+ *
+ * Created: 2026-10-18 8:04:17 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMI2CEEPROM_H_
+#define PLATFORMI2CEEPROM_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+// Longest a page write cycle may take before it is considered failed. Most 24Cxx parts specify 5ms.
+#ifndef PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_MS
+#define PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_MS ( 20 )
+#endif
+
+/*!
+ *\brief    EEPROM device. Set up with PlatformI2CEEPROM_Init().
+ */
+typedef struct
+{
+	uint8_t  deviceAddr;         // Base address with the block select bits clear, e.g. 0x50
+	uint8_t  addressLen;         // Memory address bytes: 1 for 24C01 - 24C16, 2 for 24C32 and up. Higher address bits go in the block select bits of the device address.
+	uint16_t pageSize;           // Bytes per write page, or 0 for FRAM, which has no pages or write cycle
+	uint32_t size;               // Bytes
+	bool     isWriteCycleActive; // A page was written and the device may still be busy
+} PlatformI2CEEPROM_t;
+
+/*!
+ *\brief    Sets up an EEPROM device.
+ *
+ *\param    outEEPROM    - Device to set up.
+ *\param    inDeviceAddr - Base device address, with the block select bits clear.
+ *\param    inAddressLen - Memory address bytes, 1 or 2.
+ *\param    inPageSize   - Write page size in bytes, a power of 2, e.g. 8 for a 24C02 or 32 for a 24C32. 0 for FRAM.
+ *\param    inSize       - Device size in bytes. Up to 8 blocks of 256 or 65536 bytes, depending on the address length.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if an argument is out of range.
+ */
+PlatformStatus PlatformI2CEEPROM_Init( PlatformI2CEEPROM_t *const outEEPROM, 
+                                       const uint8_t inDeviceAddr, 
+                                       const uint8_t inAddressLen, 
+                                       const uint16_t inPageSize, 
+                                       const uint32_t inSize );
+
+/*!
+ *\brief    Reads from the device with sequential reads, one transaction per block.
+ *
+ *\param    inEEPROM  - Device to read.
+ *\param    inAddress - Memory address to start reading from.
+ *\param    outData   - Buffer to store the data.
+ *\param    inDataLen - Number of bytes to read.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the range is past the end of the device.
+ *          PlatformStatus_Timeout if a previous write cycle did not complete. Otherwise, the status of PlatformI2C_Transfer().
+ */
+PlatformStatus PlatformI2CEEPROM_Read( PlatformI2CEEPROM_t *const inEEPROM, const uint32_t inAddress, uint8_t *const outData, const size_t inDataLen );
+
+/*!
+ *\brief    Writes to the device, one transaction per page.
+ *
+ *\details  Returns once the last page has been sent, without waiting for its write cycle. See PlatformI2CEEPROM_Sync().
+ *
+ *\param    inEEPROM  - Device to write.
+ *\param    inAddress - Memory address to start writing at.
+ *\param    inData    - Data to write.
+ *\param    inDataLen - Number of bytes to write.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the range is past the end of the device.
+ *          PlatformStatus_Timeout if a write cycle did not complete. Otherwise, the status of PlatformI2C_Transfer().
+ */
+PlatformStatus PlatformI2CEEPROM_Write( PlatformI2CEEPROM_t *const inEEPROM, const uint32_t inAddress, const uint8_t *const inData, const size_t inDataLen );
+
+/*!
+ *\brief    Waits for the write cycle of the last page written to finish, e.g. before removing power.
+ *
+ *\details  The device is polled until it acknowledges its address, for up to PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_MS. PlatformTimer must be initialized.
+ *          With global interrupts disabled PlatformTimer stops, so the polls are also limited to as many as fit in that time.
+ *
+ *\param    inEEPROM - Device to wait for.
+ *
+ *\return   PlatformStatus_Success if the device is ready. PlatformStatus_Timeout if the write cycle did not complete.
+ *          PlatformStatus_NotInitialized if PlatformTimer is not initialized. PlatformStatus_InvalidArgument if inEEPROM is NULL.
+ */
+PlatformStatus PlatformI2CEEPROM_Sync( PlatformI2CEEPROM_t *const inEEPROM );
+
+#endif /* PLATFORMI2CEEPROM_H_ */
\ No newline at end of file
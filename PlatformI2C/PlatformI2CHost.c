@@ -0,0 +1,614 @@
+/*
+ * PlatformI2CHost.c
+ *
+ * Created: 2026-10-18 8:52:03 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformI2CHost.h"
+
+#ifdef PLATFORM_I2C_HOST
+
+#include "PlatformTimer.h"
+#include "PlatformGPIO.h"
+#include "PlatformPowerSave.h"
+#include <stddef.h>
+#include <string.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_I2C_HOST_BITS_PER_BYTE   ( 9 )  // 8 data bits and the acknowledge
+#define PLATFORM_I2C_HOST_TICKS_PER_POLL  ( 16 ) // Time taken by each PlatformTimer_GetTicks(), so a stuck bus eventually times out
+#define PLATFORM_I2C_HOST_STATUS_MASK     ( 0xF8 )
+#define PLATFORM_I2C_HOST_PRESCALER_MASK  (( 1 << TWPS1 ) | ( 1 << TWPS0 ))
+
+// The pins PlatformI2C uses for bus recovery
+#define PLATFORM_I2C_HOST_SCL_GPIO        ( PlatformGPIO_PTC5 )
+#define PLATFORM_I2C_HOST_SDA_GPIO        ( PlatformGPIO_PTC4 )
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+typedef enum
+{
+	PlatformI2CHostBusState_Idle,
+	PlatformI2CHostBusState_Address,       // START sent; TWDR holds SLA+R/W
+	PlatformI2CHostBusState_Transmit,
+	PlatformI2CHostBusState_Receive,
+	PlatformI2CHostBusState_NotAcknowledged, // Only a START or STOP may follow
+} PlatformI2CHostBusState_t;
+
+typedef struct
+{
+	PlatformI2CHostSlave_t   *slaves[ PLATFORM_I2C_HOST_MAX_SLAVES ];
+	uint8_t                   numSlaves;
+	PlatformI2CHostSlave_t   *addressedSlave;
+	PlatformI2CHostBusState_t busState;
+	bool                      isBusOwned;    // Between our START and STOP
+	bool                      isBusHung;     // A slave is holding SDA low
+	bool                      areInterruptsEnabled;
+	uint32_t                  ticks;
+	uint32_t                  timerMilliseconds; // PlatformTimer's millisecond count, which stops while global interrupts are disabled
+	bool                      isTimerStopped;    // PlatformTimer is not initialized
+	PlatformI2CHostStats_t    stats;
+} PlatformI2CHost_t;
+
+uint8_t TWCR;
+uint8_t TWDR;
+uint8_t TWSR;
+uint8_t TWAR;
+uint8_t TWBR;
+uint8_t PORTC;
+
+static PlatformI2CHost_t mPlatformI2CHost;
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void                    _PlatformI2CHost_Step( void );
+static void                    _PlatformI2CHost_SetStatus( const uint8_t inStatus );
+static void                    _PlatformI2CHost_ServiceInterrupt( void );
+static void                    _PlatformI2CHost_AdvanceBits( const uint32_t inNumBits );
+static uint32_t                _PlatformI2CHost_GetTimerTicks( void );
+static PlatformI2CHostSlave_t *_PlatformI2CHost_FindSlave( const uint8_t inDeviceAddr );
+
+static bool    _PlatformI2CHost_RegisterFileStart( PlatformI2CHostSlave_t *const inSlave, const uint8_t inDeviceAddr, const bool inIsRead );
+static bool    _PlatformI2CHost_RegisterFileWrite( PlatformI2CHostSlave_t *const inSlave, const uint8_t inByte );
+static uint8_t _PlatformI2CHost_RegisterFileRead( PlatformI2CHostSlave_t *const inSlave );
+
+static bool    _PlatformI2CHost_EEPROMStart( PlatformI2CHostSlave_t *const inSlave, const uint8_t inDeviceAddr, const bool inIsRead );
+static bool    _PlatformI2CHost_EEPROMWrite( PlatformI2CHostSlave_t *const inSlave, const uint8_t inByte );
+static uint8_t _PlatformI2CHost_EEPROMRead( PlatformI2CHostSlave_t *const inSlave );
+static void    _PlatformI2CHost_EEPROMStop( PlatformI2CHostSlave_t *const inSlave );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+void PlatformI2CHost_Reset( void )
+{
+	memset( &mPlatformI2CHost, 0, sizeof( mPlatformI2CHost ));
+	mPlatformI2CHost.areInterruptsEnabled = true;
+	
+	TWCR = 0;
+	TWDR = 0xFF;
+	TWSR = PLATFORM_I2C_HOST_STATUS_MASK; // No relevant state information
+	TWAR = 0;
+	TWBR = 0;
+	PORTC = 0;
+}
+
+PlatformStatus PlatformI2CHost_AddSlave( PlatformI2CHostSlave_t *const inSlave )
+{
+	if ( inSlave == NULL )
+	{
+		return PlatformStatus_InvalidArgument;
+	}
+	
+	if ( mPlatformI2CHost.numSlaves >= PLATFORM_I2C_HOST_MAX_SLAVES )
+	{
+		return PlatformStatus_Failed;
+	}
+	
+	mPlatformI2CHost.slaves[ mPlatformI2CHost.numSlaves ] = inSlave;
+	mPlatformI2CHost.numSlaves++;
+	
+	return PlatformStatus_Success;
+}
+
+void PlatformI2CHost_InitRegisterFile( PlatformI2CHostRegisterFile_t *const outModel, 
+                                       const uint8_t inDeviceAddr, 
+                                       uint8_t *const inRegisters, 
+                                       const uint16_t inNumRegisters, 
+                                       const uint8_t inAddressLen )
+{
+	memset( outModel, 0, sizeof( *outModel ));
+	
+	outModel->slave.deviceAddr   = inDeviceAddr;
+	outModel->slave.numAddresses = 1;
+	outModel->slave.start        = _PlatformI2CHost_RegisterFileStart;
+	outModel->slave.write        = _PlatformI2CHost_RegisterFileWrite;
+	outModel->slave.read         = _PlatformI2CHost_RegisterFileRead;
+	outModel->registers          = inRegisters;
+	outModel->numRegisters       = inNumRegisters;
+	outModel->addressLen         = inAddressLen;
+}
+
+void PlatformI2CHost_InitEEPROM( PlatformI2CHostEEPROM_t *const outModel, 
+                                 const uint8_t inDeviceAddr, 
+                                 uint8_t *const inMemory, 
+                                 const uint32_t inSize, 
+                                 const uint8_t inAddressLen, 
+                                 const uint16_t inPageSize, 
+                                 const uint32_t inWriteCycleTicks )
+{
+	const uint32_t blockSize = 1UL << ( 8 * inAddressLen );
+	
+	memset( outModel, 0, sizeof( *outModel ));
+	
+	outModel->slave.deviceAddr   = inDeviceAddr;
+	outModel->slave.numAddresses = ( uint8_t )(( inSize + blockSize - 1 ) / blockSize );
+	outModel->slave.start        = _PlatformI2CHost_EEPROMStart;
+	outModel->slave.write        = _PlatformI2CHost_EEPROMWrite;
+	outModel->slave.read         = _PlatformI2CHost_EEPROMRead;
+	outModel->slave.stop         = _PlatformI2CHost_EEPROMStop;
+	outModel->memory             = inMemory;
+	outModel->size               = inSize;
+	outModel->addressLen         = inAddressLen;
+	outModel->pageSize           = inPageSize;
+	outModel->writeCycleTicks    = inWriteCycleTicks;
+}
+
+void PlatformI2CHost_GetStats( PlatformI2CHostStats_t *const outStats )
+{
+	*outStats = mPlatformI2CHost.stats;
+}
+
+uint32_t PlatformI2CHost_GetTicks( void )
+{
+	return mPlatformI2CHost.ticks;
+}
+
+void PlatformI2CHost_SetTimerInitialized( const bool inIsInitialized )
+{
+	mPlatformI2CHost.isTimerStopped = !inIsInitialized;
+}
+
+void PlatformI2CHost_WriteTWCR( const uint8_t inValue )
+{
+	// TWINT reads back as set only while an event is pending. Writing it as 1 clears it, which starts the next action.
+	TWCR = ( inValue & ~( 1 << TWINT )) | ( TWCR & ( 1 << TWINT ));
+	
+	// Disabling the TWI terminates any transmission, leaving no relevant state information
+	if (( inValue & ( 1 << TWEN )) == 0 )
+	{
+		TWSR = PLATFORM_I2C_HOST_STATUS_MASK | ( TWSR & PLATFORM_I2C_HOST_PRESCALER_MASK );
+	}
+	
+	if (( inValue & ( 1 << TWINT )) && ( TWCR & ( 1 << TWEN )))
+	{
+		TWCR &= ~( 1 << TWINT );
+		
+		// Nothing completes while a slave holds the bus
+		if ( !mPlatformI2CHost.isBusHung )
+		{
+			_PlatformI2CHost_Step();
+		}
+	}
+	
+	_PlatformI2CHost_ServiceInterrupt();
+}
+
+bool PlatformI2CHost_AreInterruptsEnabled( void )
+{
+	return mPlatformI2CHost.areInterruptsEnabled;
+}
+
+void PlatformI2CHost_SetInterruptsEnabled( const bool inIsEnabled )
+{
+	// Bring the millisecond count up to date before it stops
+	( void )_PlatformI2CHost_GetTimerTicks();
+	
+	mPlatformI2CHost.areInterruptsEnabled = inIsEnabled;
+	
+	// A pending interrupt is taken as soon as interrupts are enabled
+	_PlatformI2CHost_ServiceInterrupt();
+}
+
+void PlatformI2CHost_DelayMicroseconds( const uint32_t inMicroseconds )
+{
+	mPlatformI2CHost.ticks += inMicroseconds * ( F_CPU / 1000000UL );
+}
+
+//=======================================//
+//    Stand-ins for Other Peripherals    //
+//=======================================//
+
+PlatformStatus PlatformTimer_GetTicks( uint32_t * const outTicks )
+{
+	if ( mPlatformI2CHost.isTimerStopped )
+	{
+		return PlatformStatus_NotInitialized;
+	}
+	
+	mPlatformI2CHost.ticks += PLATFORM_I2C_HOST_TICKS_PER_POLL;
+	*outTicks = _PlatformI2CHost_GetTimerTicks();
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformTimer_GetTime( uint32_t * const outTime )
+{
+	if ( mPlatformI2CHost.isTimerStopped )
+	{
+		return PlatformStatus_NotInitialized;
+	}
+	
+	mPlatformI2CHost.ticks += PLATFORM_I2C_HOST_TICKS_PER_POLL;
+	( void )_PlatformI2CHost_GetTimerTicks();
+	*outTime = mPlatformI2CHost.timerMilliseconds;
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformGPIO_Configure( PlatformGPIO_t inGPIO, PlatformGPIOConfig_t inConfig )
+{
+	// Each time SCL is pulled low, a hung slave shifts out another bit; one clock is enough to release SDA here
+	if (( inGPIO == PLATFORM_I2C_HOST_SCL_GPIO ) && ( inConfig == PlatformGPIOConfig_Output ))
+	{
+		mPlatformI2CHost.stats.numRecoveryClocks++;
+		mPlatformI2CHost.isBusHung = false;
+	}
+	
+	// Only an input pull-up leaves the PORT bit set
+	if (( inGPIO == PLATFORM_I2C_HOST_SCL_GPIO ) || ( inGPIO == PLATFORM_I2C_HOST_SDA_GPIO ))
+	{
+		const uint8_t pinMask = PLATFORM_GPIO_PIN_MASK( inGPIO );
+		
+		PORTC = ( inConfig == PlatformGPIOConfig_InputPullUp ) ? ( PORTC | pinMask ) : ( PORTC & ~pinMask );
+	}
+	
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformGPIO_GetInput( PlatformGPIO_t inGPIO, bool *const outLogicLevel )
+{
+	*outLogicLevel = ( inGPIO == PLATFORM_I2C_HOST_SDA_GPIO ) ? !mPlatformI2CHost.isBusHung : true;
+	
+	// Recovery leaves the bus released and idle
+	if ( !mPlatformI2CHost.isBusHung )
+	{
+		mPlatformI2CHost.isBusOwned     = false;
+		mPlatformI2CHost.addressedSlave = NULL;
+		mPlatformI2CHost.busState       = PlatformI2CHostBusState_Idle;
+	}
+	
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformPowerSave_PowerOnPeripheral( PlatformPowerSavePeripheral_t inDomain )
+{
+	( void )inDomain;
+	
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_t inDomain )
+{
+	( void )inDomain;
+	
+	return PlatformStatus_Success;
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+// Carries out the action requested by the TWCR write, and raises TWINT with the resulting status
+static void _PlatformI2CHost_Step( void )
+{
+	PlatformI2CHost_t *const host = &mPlatformI2CHost;
+	
+	if ( TWCR & ( 1 << TWSTO ))
+	{
+		if ( host->isBusOwned )
+		{
+			if ( host->addressedSlave && host->addressedSlave->stop )
+			{
+				host->addressedSlave->stop( host->addressedSlave );
+			}
+			
+			host->stats.numStops++;
+			_PlatformI2CHost_AdvanceBits( 1 );
+		}
+		
+		// TWSTO clears itself once the STOP has been sent; no interrupt follows
+		TWCR &= ~( 1 << TWSTO );
+		host->isBusOwned     = false;
+		host->addressedSlave = NULL;
+		host->busState       = PlatformI2CHostBusState_Idle;
+		
+		if ( !( TWCR & ( 1 << TWSTA )))
+		{
+			return;
+		}
+	}
+	
+	if ( TWCR & ( 1 << TWSTA ))
+	{
+		_PlatformI2CHost_SetStatus( host->isBusOwned ? 0x10 : 0x08 );
+		host->isBusOwned     = true;
+		host->addressedSlave = NULL;
+		host->busState       = PlatformI2CHostBusState_Address;
+		host->stats.numStarts++;
+		_PlatformI2CHost_AdvanceBits( 1 );
+		return;
+	}
+	
+	switch ( host->busState )
+	{
+		case PlatformI2CHostBusState_Address:
+		{
+			const bool                    isRead = ( TWDR & 1 ) ? true : false;
+			PlatformI2CHostSlave_t *const slave  = _PlatformI2CHost_FindSlave( TWDR >> 1 );
+			
+			host->stats.numBytes++;
+			_PlatformI2CHost_AdvanceBits( PLATFORM_I2C_HOST_BITS_PER_BYTE );
+			
+			if ( slave && !slave->isNACKingAddress && slave->start( slave, TWDR >> 1, isRead ))
+			{
+				host->addressedSlave = slave;
+				host->busState       = isRead ? PlatformI2CHostBusState_Receive : PlatformI2CHostBusState_Transmit;
+				
+				// A hung slave never lets the next event happen, until the bus is recovered
+				if ( slave->numBusHangs )
+				{
+					slave->numBusHangs--;
+					host->isBusHung = true;
+					return;
+				}
+				
+				_PlatformI2CHost_SetStatus( isRead ? 0x40 : 0x18 );
+			}
+			else
+			{
+				host->stats.numAddressNACKs++;
+				host->busState = PlatformI2CHostBusState_NotAcknowledged;
+				_PlatformI2CHost_SetStatus( isRead ? 0x48 : 0x20 );
+			}
+			break;
+		}
+		case PlatformI2CHostBusState_Transmit:
+		{
+			const bool isACKed = host->addressedSlave->write( host->addressedSlave, TWDR );
+			
+			host->stats.numBytes++;
+			_PlatformI2CHost_AdvanceBits( PLATFORM_I2C_HOST_BITS_PER_BYTE );
+			host->ticks += host->addressedSlave->stretchTicks;
+			
+			if ( !isACKed )
+			{
+				host->busState = PlatformI2CHostBusState_NotAcknowledged;
+			}
+			_PlatformI2CHost_SetStatus( isACKed ? 0x28 : 0x30 );
+			break;
+		}
+		case PlatformI2CHostBusState_Receive:
+		{
+			// TWEA decides whether we acknowledge the byte; without it the slave stops sending
+			const bool isACKed = ( TWCR & ( 1 << TWEA )) ? true : false;
+			
+			TWDR = host->addressedSlave->read( host->addressedSlave );
+			
+			host->stats.numBytes++;
+			_PlatformI2CHost_AdvanceBits( PLATFORM_I2C_HOST_BITS_PER_BYTE );
+			host->ticks += host->addressedSlave->stretchTicks;
+			
+			if ( !isACKed )
+			{
+				host->busState = PlatformI2CHostBusState_NotAcknowledged;
+			}
+			_PlatformI2CHost_SetStatus( isACKed ? 0x50 : 0x58 );
+			break;
+		}
+		case PlatformI2CHostBusState_Idle:
+		case PlatformI2CHostBusState_NotAcknowledged:
+		default:
+		{
+			// Only a START or STOP does anything here; just clearing the flag doesn't raise it again
+			break;
+		}
+	}
+}
+
+static void _PlatformI2CHost_SetStatus( const uint8_t inStatus )
+{
+	TWSR  = inStatus | ( TWSR & PLATFORM_I2C_HOST_PRESCALER_MASK );
+	TWCR |= ( 1 << TWINT );
+}
+
+static void _PlatformI2CHost_ServiceInterrupt( void )
+{
+	PlatformI2CHost_t *const host = &mPlatformI2CHost;
+	
+	// Global interrupts are disabled while the ISR runs, as on the AVR, so TWCR writes from it don't nest
+	while ( host->areInterruptsEnabled && ( TWCR & ( 1 << TWIE )) && ( TWCR & ( 1 << TWINT )))
+	{
+		( void )_PlatformI2CHost_GetTimerTicks();
+		host->areInterruptsEnabled = false;
+		PlatformI2CHost_TWIInterrupt();
+		host->areInterruptsEnabled = true;
+	}
+}
+
+static void _PlatformI2CHost_AdvanceBits( const uint32_t inNumBits )
+{
+	static const uint8_t kPrescalers[] = { 1, 4, 16, 64 };
+	
+	// SCL period = 16 + 2 * TWBR * prescaler CPU clock cycles
+	const uint32_t ticksPerBit = 16UL + 2UL * TWBR * kPrescalers[ TWSR & PLATFORM_I2C_HOST_PRESCALER_MASK ];
+	
+	mPlatformI2CHost.ticks          += inNumBits * ticksPerBit;
+	mPlatformI2CHost.stats.busTicks += inNumBits * ticksPerBit;
+}
+
+// Models Timer1: the counter keeps running, but the millisecond count only advances in the compare match ISR.
+// With global interrupts disabled the tick count can therefore move forward by at most about 1ms, as on the AVR.
+static uint32_t _PlatformI2CHost_GetTimerTicks( void )
+{
+	PlatformI2CHost_t *const host = &mPlatformI2CHost;
+	const uint32_t counterTicks   = host->ticks - ( host->timerMilliseconds * PLATFORM_TIMER_TICKS_PER_MS );
+	
+	if ( host->areInterruptsEnabled )
+	{
+		// Any pending compare matches are serviced
+		host->timerMilliseconds = host->ticks / PLATFORM_TIMER_TICKS_PER_MS;
+		return host->ticks;
+	}
+	
+	// PlatformTimer_GetTicksFromCount() accounts for one pending compare match; past that the counter wraps
+	if ( counterTicks < ( 2 * PLATFORM_TIMER_TICKS_PER_MS ))
+	{
+		return host->ticks;
+	}
+	
+	return ( host->timerMilliseconds * PLATFORM_TIMER_TICKS_PER_MS ) + PLATFORM_TIMER_TICKS_PER_MS + ( counterTicks % PLATFORM_TIMER_TICKS_PER_MS );
+}
+
+static PlatformI2CHostSlave_t *_PlatformI2CHost_FindSlave( const uint8_t inDeviceAddr )
+{
+	for ( uint8_t i = 0; i < mPlatformI2CHost.numSlaves; i++ )
+	{
+		PlatformI2CHostSlave_t *const slave = mPlatformI2CHost.slaves[ i ];
+		
+		if (( inDeviceAddr >= slave->deviceAddr ) && (( inDeviceAddr - slave->deviceAddr ) < slave->numAddresses ))
+		{
+			return slave;
+		}
+	}
+	
+	return NULL;
+}
+
+static bool _PlatformI2CHost_RegisterFileStart( PlatformI2CHostSlave_t *const inSlave, const uint8_t inDeviceAddr, const bool inIsRead )
+{
+	PlatformI2CHostRegisterFile_t *const model = ( PlatformI2CHostRegisterFile_t* )inSlave;
+	
+	// Register files only answer their one address
+	( void )inDeviceAddr;
+	
+	// A write starts with a new register pointer; a read carries on from the current one
+	if ( !inIsRead )
+	{
+		model->numAddressBytes = 0;
+	}
+	
+	return true;
+}
+
+static bool _PlatformI2CHost_RegisterFileWrite( PlatformI2CHostSlave_t *const inSlave, const uint8_t inByte )
+{
+	PlatformI2CHostRegisterFile_t *const model = ( PlatformI2CHostRegisterFile_t* )inSlave;
+	
+	if ( model->numAddressBytes < model->addressLen )
+	{
+		// MSB first
+		model->pointer = ( model->numAddressBytes == 0 ) ? inByte : ( uint16_t )(( model->pointer << 8 ) | inByte );
+		model->numAddressBytes++;
+		return true;
+	}
+	
+	if ( model->pointer >= model->numRegisters )
+	{
+		return false;
+	}
+	
+	model->registers[ model->pointer ] = inByte;
+	model->pointer++;
+	return true;
+}
+
+static uint8_t _PlatformI2CHost_RegisterFileRead( PlatformI2CHostSlave_t *const inSlave )
+{
+	PlatformI2CHostRegisterFile_t *const model = ( PlatformI2CHostRegisterFile_t* )inSlave;
+	uint8_t value = 0xFF;
+	
+	if ( model->pointer < model->numRegisters )
+	{
+		value = model->registers[ model->pointer ];
+		model->pointer++;
+	}
+	
+	return value;
+}
+
+static bool _PlatformI2CHost_EEPROMStart( PlatformI2CHostSlave_t *const inSlave, const uint8_t inDeviceAddr, const bool inIsRead )
+{
+	PlatformI2CHostEEPROM_t *const model = ( PlatformI2CHostEEPROM_t* )inSlave;
+	
+	// No response at all during the write cycle
+	if (( int32_t )( mPlatformI2CHost.ticks - model->busyUntilTicks ) < 0 )
+	{
+		return false;
+	}
+	
+	if ( !inIsRead )
+	{
+		// The block select bits of the device address are the top of the memory address
+		model->address         = ( uint32_t )( inDeviceAddr - inSlave->deviceAddr ) << ( 8 * model->addressLen );
+		model->numAddressBytes = 0;
+	}
+	
+	return true;
+}
+
+static bool _PlatformI2CHost_EEPROMWrite( PlatformI2CHostSlave_t *const inSlave, const uint8_t inByte )
+{
+	PlatformI2CHostEEPROM_t *const model = ( PlatformI2CHostEEPROM_t* )inSlave;
+	
+	if ( model->numAddressBytes < model->addressLen )
+	{
+		// MSB first, below the block select bits
+		const uint8_t shift = 8 * ( model->addressLen - 1 - model->numAddressBytes );
+		
+		model->address = ( model->address & ~( 0xFFUL << shift )) | (( uint32_t )inByte << shift );
+		model->numAddressBytes++;
+		return true;
+	}
+	
+	if ( model->address < model->size )
+	{
+		model->memory[ model->address ] = inByte;
+	}
+	
+	// The address wraps within the page
+	model->address   = ( model->address & ~( uint32_t )( model->pageSize - 1 )) | (( model->address + 1 ) & ( model->pageSize - 1 ));
+	model->isWritten = true;
+	return true;
+}
+
+static uint8_t _PlatformI2CHost_EEPROMRead( PlatformI2CHostSlave_t *const inSlave )
+{
+	PlatformI2CHostEEPROM_t *const model = ( PlatformI2CHostEEPROM_t* )inSlave;
+	const uint8_t                  value = ( model->address < model->size ) ? model->memory[ model->address ] : 0xFF;
+	
+	// Sequential reads wrap at the end of the device
+	model->address = ( model->address + 1 ) % model->size;
+	
+	return value;
+}
+
+static void _PlatformI2CHost_EEPROMStop( PlatformI2CHostSlave_t *const inSlave )
+{
+	PlatformI2CHostEEPROM_t *const model = ( PlatformI2CHostEEPROM_t* )inSlave;
+	
+	if ( model->isWritten )
+	{
+		model->busyUntilTicks = mPlatformI2CHost.ticks + model->writeCycleTicks;
+		model->isWritten      = false;
+	}
+}
+
+#endif /* PLATFORM_I2C_HOST */
\ No newline at end of file
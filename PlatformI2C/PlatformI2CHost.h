@@ -0,0 +1,206 @@
+/*
+ * PlatformI2CHost.h
+ *
+ * Host backend for PlatformI2C, so it and the drivers built on it can be tested and benchmarked off target.
+ * Building PlatformI2C.c with PLATFORM_I2C_HOST defined replaces the TWI registers with simulated ones, 
+ * which play back the TWSR status codes of the ATmega328p TWI in master mode, talking to slave models added with PlatformI2CHost_AddSlave().
+ *
+ * Bus actions complete as soon as TWCR is written, advancing a simulated clock by the time they would take on the bus.
+ * PlatformI2CHost.c also stands in for the PlatformTimer, PlatformGPIO and PlatformPowerSave functions PlatformI2C uses, running off that clock.
+ * Slave mode is not simulated.
+ *
+ * Created: 2026-10-18 8:51:26 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMI2CHOST_H_
+#define PLATFORMI2CHOST_H_
+
+#ifdef PLATFORM_I2C_HOST
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Maximum number of slave models on the simulated bus
+#define PLATFORM_I2C_HOST_MAX_SLAVES ( 8 )
+
+//=====================================//
+//    Simulated Registers & Vectors    //
+//=====================================//
+
+extern uint8_t TWCR;
+extern uint8_t TWDR;
+extern uint8_t TWSR;
+extern uint8_t TWAR;
+extern uint8_t TWBR;
+extern uint8_t PORTC; // Only the SDA and SCL bits, kept by the PlatformGPIO stand-in
+
+// TWCR
+#define TWINT ( 7 )
+#define TWEA  ( 6 )
+#define TWSTA ( 5 )
+#define TWSTO ( 4 )
+#define TWWC  ( 3 )
+#define TWEN  ( 2 )
+#define TWIE  ( 0 )
+
+// TWSR
+#define TWS7  ( 7 )
+#define TWS6  ( 6 )
+#define TWS5  ( 5 )
+#define TWS4  ( 4 )
+#define TWS3  ( 3 )
+#define TWPS1 ( 1 )
+#define TWPS0 ( 0 )
+
+// TWAR
+#define TWGCE ( 0 )
+
+#define PLATFORM_I2C_WRITE_TWCR( VALUE ) PlatformI2CHost_WriteTWCR( VALUE )
+
+// The TWI ISR becomes a function, called by the simulation while global interrupts are enabled
+#undef  ISR
+#define ISR( VECTOR ) void PlatformI2CHost_TWIInterrupt( void )
+
+#define PlatformInterrupt_AreGlobalInterruptsEnabled() PlatformI2CHost_AreInterruptsEnabled()
+#define PlatformInterrupt_EnableGlobalInterrupts()     PlatformI2CHost_SetInterruptsEnabled( true )
+#define PlatformInterrupt_DisableGlobalInterrupts()    PlatformI2CHost_SetInterruptsEnabled( false )
+
+#define _delay_us( US ) PlatformI2CHost_DelayMicroseconds( US )
+
+void PlatformI2CHost_WriteTWCR( const uint8_t inValue );
+void PlatformI2CHost_TWIInterrupt( void );
+bool PlatformI2CHost_AreInterruptsEnabled( void );
+void PlatformI2CHost_SetInterruptsEnabled( const bool inIsEnabled );
+void PlatformI2CHost_DelayMicroseconds( const uint32_t inMicroseconds );
+
+//====================//
+//    Slave Models    //
+//====================//
+
+typedef struct PlatformI2CHostSlave PlatformI2CHostSlave_t;
+
+/*!
+ *\brief    Simulated slave device. Fill in the callbacks to write a new model, or use one of the models below.
+ *
+ *\details  The slave answers deviceAddr to deviceAddr + numAddresses - 1. The fault fields apply to any model.
+ */
+struct PlatformI2CHostSlave
+{
+	uint8_t  deviceAddr;
+	uint8_t  numAddresses;
+	
+	// Called when addressed after a (repeated) START. Returns false to NACK the address.
+	bool    ( *start )( PlatformI2CHostSlave_t *const inSlave, const uint8_t inDeviceAddr, const bool inIsRead );
+	// Called for each byte the master writes. Returns false to NACK it.
+	bool    ( *write )( PlatformI2CHostSlave_t *const inSlave, const uint8_t inByte );
+	// Called for each byte the master reads.
+	uint8_t ( *read )( PlatformI2CHostSlave_t *const inSlave );
+	// Called on STOP. May be NULL.
+	void    ( *stop )( PlatformI2CHostSlave_t *const inSlave );
+	
+	// Faults
+	bool     isNACKingAddress; // Never acknowledge, as if absent
+	uint32_t stretchTicks;     // Extra CPU clock cycles the slave holds SCL low for on each byte
+	uint8_t  numBusHangs;      // Times the slave will hold SDA low after being addressed, until the bus is recovered
+};
+
+/*!
+ *\brief    Register file with an 8- or 16-bit register pointer that auto-increments. Bytes past the end are NACKed on write and read as 0xFF.
+ */
+typedef struct
+{
+	PlatformI2CHostSlave_t slave; // Must be first
+	uint8_t               *registers;
+	uint16_t               numRegisters;
+	uint8_t                addressLen;
+	uint16_t               pointer;
+	uint8_t                numAddressBytes; // Received since the last START
+} PlatformI2CHostRegisterFile_t;
+
+/*!
+ *\brief    24Cxx EEPROM. Writes wrap within the page, and start a write cycle at the STOP, during which the device NACKs its address.
+ *          Address bits above addressLen bytes select the block through the device address.
+ */
+typedef struct
+{
+	PlatformI2CHostSlave_t slave; // Must be first
+	uint8_t               *memory;
+	uint32_t               size;
+	uint8_t                addressLen;
+	uint16_t               pageSize;
+	uint32_t               writeCycleTicks;
+	uint32_t               busyUntilTicks;
+	uint32_t               address;
+	uint8_t                numAddressBytes; // Received since the last START
+	bool                   isWritten;       // Data was written since the last START
+} PlatformI2CHostEEPROM_t;
+
+typedef struct
+{
+	uint32_t numStarts;       // Including repeated STARTs
+	uint32_t numStops;
+	uint32_t numAddressNACKs;
+	uint32_t numBytes;        // Address and data bytes
+	uint32_t busTicks;        // Simulated CPU clock cycles spent on the bus
+	uint32_t numRecoveryClocks;
+} PlatformI2CHostStats_t;
+
+//===========//
+//    API    //
+//===========//
+
+/*!
+ *\brief    Removes every slave, and resets the simulated registers, clock and statistics. Call before PlatformI2C_Init().
+ */
+void PlatformI2CHost_Reset( void );
+
+/*!
+ *\brief    Adds a slave model to the bus.
+ *
+ *\param    inSlave - Slave to add, which must stay valid until PlatformI2CHost_Reset().
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if inSlave is NULL. PlatformStatus_Failed if the bus is full.
+ */
+PlatformStatus PlatformI2CHost_AddSlave( PlatformI2CHostSlave_t *const inSlave );
+
+/*!
+ *\brief    Sets up a register file model.
+ */
+void PlatformI2CHost_InitRegisterFile( PlatformI2CHostRegisterFile_t *const outModel, 
+                                       const uint8_t inDeviceAddr, 
+                                       uint8_t *const inRegisters, 
+                                       const uint16_t inNumRegisters, 
+                                       const uint8_t inAddressLen );
+
+/*!
+ *\brief    Sets up an EEPROM model, with enough device addresses for its size.
+ */
+void PlatformI2CHost_InitEEPROM( PlatformI2CHostEEPROM_t *const outModel, 
+                                 const uint8_t inDeviceAddr, 
+                                 uint8_t *const inMemory, 
+                                 const uint32_t inSize, 
+                                 const uint8_t inAddressLen, 
+                                 const uint16_t inPageSize, 
+                                 const uint32_t inWriteCycleTicks );
+
+/*!
+ *\brief    Gets the bus statistics since the last reset.
+ */
+void PlatformI2CHost_GetStats( PlatformI2CHostStats_t *const outStats );
+
+/*!
+ *\brief    Gets the simulated clock, in CPU clock cycles. This is also what PlatformTimer_GetTicks() returns.
+ */
+uint32_t PlatformI2CHost_GetTicks( void );
+
+/*!
+ *\brief    Sets whether the PlatformTimer stand-in behaves as initialized. It is initialized after PlatformI2CHost_Reset().
+ */
+void PlatformI2CHost_SetTimerInitialized( const bool inIsInitialized );
+
+#endif /* PLATFORM_I2C_HOST */
+
+#endif /* PLATFORMI2CHOST_H_ */
\ No newline at end of file
@@ -0,0 +1,233 @@
+/*
+ * PlatformI2CRegCache.c
+ *
+ * Created: 2026-10-18 7:22:31 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformI2CRegCache.h"
+#include "PlatformI2C.h"
+#include "require_macros.h"
+#include <stddef.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define GET_REG_MASK( INDEX ) ( 1UL << ( INDEX ))
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static bool _PlatformI2CRegCache_GetIndex( const PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, uint8_t *const outIndex );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformI2CRegCache_Init( PlatformI2CRegCache_t *const outCache, 
+                                         const uint8_t inDeviceAddr, 
+                                         const uint8_t inFirstRegister, 
+                                         uint8_t *const inShadow, 
+                                         const uint8_t inNumRegisters, 
+                                         const bool inIsAutoIncrement )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( outCache, exit );
+	require_quiet( inShadow, exit );
+	require_quiet(( inNumRegisters > 0 ) && ( inNumRegisters <= PLATFORM_I2C_REG_CACHE_MAX_REGISTERS ), exit );
+	require_quiet(( inFirstRegister + inNumRegisters - 1 ) <= UINT8_MAX, exit );
+	
+	outCache->deviceAddr      = inDeviceAddr;
+	outCache->firstRegister   = inFirstRegister;
+	outCache->numRegisters    = inNumRegisters;
+	outCache->isAutoIncrement = inIsAutoIncrement;
+	outCache->shadow          = inShadow;
+	outCache->validMask       = 0;
+	outCache->dirtyMask       = 0;
+	outCache->volatileMask    = 0;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CRegCache_SetVolatile( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, const bool inIsVolatile )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint8_t index;
+	
+	require_quiet( _PlatformI2CRegCache_GetIndex( inCache, inRegister, &index ), exit );
+	
+	if ( inIsVolatile )
+	{
+		// A pending write is kept, and written by the next flush
+		inCache->volatileMask |= GET_REG_MASK( index );
+	}
+	else
+	{
+		inCache->volatileMask &= ~GET_REG_MASK( index );
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CRegCache_Read( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, uint8_t *const outValue )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint8_t index;
+	
+	require_quiet( outValue, exit );
+	require_quiet( _PlatformI2CRegCache_GetIndex( inCache, inRegister, &index ), exit );
+	
+	if ( inCache->volatileMask & GET_REG_MASK( index ))
+	{
+		status = PlatformI2C_Read( inCache->deviceAddr, inRegister, outValue, 1 );
+		require_noerr_quiet( status, exit );
+	}
+	else
+	{
+		if ( !( inCache->validMask & GET_REG_MASK( index )))
+		{
+			status = PlatformI2C_Read( inCache->deviceAddr, inRegister, &inCache->shadow[ index ], 1 );
+			require_noerr_quiet( status, exit );
+			
+			inCache->validMask |= GET_REG_MASK( index );
+		}
+		
+		*outValue = inCache->shadow[ index ];
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CRegCache_Write( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, const uint8_t inValue )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint8_t index;
+	
+	require_quiet( _PlatformI2CRegCache_GetIndex( inCache, inRegister, &index ), exit );
+	
+	if ( inCache->volatileMask & GET_REG_MASK( index ))
+	{
+		status = PlatformI2C_WriteByte( inCache->deviceAddr, inRegister, inValue );
+		require_noerr_quiet( status, exit );
+	}
+	else
+	{
+		inCache->shadow[ index ] = inValue;
+		inCache->validMask |= GET_REG_MASK( index );
+		inCache->dirtyMask |= GET_REG_MASK( index );
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CRegCache_Update( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, const uint8_t inMask, const uint8_t inValue )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	uint8_t value;
+	
+	status = PlatformI2CRegCache_Read( inCache, inRegister, &value );
+	require_noerr_quiet( status, exit );
+	
+	value = ( value & ~inMask ) | ( inValue & inMask );
+	
+	status = PlatformI2CRegCache_Write( inCache, inRegister, value );
+	require_noerr_quiet( status, exit );
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CRegCache_Flush( PlatformI2CRegCache_t *const inCache )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	PlatformI2CSegment_t segments[ PLATFORM_I2C_REG_CACHE_FLUSH_SEGMENTS ];
+	uint8_t index = 0;
+	
+	require_quiet( inCache, exit );
+	
+	status = PlatformStatus_Success;
+	
+	while ( inCache->dirtyMask )
+	{
+		uint32_t batchMask   = 0;
+		uint8_t  numSegments = 0;
+		
+		// Collect runs of dirty registers, one per segment, until the segments run out
+		while (( index < inCache->numRegisters ) && ( numSegments < PLATFORM_I2C_REG_CACHE_FLUSH_SEGMENTS ))
+		{
+			PlatformI2CSegment_t *const segment = &segments[ numSegments ];
+			
+			if ( !( inCache->dirtyMask & GET_REG_MASK( index )))
+			{
+				index++;
+				continue;
+			}
+			
+			segment->direction          = PlatformI2CDirection_Write;
+			segment->registerAddress    = inCache->firstRegister + index;
+			segment->registerAddressLen = 1;
+			segment->data               = &inCache->shadow[ index ];
+			segment->dataLen            = 0;
+			
+			do
+			{
+				batchMask |= GET_REG_MASK( index );
+				segment->dataLen++;
+				index++;
+			} while ( inCache->isAutoIncrement && ( index < inCache->numRegisters ) && ( inCache->dirtyMask & GET_REG_MASK( index )));
+			
+			numSegments++;
+		}
+		
+		status = PlatformI2C_Transfer( inCache->deviceAddr, segments, numSegments );
+		require_noerr_quiet( status, exit );
+		
+		inCache->dirtyMask &= ~batchMask;
+	}
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformI2CRegCache_Invalidate( PlatformI2CRegCache_t *const inCache )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inCache, exit );
+	
+	inCache->validMask = 0;
+	inCache->dirtyMask = 0;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static bool _PlatformI2CRegCache_GetIndex( const PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, uint8_t *const outIndex )
+{
+	bool isCached = false;
+	
+	require_quiet( inCache, exit );
+	require_quiet(( inRegister >= inCache->firstRegister ) && (( inRegister - inCache->firstRegister ) < inCache->numRegisters ), exit );
+	
+	*outIndex = inRegister - inCache->firstRegister;
+	
+	isCached = true;
+exit:
+	return isCached;
+}
\ No newline at end of file
@@ -0,0 +1,135 @@
+/*
+ * PlatformI2CRegCache.h
+ *
+ * Shadow copy of a range of registers in an I2C device, to avoid reading back registers only this side writes.
+ * Writes are held in the shadow until PlatformI2CRegCache_Flush(), which writes every dirty register in as few transactions as possible.
+ * Registers the device changes by itself, such as status or data registers, must be marked volatile so they always go to the bus.
+ *
+ * Created: 2026-10-18 7:22:05 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMI2CREGCACHE_H_
+#define PLATFORMI2CREGCACHE_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Each register has one bit in the valid, dirty and volatile masks
+#define PLATFORM_I2C_REG_CACHE_MAX_REGISTERS ( 32 )
+
+// Maximum number of runs of dirty registers written in one transaction by PlatformI2CRegCache_Flush()
+#ifndef PLATFORM_I2C_REG_CACHE_FLUSH_SEGMENTS
+#define PLATFORM_I2C_REG_CACHE_FLUSH_SEGMENTS ( 8 )
+#endif
+
+/*!
+ *\brief    Register cache for one device. Set up with PlatformI2CRegCache_Init(); the fields are managed by PlatformI2CRegCache.
+ */
+typedef struct
+{
+	uint8_t  deviceAddr;
+	uint8_t  firstRegister;   // Register address of shadow[ 0 ]
+	uint8_t  numRegisters;
+	bool     isAutoIncrement; // Whether the device moves to the next register after each byte, so a run of registers can be written at once
+	uint8_t *shadow;          // Caller owned, numRegisters bytes
+	uint32_t validMask;       // Registers whose shadow matches the device, or will once flushed
+	uint32_t dirtyMask;       // Registers written to the shadow, but not yet to the device
+	uint32_t volatileMask;    // Registers that bypass the cache
+} PlatformI2CRegCache_t;
+
+/*!
+ *\brief    Sets up a cache for registers firstRegister to firstRegister + numRegisters - 1 of a device. Nothing is cached or volatile to begin with.
+ *
+ *\param    outCache          - Cache to set up.
+ *\param    inDeviceAddr      - Address of the I2C device.
+ *\param    inFirstRegister   - Address of the first register to cache.
+ *\param    inShadow          - Buffer of inNumRegisters bytes for the shadow copy, which must stay valid while the cache is used.
+ *\param    inNumRegisters    - Number of registers to cache, 1 - PLATFORM_I2C_REG_CACHE_MAX_REGISTERS.
+ *\param    inIsAutoIncrement - Whether the device moves to the next register after each byte written.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if a pointer is NULL, or the register count is out of range.
+ */
+PlatformStatus PlatformI2CRegCache_Init( PlatformI2CRegCache_t *const outCache, 
+                                         const uint8_t inDeviceAddr, 
+                                         const uint8_t inFirstRegister, 
+                                         uint8_t *const inShadow, 
+                                         const uint8_t inNumRegisters, 
+                                         const bool inIsAutoIncrement );
+
+/*!
+ *\brief    Marks a register as volatile, so reads and writes always go to the bus, or returns it to being cached.
+ *
+ *\param    inCache      - Cache to change.
+ *\param    inRegister   - Register address.
+ *\param    inIsVolatile - true to bypass the cache for this register.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the register is not in the cache.
+ */
+PlatformStatus PlatformI2CRegCache_SetVolatile( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, const bool inIsVolatile );
+
+/*!
+ *\brief    Reads a register, from the shadow if it is cached, otherwise from the device.
+ *
+ *\param    inCache    - Cache to read through.
+ *\param    inRegister - Register address.
+ *\param    outValue   - Pointer to store the value.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the register is not in the cache.
+ *          Otherwise, the status of PlatformI2C_Read().
+ */
+PlatformStatus PlatformI2CRegCache_Read( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, uint8_t *const outValue );
+
+/*!
+ *\brief    Writes a register. Cached registers are only written to the shadow and marked dirty; volatile registers are written to the device immediately.
+ *
+ *\param    inCache    - Cache to write through.
+ *\param    inRegister - Register address.
+ *\param    inValue    - Value to write.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the register is not in the cache.
+ *          Otherwise, the status of PlatformI2C_WriteByte().
+ */
+PlatformStatus PlatformI2CRegCache_Write( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, const uint8_t inValue );
+
+/*!
+ *\brief    Changes some bits of a register: ( value & ~inMask ) | ( inValue & inMask ).
+ *
+ *\details  Once the register is cached this does not touch the bus; the register is written by the next flush.
+ *
+ *\param    inCache    - Cache to update through.
+ *\param    inRegister - Register address.
+ *\param    inMask     - Bits to change.
+ *\param    inValue    - New value of the bits to change.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if the register is not in the cache.
+ *          Otherwise, the status of the bus read or write.
+ */
+PlatformStatus PlatformI2CRegCache_Update( PlatformI2CRegCache_t *const inCache, const uint8_t inRegister, const uint8_t inMask, const uint8_t inValue );
+
+/*!
+ *\brief    Writes every dirty register to the device.
+ *
+ *\details  With an auto-incrementing device, each run of consecutive dirty registers is written as one segment,
+ *          and up to PLATFORM_I2C_REG_CACHE_FLUSH_SEGMENTS segments are written in one transaction.
+ *          Registers stay dirty if their transaction fails, so the flush can be retried.
+ *
+ *\param    inCache - Cache to flush.
+ *
+ *\return   PlatformStatus_Success if every dirty register was written. PlatformStatus_InvalidArgument if inCache is NULL.
+ *          Otherwise, the status of the first PlatformI2C_Transfer() that failed.
+ */
+PlatformStatus PlatformI2CRegCache_Flush( PlatformI2CRegCache_t *const inCache );
+
+/*!
+ *\brief    Forgets every cached and dirty value, e.g. after the device was reset. Volatile registers stay volatile.
+ *
+ *\param    inCache - Cache to invalidate.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if inCache is NULL.
+ */
+PlatformStatus PlatformI2CRegCache_Invalidate( PlatformI2CRegCache_t *const inCache );
+
+#endif /* PLATFORMI2CREGCACHE_H_ */
\ No newline at end of file
@@ -0,0 +1,282 @@
+/*
+ * PlatformInputCapture.c
+ *
+ * Created: 2026-10-18 9:13:47 AM
+ *  Author: Felix
+ */ 
+
+#include "PlatformInputCapture.h"
+#include "PlatformTimer.h"
+#include "PlatformClock.h"
+#include "PlatformGPIO.h"
+#include "PlatformInterrupt.h"
+#include "require_macros.h"
+#include <avr/io.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_INPUT_CAPTURE_PIN                ( PlatformGPIO_PTB0 )
+
+#define PLATFORM_INPUT_CAPTURE_FREQ_DECIMALS      ( 3 ) // Frequency is reported in mHz
+#define PLATFORM_INPUT_CAPTURE_DUTY_CYCLE_MAX     ( 1000 )
+
+//================//
+//    Typedefs    //
+//================//
+
+typedef struct
+{
+	uint32_t lastRiseTimestamp;
+	uint32_t lastFallTimestamp;
+	uint32_t periodTicks;
+	uint32_t highTicks;
+	bool     isLastRiseValid;
+	bool     isLastFallValid;
+	bool     isPeriodValid;
+	bool     isHighValid;
+} PlatformInputCaptureHistory_t;
+
+//==================================//
+//    Static Structs & Variables    //
+//==================================//
+
+static bool                          mPlatformInputCaptureIsInitialized;
+static PlatformInputCaptureEdge_t    mPlatformInputCaptureEdge;
+static PlatformRingBuffer*           mPlatformInputCaptureRingBuffer;
+static volatile bool                 mPlatformInputCaptureEventsDropped; // Set in ISR
+static PlatformInputCaptureHistory_t mPlatformInputCaptureHistory;
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void     _PlatformInputCapture_ProcessEvent( const PlatformInputCaptureEvent_t *const inEvent );
+static uint32_t _PlatformInputCapture_GetFrequencyMilliHz( uint32_t inPeriodTicks );
+static uint16_t _PlatformInputCapture_GetDutyCyclePermille( uint32_t inHighTicks, uint32_t inPeriodTicks );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformInputCapture_Init( PlatformInputCaptureEdge_t inEdge, bool inEnableNoiseCanceler, PlatformRingBuffer *const inRingBuffer )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	uint32_t       ticks;
+	
+	require_action_quiet( !mPlatformInputCaptureIsInitialized, exit, status = PlatformStatus_AlreadyInitialized );
+	require_quiet( inEdge <= PlatformInputCaptureEdge_Both, exit );
+	require_quiet( inRingBuffer, exit );
+	
+	// Timer1 must already be running for PlatformTimer, since the capture timestamps are based on its tick count
+	status = PlatformTimer_GetTicks( &ticks );
+	require_noerr_quiet( status, exit );
+	
+	// Configure ICP1 as an input
+	status = PlatformGPIO_Configure( PLATFORM_INPUT_CAPTURE_PIN, PlatformGPIOConfig_InputHighZ );
+	require_noerr_quiet( status, exit );
+	
+	mPlatformInputCaptureEdge          = inEdge;
+	mPlatformInputCaptureRingBuffer    = inRingBuffer;
+	mPlatformInputCaptureEventsDropped = false;
+	mPlatformInputCaptureHistory       = ( PlatformInputCaptureHistory_t ){ 0 };
+	
+	// Set the noise canceler
+	if ( inEnableNoiseCanceler )
+	{
+		TCCR1B |= ( 1 << ICNC1 );
+	}
+	else
+	{
+		TCCR1B &= ~( 1 << ICNC1 );
+	}
+	
+	// Set the first edge to capture. When capturing both edges, the ISR will alternate the edge after each capture.
+	if ( inEdge == PlatformInputCaptureEdge_Falling )
+	{
+		TCCR1B &= ~( 1 << ICES1 );
+	}
+	else
+	{
+		TCCR1B |= ( 1 << ICES1 );
+	}
+	
+	// Changing the edge can set the capture flag, so clear it before enabling the capture interrupt
+	TIFR1 = ( 1 << ICF1 );
+	TIMSK1 |= ( 1 << ICIE1 );
+	
+	mPlatformInputCaptureIsInitialized = true;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformInputCapture_ReadEvent( PlatformInputCaptureEvent_t *const outEvent )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	require_action_quiet( mPlatformInputCaptureIsInitialized, exit, status = PlatformStatus_NotInitialized );
+	require_quiet( outEvent, exit );
+	
+	status = PlatformRingBuffer_ReadBuffer( mPlatformInputCaptureRingBuffer, ( uint8_t* )outEvent, sizeof( PlatformInputCaptureEvent_t ));
+	require_noerr_quiet( status, exit );
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformInputCapture_GetMeasurement( PlatformInputCaptureMeasurement_t *const outMeasurement )
+{
+	PlatformStatus              status = PlatformStatus_Failed;
+	PlatformInputCaptureEvent_t event;
+	
+	require_action_quiet( mPlatformInputCaptureIsInitialized, exit, status = PlatformStatus_NotInitialized );
+	require_quiet( outMeasurement, exit );
+	
+	// If any edges were dropped, the stored edges are no longer consecutive; restart the history
+	if ( mPlatformInputCaptureEventsDropped )
+	{
+		mPlatformInputCaptureEventsDropped = false;
+		mPlatformInputCaptureHistory       = ( PlatformInputCaptureHistory_t ){ 0 };
+	}
+	
+	// Consume every captured edge
+	while ( PlatformRingBuffer_ReadBuffer( mPlatformInputCaptureRingBuffer, ( uint8_t* )&event, sizeof( event )) == PlatformStatus_Success )
+	{
+		_PlatformInputCapture_ProcessEvent( &event );
+	}
+	
+	require_quiet( mPlatformInputCaptureHistory.isPeriodValid, exit );
+	
+	outMeasurement->periodTicks       = mPlatformInputCaptureHistory.periodTicks;
+	outMeasurement->frequencyMilliHz  = _PlatformInputCapture_GetFrequencyMilliHz( mPlatformInputCaptureHistory.periodTicks );
+	outMeasurement->highTicks         = 0;
+	outMeasurement->dutyCyclePermille = 0;
+	
+	if ( mPlatformInputCaptureHistory.isHighValid )
+	{
+		outMeasurement->highTicks         = mPlatformInputCaptureHistory.highTicks;
+		outMeasurement->dutyCyclePermille = _PlatformInputCapture_GetDutyCyclePermille( mPlatformInputCaptureHistory.highTicks, 
+		                                                                                mPlatformInputCaptureHistory.periodTicks );
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformInputCapture_Deinit( void )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	require_action_quiet( mPlatformInputCaptureIsInitialized, exit, status = PlatformStatus_NotInitialized );
+	
+	// Disable the capture interrupt and restore the default capture settings. Timer1 itself is owned by PlatformTimer.
+	TIMSK1 &= ~( 1 << ICIE1 );
+	TCCR1B &= ~(( 1 << ICNC1 ) | ( 1 << ICES1 ));
+	TIFR1   = ( 1 << ICF1 );
+	
+	mPlatformInputCaptureRingBuffer    = NULL;
+	mPlatformInputCaptureIsInitialized = false;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static void _PlatformInputCapture_ProcessEvent( const PlatformInputCaptureEvent_t *const inEvent )
+{
+	PlatformInputCaptureHistory_t *const history = &mPlatformInputCaptureHistory;
+	
+	if ( inEvent->isRisingEdge )
+	{
+		// The period is measured between rising edges, unless only falling edges are captured
+		if ( history->isLastRiseValid )
+		{
+			history->periodTicks   = inEvent->timestamp - history->lastRiseTimestamp;
+			history->isPeriodValid = true;
+		}
+		
+		history->lastRiseTimestamp = inEvent->timestamp;
+		history->isLastRiseValid   = true;
+	}
+	else
+	{
+		if (( mPlatformInputCaptureEdge == PlatformInputCaptureEdge_Falling ) && history->isLastFallValid )
+		{
+			history->periodTicks   = inEvent->timestamp - history->lastFallTimestamp;
+			history->isPeriodValid = true;
+		}
+		
+		// The high time is measured from the previous rising edge
+		if ( history->isLastRiseValid )
+		{
+			history->highTicks   = inEvent->timestamp - history->lastRiseTimestamp;
+			history->isHighValid = true;
+		}
+		
+		history->lastFallTimestamp = inEvent->timestamp;
+		history->isLastFallValid   = true;
+	}
+}
+
+static uint32_t _PlatformInputCapture_GetFrequencyMilliHz( uint32_t inPeriodTicks )
+{
+	uint32_t frequency = ( uint32_t )F_CPU / inPeriodTicks;
+	uint32_t remainder = ( uint32_t )F_CPU % inPeriodTicks;
+	
+	// Long division for the fractional digits, which avoids 64-bit math. Valid for periods up to ~50 seconds.
+	for ( uint8_t i = 0; i < PLATFORM_INPUT_CAPTURE_FREQ_DECIMALS; i++ )
+	{
+		remainder *= 10;
+		frequency  = ( frequency * 10 ) + ( remainder / inPeriodTicks );
+		remainder %= inPeriodTicks;
+	}
+	
+	return frequency;
+}
+
+static uint16_t _PlatformInputCapture_GetDutyCyclePermille( uint32_t inHighTicks, uint32_t inPeriodTicks )
+{
+	uint32_t dutyCycle;
+	
+	// Scale both values down until the multiplication cannot overflow
+	while ( inHighTicks > ( UINT32_MAX / PLATFORM_INPUT_CAPTURE_DUTY_CYCLE_MAX ))
+	{
+		inHighTicks   >>= 1;
+		inPeriodTicks >>= 1;
+	}
+	
+	dutyCycle = ( inHighTicks * PLATFORM_INPUT_CAPTURE_DUTY_CYCLE_MAX ) / inPeriodTicks;
+	
+	// The high time can only exceed the period if an edge was missed
+	return ( dutyCycle > PLATFORM_INPUT_CAPTURE_DUTY_CYCLE_MAX ) ? PLATFORM_INPUT_CAPTURE_DUTY_CYCLE_MAX : ( uint16_t )dutyCycle;
+}
+
+ISR( TIMER1_CAPT_vect )
+{
+	PlatformInputCaptureEvent_t event;
+	
+	// Read the captured count and the edge it was captured on
+	event.timestamp    = PlatformTimer_GetTicksFromCount( ICR1 );
+	event.isRisingEdge = ( TCCR1B & ( 1 << ICES1 )) ? 1 : 0;
+	
+	// When capturing both edges, switch to the opposite edge. Changing the edge can set the capture flag, so clear it.
+	if ( mPlatformInputCaptureEdge == PlatformInputCaptureEdge_Both )
+	{
+		TCCR1B ^= ( 1 << ICES1 );
+		TIFR1   = ( 1 << ICF1 );
+	}
+	
+	// Push the event into the ring buffer
+	if ( PlatformRingBuffer_WriteBuffer( mPlatformInputCaptureRingBuffer, ( uint8_t* )&event, sizeof( event )) != PlatformStatus_Success )
+	{
+		mPlatformInputCaptureEventsDropped = true;
+	}
+}
\ No newline at end of file
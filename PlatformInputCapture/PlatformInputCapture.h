@@ -0,0 +1,89 @@
+/*
+ * PlatformInputCapture.h
+ *
+ * Input capture runs off the ICP1 pin (PB0) of the 16-bit Timer/Counter1, alongside PlatformTimer.
+ * Edges are timestamped in hardware and pushed into a ring buffer from the capture ISR, 
+ * so no edges are missed while the main loop is busy.
+ *
+ * Created: 2026-10-18 9:14:02 AM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMINPUTCAPTURE_H_
+#define PLATFORMINPUTCAPTURE_H_
+
+#include "PlatformStatus.h"
+#include "PlatformRingBuffer.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum
+{
+	PlatformInputCaptureEdge_Rising,
+	PlatformInputCaptureEdge_Falling,
+	PlatformInputCaptureEdge_Both,
+} PlatformInputCaptureEdge_t;
+
+typedef struct
+{
+	uint32_t timestamp;    // Timer1 ticks, see PlatformTimer_GetTicks()
+	uint8_t  isRisingEdge;
+} PlatformInputCaptureEvent_t;
+
+typedef struct
+{
+	uint32_t periodTicks;       // Ticks between two consecutive edges of the same direction
+	uint32_t highTicks;         // Ticks from a rising edge to the following falling edge. Only valid with PlatformInputCaptureEdge_Both.
+	uint32_t frequencyMilliHz;  // F_CPU / periodTicks, in mHz
+	uint16_t dutyCyclePermille; // highTicks / periodTicks, from 0 to 1000. Only valid with PlatformInputCaptureEdge_Both.
+} PlatformInputCaptureMeasurement_t;
+
+/*!
+ *\brief    Initializes input capture on the ICP1 pin (PB0). PlatformTimer_Init() must be called first.
+ *
+ *\details  Each captured edge is written to the ring buffer as a PlatformInputCaptureEvent_t, 
+ *          so the ring buffer should be sized as a multiple of sizeof( PlatformInputCaptureEvent_t ).
+ *          Edges that arrive while the ring buffer is full are dropped, and the measurement history is restarted.
+ *
+ *\param    inEdge                - Edge(s) to capture.
+ *\param    inEnableNoiseCanceler - If true, the input must be stable for 4 CPU clock cycles before an edge is captured.
+ *\param    inRingBuffer          - Ring buffer to store the captured edge events.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success            if successful,
+ *                         - PlatformStatus_AlreadyInitialized if input capture has already been initialized,
+ *                         - PlatformStatus_NotInitialized     if PlatformTimer has not been initialized,
+ *                         - PlatformStatus_Failed             if anything else failed.
+ */
+PlatformStatus PlatformInputCapture_Init( PlatformInputCaptureEdge_t inEdge, bool inEnableNoiseCanceler, PlatformRingBuffer *const inRingBuffer );
+
+/*!
+ *\brief    Reads the oldest captured edge event from the ring buffer.
+ *
+ *\details  Events read with this function are no longer available to PlatformInputCapture_GetMeasurement().
+ *
+ *\param    outEvent - Pointer to store the event.
+ *
+ *\return   PlatformStatus_Success if an event was read. PlatformStatus_Failed if there are no events, or anything else failed.
+ */
+PlatformStatus PlatformInputCapture_ReadEvent( PlatformInputCaptureEvent_t *const outEvent );
+
+/*!
+ *\brief    Consumes all captured edge events and returns the latest period, frequency and duty cycle measurement.
+ *
+ *\param    outMeasurement - Pointer to store the measurement.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success        if successful,
+ *                         - PlatformStatus_NotInitialized if input capture has not been initialized,
+ *                         - PlatformStatus_Failed         if not enough edges have been captured yet, or anything else failed.
+ */
+PlatformStatus PlatformInputCapture_GetMeasurement( PlatformInputCaptureMeasurement_t *const outMeasurement );
+
+/*!
+ *\brief    Deinitializes input capture. Timer1 is left running for PlatformTimer.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if input capture has not been initialized.
+ */
+PlatformStatus PlatformInputCapture_Deinit( void );
+
+#endif /* PLATFORMINPUTCAPTURE_H_ */
\ No newline at end of file
@@ -6,8 +6,31 @@
  */ 
 
 #include "PlatformPowerSave.h"
+#include "PlatformInterrupt.h"
 #include "require_macros.h"
 #include <avr/io.h>
+#include <avr/sleep.h>
+#include <stdbool.h>
+
+#define PLATFORM_POWER_SAVE_SLEEP_MODE_MASK (( 1 << SM2 ) | ( 1 << SM1 ) | ( 1 << SM0 ))
+
+// Peripherals that stop working when the I/O clock is halted
+#define PLATFORM_POWER_SAVE_IO_CLOCK_PERIPHERALS_MASK (( 1 << PRTWI ) | ( 1 << PRTIM0 ) | ( 1 << PRTIM1 ) | ( 1 << PRSPI ) | ( 1 << PRUSART0 ))
+
+// Edge detection on INT0 and INT1 needs the I/O clock, so only a low level can wake the CPU from the deeper sleep modes
+#define PLATFORM_POWER_SAVE_IS_INT_EDGE_TRIGGERED( INT_BIT, ISC_SHIFT ) \
+	(( EIMSK & ( 1 << ( INT_BIT ))) && ( EICRA & ( 0x03 << ( ISC_SHIFT ))))
+
+// Sleep mode select bits, indexed by PlatformPowerSaveSleepMode_t
+static const uint8_t kPlatformPowerSaveSleepModeBits[] =
+{
+	0,                                              // Idle
+	( 1 << SM0 ),                                   // ADC Noise Reduction
+	( 1 << SM1 ),                                   // Power-down
+	( 1 << SM1 ) | ( 1 << SM0 ),                    // Power-save
+	( 1 << SM2 ) | ( 1 << SM1 ),                    // Standby
+	( 1 << SM2 ) | ( 1 << SM1 ) | ( 1 << SM0 ),     // Extended Standby
+};
 
 PlatformStatus PlatformPowerSave_PowerOnAllPeripherals( void )
 {
@@ -139,4 +162,59 @@ PlatformStatus PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral
 	status = PlatformStatus_Success;
 exit:
 	return status;
+}
+
+PlatformStatus PlatformPowerSave_Sleep( PlatformPowerSaveSleepMode_t inSleepMode )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inSleepMode < PlatformPowerSaveSleepMode_MaxModes, exit );
+	
+	// Select the sleep mode
+	SMCR = ( SMCR & ~PLATFORM_POWER_SAVE_SLEEP_MODE_MASK ) | kPlatformPowerSaveSleepModeBits[ inSleepMode ];
+	
+	// Enable sleep, then enable global interrupts. The instruction following sei() is always executed before any pending interrupt,
+	// so an interrupt that arrived after the caller disabled interrupts will wake the CPU immediately instead of being missed.
+	SMCR |= ( 1 << SE );
+	PlatformInterrupt_EnableGlobalInterrupts();
+	sleep_cpu();
+	
+	// Woken up; disable sleep to prevent accidentally sleeping again
+	SMCR &= ~( 1 << SE );
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformPowerSaveSleepMode_t PlatformPowerSave_GetDeepestSleepMode( void )
+{
+	PlatformPowerSaveSleepMode_t sleepMode;
+	uint8_t                      poweredOnPeripherals = ~PRR;
+	bool                         isTimer2Asynchronous = ( ASSR & ( 1 << AS2 )) ? true : false;
+	bool                         isADCConverting      = ( ADCSRA & (( 1 << ADSC ) | ( 1 << ADATE ) | ( 1 << ADIE ))) ? true : false;
+	bool                         isWaitingForEdge     = ( PLATFORM_POWER_SAVE_IS_INT_EDGE_TRIGGERED( INT0, ISC00 ) || 
+	                                                      PLATFORM_POWER_SAVE_IS_INT_EDGE_TRIGGERED( INT1, ISC10 )) ? true : false;
+	
+	if (( poweredOnPeripherals & PLATFORM_POWER_SAVE_IO_CLOCK_PERIPHERALS_MASK ) || 
+	   (( poweredOnPeripherals & ( 1 << PRTIM2 )) && !isTimer2Asynchronous ) || 
+	    isWaitingForEdge )
+	{
+		sleepMode = PlatformPowerSaveSleepMode_Idle;
+	}
+	else if (( poweredOnPeripherals & ( 1 << PRADC )) && isADCConverting )
+	{
+		// Entering ADC Noise Reduction mode with the ADC enabled starts a conversion, so only choose it when one is wanted
+		sleepMode = PlatformPowerSaveSleepMode_ADCNoiseReduction;
+	}
+	else if ( poweredOnPeripherals & ( 1 << PRTIM2 ))
+	{
+		sleepMode = PlatformPowerSaveSleepMode_PowerSave;
+	}
+	else
+	{
+		sleepMode = PlatformPowerSaveSleepMode_PowerDown;
+	}
+	
+	return sleepMode;
 }
\ No newline at end of file
@@ -23,6 +23,17 @@ typedef enum
 	PlatformPowerSavePeripheral_MaxPeripherals,
 } PlatformPowerSavePeripheral_t;
 
+typedef enum
+{
+	PlatformPowerSaveSleepMode_Idle = 0,
+	PlatformPowerSaveSleepMode_ADCNoiseReduction,
+	PlatformPowerSaveSleepMode_PowerDown,
+	PlatformPowerSaveSleepMode_PowerSave,
+	PlatformPowerSaveSleepMode_Standby,
+	PlatformPowerSaveSleepMode_ExtendedStandby,
+	PlatformPowerSaveSleepMode_MaxModes,
+} PlatformPowerSaveSleepMode_t;
+
 /*!
  *\brief    Enables power on to all peripherals. See enum PlatformPowerSavePeripheral_t for a list of peripherals. 
  *
@@ -55,6 +66,30 @@ PlatformStatus PlatformPowerSave_PowerOnPeripheral( PlatformPowerSavePeripheral_
  */
 PlatformStatus PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_t inDomain );
 
+/*!
+ *\brief    Puts the CPU to sleep in the specified sleep mode, until it is woken up by an interrupt.
+ *
+ *\details  Global interrupts are enabled immediately before sleeping, and remain enabled when this function returns.
+ *          To avoid missing a wake-up, disable global interrupts before checking whether there is work to do, then call this function;
+ *          an interrupt that arrives in between will wake the CPU up right away.
+ *          See the Power Management and Sleep Modes chapter of the ATmega328p datasheet for the clocks and wake-up sources available in each sleep mode.
+ *
+ *\param    inSleepMode - Sleep mode to enter.
+ *
+ *\return   PlatformStatus_Success after waking up. PlatformStatus_InvalidArgument if the sleep mode is invalid.
+ */
+PlatformStatus PlatformPowerSave_Sleep( PlatformPowerSaveSleepMode_t inSleepMode );
+
+/*!
+ *\brief    Gets the deepest sleep mode that keeps every powered-on peripheral running, based on the peripherals' power state.
+ *
+ *\details  Idle if any peripheral that needs the I/O clock is powered on, or INT0 or INT1 is enabled on an edge. ADC Noise Reduction if only the ADC (and an asynchronous Timer2) is powered on,
+ *          and a conversion is in progress or sampling is running. Otherwise Power-save if an asynchronous Timer2 is powered on, or Power-down.
+ *
+ *\return   PlatformPowerSaveSleepMode_t - Deepest safe sleep mode.
+ */
+PlatformPowerSaveSleepMode_t PlatformPowerSave_GetDeepestSleepMode( void );
+
 
 
 #endif /* PLATFORMPOWERSAVE_H_ */
\ No newline at end of file
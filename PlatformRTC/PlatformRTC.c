@@ -0,0 +1,333 @@
+/*
+ * PlatformRTC.c
+ *
+ * Created: 2026-10-18 10:21:18 AM
+ *  Author: Felix
+ */ 
+
+#include "PlatformRTC.h"
+#include "PlatformPowerSave.h"
+#include "require_macros.h"
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef PLATFORM_RTC_HOST
+// Simulated Timer2 registers and crystal, for testing on a host machine
+#include "PlatformRTCHost.h"
+#else
+#include "PlatformInterrupt.h"
+#include <avr/io.h>
+
+// Timer2 interrupt flags are cleared by writing ones to them. The host backend needs to see these writes, as a plain store would set the flags.
+#define PLATFORM_RTC_CLEAR_TIFR2( MASK ) ( TIFR2 = ( MASK ))
+#endif
+
+//===============//
+//    Defines    //
+//===============//
+
+// Prescale the 32.768kHz crystal by 128, so the 8-bit counter overflows once per second
+#define PLATFORM_RTC_PRESCALER_BITS     (( 1 << CS22 ) | ( 1 << CS20 ))
+
+#define PLATFORM_RTC_ASSR_BUSY_MASK     (( 1 << TCN2UB ) | ( 1 << OCR2AUB ) | ( 1 << OCR2BUB ) | ( 1 << TCR2AUB ) | ( 1 << TCR2BUB ))
+#define PLATFORM_RTC_TIFR2_MASK         (( 1 << OCF2B ) | ( 1 << OCF2A ) | ( 1 << TOV2 ))
+
+//==================================//
+//    Static Structs & Variables    //
+//==================================//
+
+static bool                mPlatformRTCIsInitialized;
+static bool                mPlatformRTCEnabledGlobalInterrupts;
+static volatile uint32_t   mPlatformRTCSeconds;      // Changed in ISR
+static volatile bool       mPlatformRTCAlarmEnabled; // Changed in ISR
+static uint32_t            mPlatformRTCAlarmSeconds;
+static uint32_t            mPlatformRTCAlarmIntervalSeconds;
+static PlatformRTC_AlarmCb mPlatformRTCAlarmCb;
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static inline void _PlatformRTC_WaitForRegisterUpdates( void );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformRTC_Init( const uint32_t inSeconds )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	require_action_quiet( !mPlatformRTCIsInitialized, exit, status = PlatformStatus_AlreadyInitialized );
+	
+	// Power on this peripheral
+	status = PlatformPowerSave_PowerOnPeripheral( PlatformPowerSavePeripheral_Timer2 );
+	require_noerr_quiet( status, exit );
+	
+	// Disable the Timer2 interrupts while the clock source is changed
+	TIMSK2 = 0;
+	
+	// Clock Timer2 asynchronously from the crystal oscillator on TOSC1/TOSC2
+	ASSR = ( ASSR & ~( 1 << EXCLK )) | ( 1 << AS2 );
+	
+	// Set normal mode, and the prescaler for one overflow per second
+	TCNT2  = 0;
+	TCCR2A = 0;
+	TCCR2B = PLATFORM_RTC_PRESCALER_BITS;
+	
+	// Wait for the new register values to be transferred to the asynchronous clock domain
+	_PlatformRTC_WaitForRegisterUpdates();
+	
+	// Changing the clock source may corrupt the interrupt flags, so clear them
+	PLATFORM_RTC_CLEAR_TIFR2( PLATFORM_RTC_TIFR2_MASK );
+	
+	mPlatformRTCSeconds      = inSeconds;
+	mPlatformRTCAlarmEnabled = false;
+	
+	// Enable the overflow interrupt
+	TIMSK2 = ( 1 << TOIE2 );
+	
+	// Enable global interrupts, if not already
+	if ( !PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		mPlatformRTCEnabledGlobalInterrupts = true;
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	
+	mPlatformRTCIsInitialized = true;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformRTC_GetTime( uint32_t *const outSeconds, uint8_t *const outSubSeconds )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
+	uint32_t seconds;
+	uint8_t  subSeconds;
+	
+	require_quiet( mPlatformRTCIsInitialized, exit );
+	require_action_quiet( outSeconds, exit, status = PlatformStatus_InvalidArgument );
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	subSeconds = TCNT2;
+	seconds    = mPlatformRTCSeconds;
+	
+	// If the overflow is pending but not yet serviced, a small count was read after the counter wrapped to 0
+	if (( TIFR2 & ( 1 << TOV2 )) && ( subSeconds < ( PLATFORM_RTC_SUB_SECONDS_PER_SECOND / 2 )))
+	{
+		seconds++;
+	}
+	
+	*outSeconds = seconds;
+	
+	if ( outSubSeconds )
+	{
+		*outSubSeconds = subSeconds;
+	}
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformRTC_SetTime( const uint32_t inSeconds )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( mPlatformRTCIsInitialized, exit );
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	// Restart the sub-second count, and drop any overflow that has not been serviced
+	TCNT2 = 0;
+	_PlatformRTC_WaitForRegisterUpdates();
+	PLATFORM_RTC_CLEAR_TIFR2( 1 << TOV2 );
+	
+	mPlatformRTCSeconds = inSeconds;
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformRTC_GetDateTime( PlatformRTCDateTime_t *const outDateTime )
+{
+	PlatformStatus status;
+	uint32_t seconds;
+	
+	status = PlatformRTC_GetTime( &seconds, NULL );
+	require_noerr_quiet( status, exit );
+	
+	status = PlatformRTCCalendar_SecondsToDateTime( seconds, outDateTime );
+	require_noerr_quiet( status, exit );
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformRTC_SetDateTime( const PlatformRTCDateTime_t *const inDateTime )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	uint32_t seconds;
+	
+	require_quiet( mPlatformRTCIsInitialized, exit );
+	
+	status = PlatformRTCCalendar_DateTimeToSeconds( inDateTime, &seconds );
+	require_noerr_quiet( status, exit );
+	
+	status = PlatformRTC_SetTime( seconds );
+	require_noerr_quiet( status, exit );
+	
+exit:
+	return status;
+}
+
+PlatformStatus PlatformRTC_SetAlarm( const uint32_t inAlarmSeconds, const uint32_t inRepeatIntervalSeconds, PlatformRTC_AlarmCb inAlarmCb )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	bool didDisableInterrupts = false;
+	
+	require_action_quiet( mPlatformRTCIsInitialized, exit, status = PlatformStatus_NotInitialized );
+	require_quiet( inAlarmCb, exit );
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	mPlatformRTCAlarmSeconds         = inAlarmSeconds;
+	mPlatformRTCAlarmIntervalSeconds = inRepeatIntervalSeconds;
+	mPlatformRTCAlarmCb              = inAlarmCb;
+	mPlatformRTCAlarmEnabled         = true;
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformRTC_CancelAlarm( void )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	
+	require_quiet( mPlatformRTCIsInitialized, exit );
+	
+	// A single byte write is atomic, so the ISR will not see a partially cancelled alarm
+	mPlatformRTCAlarmEnabled = false;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformRTC_PrepareForSleep( void )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	
+	require_quiet( mPlatformRTCIsInitialized, exit );
+	
+	// Rewrite a control register and wait for it to be synchronized, which guarantees at least one crystal cycle has passed since waking up
+	TCCR2A = TCCR2A;
+	_PlatformRTC_WaitForRegisterUpdates();
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformRTC_Deinit( void )
+{
+	PlatformStatus status = PlatformStatus_Failed;
+	
+	require_action_quiet( mPlatformRTCIsInitialized, exit, status = PlatformStatus_NotInitialized );
+	
+	// Disable global interrupts, if we enabled them during initialization
+	if ( mPlatformRTCEnabledGlobalInterrupts )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		mPlatformRTCEnabledGlobalInterrupts = false;
+	}
+	
+	// Disable the interrupts, and stop the timer clock
+	TIMSK2 = 0;
+	TCCR2B = 0;
+	_PlatformRTC_WaitForRegisterUpdates();
+	
+	// Switch back to the synchronous I/O clock
+	ASSR &= ~( 1 << AS2 );
+	PLATFORM_RTC_CLEAR_TIFR2( PLATFORM_RTC_TIFR2_MASK );
+	
+	// Disable this peripheral
+	status = PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_Timer2 );
+	require_noerr_quiet( status, exit );
+	
+	mPlatformRTCAlarmEnabled  = false;
+	mPlatformRTCIsInitialized = false;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static inline void _PlatformRTC_WaitForRegisterUpdates( void )
+{
+	// Each update busy flag is cleared once its register has been transferred to the asynchronous clock domain
+	while ( ASSR & PLATFORM_RTC_ASSR_BUSY_MASK );
+}
+
+ISR( TIMER2_OVF_vect )
+{
+	uint32_t seconds = mPlatformRTCSeconds + 1;
+	
+	mPlatformRTCSeconds = seconds;
+	
+	if ( mPlatformRTCAlarmEnabled && PlatformRTCCalendar_IsAlarmDue( seconds, mPlatformRTCAlarmSeconds ))
+	{
+		// Schedule the next occurrence, or disable a one-shot alarm
+		if ( mPlatformRTCAlarmIntervalSeconds )
+		{
+			mPlatformRTCAlarmSeconds = PlatformRTCCalendar_GetNextAlarm( mPlatformRTCAlarmSeconds, mPlatformRTCAlarmIntervalSeconds, seconds );
+		}
+		else
+		{
+			mPlatformRTCAlarmEnabled = false;
+		}
+		
+		mPlatformRTCAlarmCb( seconds );
+	}
+}
\ No newline at end of file
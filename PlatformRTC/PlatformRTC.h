@@ -0,0 +1,126 @@
+/*
+ * PlatformRTC.h
+ *
+ * This real-time clock runs off the 8-bit Timer/Counter2 in asynchronous mode, clocked by a 32.768kHz watch crystal on TOSC1/TOSC2 (PB6/PB7).
+ * Since Timer2 keeps running in Power-save sleep, time is kept while the rest of the chip is asleep, and the RTC can wake the CPU with alarms.
+ *
+ * The crystal pins are shared with the main clock's crystal pins, so the CPU must be clocked from the internal RC oscillator.
+ * Timer2 cannot be used for PWM (PlatformPWM_2A and PlatformPWM_2B) while the RTC is initialized.
+ *
+ * Created: 2026-10-18 10:21:36 AM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMRTC_H_
+#define PLATFORMRTC_H_
+
+#include "PlatformStatus.h"
+#include "PlatformRTCCalendar.h"
+#include <stdint.h>
+
+// Timer2 is prescaled by 128, so it counts 256 sub-second ticks and overflows once per second
+#define PLATFORM_RTC_SUB_SECONDS_PER_SECOND ( 256 )
+
+/*!
+ *\brief    Alarm callback; called from the Timer2 overflow ISR, so it should be kept short.
+ *
+ *\param    inSeconds - Time at which the alarm fired.
+ */
+typedef void ( *PlatformRTC_AlarmCb )( const uint32_t inSeconds );
+
+/*!
+ *\brief    Initializes the RTC and starts counting from a specified time.
+ *
+ *\details  The crystal oscillator needs about one second to stabilize after power-up, 
+ *          so the first second counted after initialization may be inaccurate.
+ *
+ *\param    inSeconds - Initial time, in seconds since the epoch ( see PlatformRTCCalendar.h ).
+ *
+ *\return   PlatformStatus - PlatformStatus_Success            if successful,
+ *                         - PlatformStatus_AlreadyInitialized if the RTC has already been initialized,
+ *                         - PlatformStatus_Failed             if anything else failed.
+ */
+PlatformStatus PlatformRTC_Init( const uint32_t inSeconds );
+
+/*!
+ *\brief    Gets the current time.
+ *
+ *\param    outSeconds    - Pointer to store the seconds since the epoch.
+ *\param    outSubSeconds - Optional pointer to store the fraction of the current second, in 1/256ths of a second. May be NULL.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the RTC has not been initialized.
+ */
+PlatformStatus PlatformRTC_GetTime( uint32_t *const outSeconds, uint8_t *const outSubSeconds );
+
+/*!
+ *\brief    Sets the current time. The sub-second count is restarted.
+ *
+ *\param    inSeconds - New time, in seconds since the epoch.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the RTC has not been initialized.
+ */
+PlatformStatus PlatformRTC_SetTime( const uint32_t inSeconds );
+
+/*!
+ *\brief    Gets the current time as a calendar date and time.
+ *
+ *\param    outDateTime - Pointer to store the date and time.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the RTC has not been initialized.
+ */
+PlatformStatus PlatformRTC_GetDateTime( PlatformRTCDateTime_t *const outDateTime );
+
+/*!
+ *\brief    Sets the current time from a calendar date and time.
+ *
+ *\param    inDateTime - New date and time.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success         if successful,
+ *                         - PlatformStatus_NotInitialized  if the RTC has not been initialized,
+ *                         - PlatformStatus_InvalidArgument if the date or time is out of range.
+ */
+PlatformStatus PlatformRTC_SetDateTime( const PlatformRTCDateTime_t *const inDateTime );
+
+/*!
+ *\brief    Sets an alarm, replacing any previous alarm. 
+ *
+ *\details  The Timer2 interrupt wakes the CPU from Power-save sleep once per second. 
+ *          The alarm callback is called from that interrupt at the first second at or after the alarm time.
+ *
+ *\param    inAlarmSeconds          - Alarm time, in seconds since the epoch.
+ *\param    inRepeatIntervalSeconds - If non-zero, the alarm repeats at this interval. Otherwise the alarm fires once.
+ *\param    inAlarmCb               - Callback to call when the alarm fires.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success        if successful,
+ *                         - PlatformStatus_NotInitialized if the RTC has not been initialized,
+ *                         - PlatformStatus_Failed         if anything else failed.
+ */
+PlatformStatus PlatformRTC_SetAlarm( const uint32_t inAlarmSeconds, const uint32_t inRepeatIntervalSeconds, PlatformRTC_AlarmCb inAlarmCb );
+
+/*!
+ *\brief    Cancels the current alarm, if any.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the RTC has not been initialized.
+ */
+PlatformStatus PlatformRTC_CancelAlarm( void );
+
+/*!
+ *\brief    Waits until the asynchronous Timer2 registers have synchronized. Must be called before entering Power-save sleep.
+ *
+ *\details  If Power-save sleep is re-entered within one crystal cycle of the Timer2 interrupt waking the CPU, 
+ *          the interrupt will not occur again and the CPU will not wake up.
+ *          See the asynchronous operation of Timer/Counter2 in the ATmega328p datasheet.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the RTC has not been initialized.
+ */
+PlatformStatus PlatformRTC_PrepareForSleep( void );
+
+/*!
+ *\brief    Deinitializes the RTC and stops Timer2.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the RTC has not been initialized.
+ */
+PlatformStatus PlatformRTC_Deinit( void );
+
+#endif /* PLATFORMRTC_H_ */
\ No newline at end of file
@@ -0,0 +1,165 @@
+/*
+ * PlatformRTCCalendar.c
+ *
+ * Created: 2026-10-18 10:03:10 AM
+ *  Author: Felix
+ */ 
+
+#include "PlatformRTCCalendar.h"
+#include "require_macros.h"
+#include <stddef.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_RTC_CALENDAR_SECONDS_PER_MINUTE ( 60UL )
+#define PLATFORM_RTC_CALENDAR_SECONDS_PER_HOUR   ( 3600UL )
+#define PLATFORM_RTC_CALENDAR_SECONDS_PER_DAY    ( 86400UL )
+#define PLATFORM_RTC_CALENDAR_DAYS_PER_WEEK      ( 7 )
+#define PLATFORM_RTC_CALENDAR_MONTHS_PER_YEAR    ( 12 )
+
+#define PLATFORM_RTC_CALENDAR_EPOCH_WEEKDAY      ( 6 ) // January 1st 2000 was a Saturday
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+static const uint8_t kPlatformRTCCalendarDaysPerMonth[ PLATFORM_RTC_CALENDAR_MONTHS_PER_YEAR ] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static inline bool     _PlatformRTCCalendar_IsLeapYear( const uint16_t inYear );
+static inline uint16_t _PlatformRTCCalendar_GetDaysInYear( const uint16_t inYear );
+static inline uint8_t  _PlatformRTCCalendar_GetDaysInMonth( const uint16_t inYear, const uint8_t inMonth );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformRTCCalendar_SecondsToDateTime( const uint32_t inSeconds, PlatformRTCDateTime_t *const outDateTime )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint32_t secondsOfDay;
+	uint32_t days;
+	uint16_t year  = PLATFORM_RTC_CALENDAR_EPOCH_YEAR;
+	uint8_t  month = 1;
+	
+	require_quiet( outDateTime, exit );
+	
+	days         = inSeconds / PLATFORM_RTC_CALENDAR_SECONDS_PER_DAY;
+	secondsOfDay = inSeconds % PLATFORM_RTC_CALENDAR_SECONDS_PER_DAY;
+	
+	outDateTime->weekday = ( uint8_t )(( days + PLATFORM_RTC_CALENDAR_EPOCH_WEEKDAY ) % PLATFORM_RTC_CALENDAR_DAYS_PER_WEEK );
+	
+	// Subtract whole years, then whole months, from the day count
+	while ( days >= _PlatformRTCCalendar_GetDaysInYear( year ))
+	{
+		days -= _PlatformRTCCalendar_GetDaysInYear( year );
+		year++;
+	}
+	
+	while ( days >= _PlatformRTCCalendar_GetDaysInMonth( year, month ))
+	{
+		days -= _PlatformRTCCalendar_GetDaysInMonth( year, month );
+		month++;
+	}
+	
+	outDateTime->year   = year;
+	outDateTime->month  = month;
+	outDateTime->day    = ( uint8_t )( days + 1 );
+	outDateTime->hour   = ( uint8_t )( secondsOfDay / PLATFORM_RTC_CALENDAR_SECONDS_PER_HOUR );
+	outDateTime->minute = ( uint8_t )(( secondsOfDay % PLATFORM_RTC_CALENDAR_SECONDS_PER_HOUR ) / PLATFORM_RTC_CALENDAR_SECONDS_PER_MINUTE );
+	outDateTime->second = ( uint8_t )( secondsOfDay % PLATFORM_RTC_CALENDAR_SECONDS_PER_MINUTE );
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformRTCCalendar_DateTimeToSeconds( const PlatformRTCDateTime_t *const inDateTime, uint32_t *const outSeconds )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	uint32_t days = 0;
+	
+	require_quiet( inDateTime, exit );
+	require_quiet( outSeconds, exit );
+	
+	// Validate each field
+	require_quiet(( inDateTime->year >= PLATFORM_RTC_CALENDAR_EPOCH_YEAR ) && ( inDateTime->year <= PLATFORM_RTC_CALENDAR_MAX_YEAR ), exit );
+	require_quiet(( inDateTime->month >= 1 ) && ( inDateTime->month <= PLATFORM_RTC_CALENDAR_MONTHS_PER_YEAR ), exit );
+	require_quiet(( inDateTime->day >= 1 ) && ( inDateTime->day <= _PlatformRTCCalendar_GetDaysInMonth( inDateTime->year, inDateTime->month )), exit );
+	require_quiet( inDateTime->hour   < 24, exit );
+	require_quiet( inDateTime->minute < 60, exit );
+	require_quiet( inDateTime->second < 60, exit );
+	
+	// Count the days before this date
+	for ( uint16_t year = PLATFORM_RTC_CALENDAR_EPOCH_YEAR; year < inDateTime->year; year++ )
+	{
+		days += _PlatformRTCCalendar_GetDaysInYear( year );
+	}
+	
+	for ( uint8_t month = 1; month < inDateTime->month; month++ )
+	{
+		days += _PlatformRTCCalendar_GetDaysInMonth( inDateTime->year, month );
+	}
+	
+	days += inDateTime->day - 1;
+	
+	*outSeconds = ( days * PLATFORM_RTC_CALENDAR_SECONDS_PER_DAY ) + 
+	              ( inDateTime->hour * PLATFORM_RTC_CALENDAR_SECONDS_PER_HOUR ) + 
+	              ( inDateTime->minute * PLATFORM_RTC_CALENDAR_SECONDS_PER_MINUTE ) + 
+	              inDateTime->second;
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+bool PlatformRTCCalendar_IsAlarmDue( const uint32_t inNowSeconds, const uint32_t inAlarmSeconds )
+{
+	// The signed difference keeps the comparison correct across a wrap of the seconds count
+	return (( int32_t )( inNowSeconds - inAlarmSeconds ) >= 0 ) ? true : false;
+}
+
+uint32_t PlatformRTCCalendar_GetNextAlarm( const uint32_t inAlarmSeconds, const uint32_t inIntervalSeconds, const uint32_t inNowSeconds )
+{
+	uint32_t nextAlarm = inAlarmSeconds;
+	
+	if ( inIntervalSeconds && PlatformRTCCalendar_IsAlarmDue( inNowSeconds, inAlarmSeconds ))
+	{
+		// Skip every occurrence at or before the current time
+		nextAlarm += (( inNowSeconds - inAlarmSeconds ) / inIntervalSeconds + 1 ) * inIntervalSeconds;
+	}
+	
+	return nextAlarm;
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static inline bool _PlatformRTCCalendar_IsLeapYear( const uint16_t inYear )
+{
+	return ((( inYear % 4 ) == 0 ) && ((( inYear % 100 ) != 0 ) || (( inYear % 400 ) == 0 ))) ? true : false;
+}
+
+static inline uint16_t _PlatformRTCCalendar_GetDaysInYear( const uint16_t inYear )
+{
+	return _PlatformRTCCalendar_IsLeapYear( inYear ) ? 366 : 365;
+}
+
+static inline uint8_t _PlatformRTCCalendar_GetDaysInMonth( const uint16_t inYear, const uint8_t inMonth )
+{
+	uint8_t days = kPlatformRTCCalendarDaysPerMonth[ inMonth - 1 ];
+	
+	// February has an extra day in leap years
+	if (( inMonth == 2 ) && _PlatformRTCCalendar_IsLeapYear( inYear ))
+	{
+		days++;
+	}
+	
+	return days;
+}
\ No newline at end of file
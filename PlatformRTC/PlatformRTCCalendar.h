@@ -0,0 +1,79 @@
+/*
+ * PlatformRTCCalendar.h
+ *
+ * Calendar and alarm arithmetic for PlatformRTC. 
+ * This has no hardware dependencies, so it can also be compiled and exercised on a host machine.
+ *
+ * Created: 2026-10-18 10:02:51 AM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMRTCCALENDAR_H_
+#define PLATFORMRTCCALENDAR_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Seconds are counted from midnight, January 1st 2000 (a Saturday). A 32-bit count lasts until the year 2136.
+#define PLATFORM_RTC_CALENDAR_EPOCH_YEAR ( 2000 )
+#define PLATFORM_RTC_CALENDAR_MAX_YEAR   ( 2135 )
+
+typedef struct
+{
+	uint16_t year;    // 2000 - 2135
+	uint8_t  month;   // 1 - 12
+	uint8_t  day;     // 1 - 31
+	uint8_t  hour;    // 0 - 23
+	uint8_t  minute;  // 0 - 59
+	uint8_t  second;  // 0 - 59
+	uint8_t  weekday; // 0 - 6, Sunday is 0. Ignored by PlatformRTCCalendar_DateTimeToSeconds().
+} PlatformRTCDateTime_t;
+
+/*!
+ *\brief    Converts seconds since the epoch to a calendar date and time.
+ *
+ *\details  Counts past the end of PLATFORM_RTC_CALENDAR_MAX_YEAR convert to dates in early 2136, which PlatformRTCCalendar_DateTimeToSeconds() rejects.
+ *
+ *\param    inSeconds   - Seconds since the epoch.
+ *\param    outDateTime - Pointer to store the date and time.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if outDateTime is NULL.
+ */
+PlatformStatus PlatformRTCCalendar_SecondsToDateTime( const uint32_t inSeconds, PlatformRTCDateTime_t *const outDateTime );
+
+/*!
+ *\brief    Converts a calendar date and time to seconds since the epoch.
+ *
+ *\param    inDateTime - Date and time to convert. The weekday is ignored.
+ *\param    outSeconds - Pointer to store the seconds since the epoch.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_InvalidArgument if any field is out of range.
+ */
+PlatformStatus PlatformRTCCalendar_DateTimeToSeconds( const PlatformRTCDateTime_t *const inDateTime, uint32_t *const outSeconds );
+
+/*!
+ *\brief    Checks whether an alarm time has been reached. Comparison is wrap-safe for alarms within ~68 years of the current time.
+ *
+ *\param    inNowSeconds   - Current time.
+ *\param    inAlarmSeconds - Alarm time.
+ *
+ *\return   true if the current time is at or past the alarm time.
+ */
+bool PlatformRTCCalendar_IsAlarmDue( const uint32_t inNowSeconds, const uint32_t inAlarmSeconds );
+
+/*!
+ *\brief    Gets the next occurrence of a repeating alarm that is strictly after the current time.
+ *
+ *\details  Occurrences that were missed (e.g. while interrupts were disabled) are skipped rather than fired in a burst.
+ *
+ *\param    inAlarmSeconds    - Alarm time that has just fired.
+ *\param    inIntervalSeconds - Repeat interval. If 0, inAlarmSeconds is returned.
+ *\param    inNowSeconds      - Current time.
+ *
+ *\return   Next alarm time.
+ */
+uint32_t PlatformRTCCalendar_GetNextAlarm( const uint32_t inAlarmSeconds, const uint32_t inIntervalSeconds, const uint32_t inNowSeconds );
+
+#endif /* PLATFORMRTCCALENDAR_H_ */
\ No newline at end of file
@@ -0,0 +1,154 @@
+/*
+ * PlatformRTCHost.c
+ *
+ * Created: 2026-10-18 11:03:14 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformRTCHost.h"
+
+#ifdef PLATFORM_RTC_HOST
+
+#include "PlatformRTC.h"
+#include "PlatformPowerSave.h"
+#include <string.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_RTC_HOST_CLOCK_SELECT_MASK (( 1 << CS22 ) | ( 1 << CS21 ) | ( 1 << CS20 ))
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+typedef struct
+{
+	bool areInterruptsEnabled;
+	bool isTimer2PoweredOn;
+} PlatformRTCHost_t;
+
+uint8_t TCNT2;
+uint8_t TCCR2A;
+uint8_t TCCR2B;
+uint8_t TIMSK2;
+uint8_t TIFR2;
+uint8_t ASSR;
+
+static PlatformRTCHost_t mPlatformRTCHost;
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void _PlatformRTCHost_ServiceInterrupt( void );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+void PlatformRTCHost_Reset( void )
+{
+	memset( &mPlatformRTCHost, 0, sizeof( mPlatformRTCHost ));
+	
+	TCNT2  = 0;
+	TCCR2A = 0;
+	TCCR2B = 0;
+	TIMSK2 = 0;
+	TIFR2  = 0;
+	ASSR   = 0;
+}
+
+void PlatformRTCHost_Advance( const uint32_t inNumSubSeconds )
+{
+	uint32_t numSubSeconds = inNumSubSeconds;
+	
+	// The counter only runs from the crystal, with a clock selected
+	if ((( ASSR & ( 1 << AS2 )) == 0 ) || (( TCCR2B & PLATFORM_RTC_HOST_CLOCK_SELECT_MASK ) == 0 ))
+	{
+		return;
+	}
+	
+	// Count up to each overflow in one step, so long runs stay fast
+	while ( numSubSeconds > 0 )
+	{
+		uint32_t numToOverflow = PLATFORM_RTC_SUB_SECONDS_PER_SECOND - TCNT2;
+		uint32_t numTicks      = ( numSubSeconds < numToOverflow ) ? numSubSeconds : numToOverflow;
+		
+		TCNT2          = ( uint8_t )( TCNT2 + numTicks );
+		numSubSeconds -= numTicks;
+		
+		if ( numTicks == numToOverflow )
+		{
+			TIFR2 |= ( 1 << TOV2 );
+			_PlatformRTCHost_ServiceInterrupt();
+		}
+	}
+}
+
+bool PlatformRTCHost_IsTimer2PoweredOn( void )
+{
+	return mPlatformRTCHost.isTimer2PoweredOn;
+}
+
+void PlatformRTCHost_ClearTIFR2( const uint8_t inMask )
+{
+	TIFR2 &= ~inMask;
+}
+
+bool PlatformRTCHost_AreInterruptsEnabled( void )
+{
+	return mPlatformRTCHost.areInterruptsEnabled;
+}
+
+void PlatformRTCHost_SetInterruptsEnabled( const bool inIsEnabled )
+{
+	mPlatformRTCHost.areInterruptsEnabled = inIsEnabled;
+	
+	// A pending interrupt is taken as soon as interrupts are enabled
+	_PlatformRTCHost_ServiceInterrupt();
+}
+
+//=======================================//
+//    Stand-ins for Other Peripherals    //
+//=======================================//
+
+PlatformStatus PlatformPowerSave_PowerOnPeripheral( PlatformPowerSavePeripheral_t inDomain )
+{
+	if ( inDomain == PlatformPowerSavePeripheral_Timer2 )
+	{
+		mPlatformRTCHost.isTimer2PoweredOn = true;
+	}
+	
+	return PlatformStatus_Success;
+}
+
+PlatformStatus PlatformPowerSave_PowerOffPeripheral( PlatformPowerSavePeripheral_t inDomain )
+{
+	if ( inDomain == PlatformPowerSavePeripheral_Timer2 )
+	{
+		mPlatformRTCHost.isTimer2PoweredOn = false;
+	}
+	
+	return PlatformStatus_Success;
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static void _PlatformRTCHost_ServiceInterrupt( void )
+{
+	if ( mPlatformRTCHost.areInterruptsEnabled && ( TIMSK2 & ( 1 << TOIE2 )) && ( TIFR2 & ( 1 << TOV2 )))
+	{
+		// Taking the interrupt clears its flag, and global interrupts stay disabled while the ISR runs
+		TIFR2 &= ~( 1 << TOV2 );
+		
+		mPlatformRTCHost.areInterruptsEnabled = false;
+		PlatformRTCHost_OverflowInterrupt();
+		mPlatformRTCHost.areInterruptsEnabled = true;
+	}
+}
+
+#endif /* PLATFORM_RTC_HOST */
\ No newline at end of file
@@ -0,0 +1,96 @@
+/*
+ * PlatformRTCHost.h
+ *
+ * Host backend for PlatformRTC, so its timekeeping, calendar and alarm logic can be tested off target.
+ * Building PlatformRTC.c with PLATFORM_RTC_HOST defined replaces the Timer2 registers with simulated ones, 
+ * counted by a simulated watch crystal that only advances when PlatformRTCHost_Advance() is called.
+ *
+ * The counter is assumed to be prescaled for one overflow per second, as PlatformRTC sets it up. Register writes take effect immediately,
+ * so the ASSR update busy flags always read 0. PlatformRTCHost.c also stands in for the PlatformPowerSave functions PlatformRTC uses.
+ *
+ * Created: 2026-10-18 11:02:40 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMRTCHOST_H_
+#define PLATFORMRTCHOST_H_
+
+#ifdef PLATFORM_RTC_HOST
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+//=====================================//
+//    Simulated Registers & Vectors    //
+//=====================================//
+
+extern uint8_t TCNT2;
+extern uint8_t TCCR2A;
+extern uint8_t TCCR2B;
+extern uint8_t TIMSK2;
+extern uint8_t TIFR2;
+extern uint8_t ASSR;
+
+// TCCR2B
+#define CS22    ( 2 )
+#define CS21    ( 1 )
+#define CS20    ( 0 )
+
+// TIMSK2
+#define TOIE2   ( 0 )
+
+// TIFR2
+#define OCF2B   ( 2 )
+#define OCF2A   ( 1 )
+#define TOV2    ( 0 )
+
+// ASSR
+#define EXCLK   ( 6 )
+#define AS2     ( 5 )
+#define TCN2UB  ( 4 )
+#define OCR2AUB ( 3 )
+#define OCR2BUB ( 2 )
+#define TCR2AUB ( 1 )
+#define TCR2BUB ( 0 )
+
+#define PLATFORM_RTC_CLEAR_TIFR2( MASK ) PlatformRTCHost_ClearTIFR2( MASK )
+
+// The Timer2 overflow ISR becomes a function, called by the simulation while global interrupts are enabled
+#undef  ISR
+#define ISR( VECTOR ) void PlatformRTCHost_OverflowInterrupt( void )
+
+#define PlatformInterrupt_AreGlobalInterruptsEnabled() PlatformRTCHost_AreInterruptsEnabled()
+#define PlatformInterrupt_EnableGlobalInterrupts()     PlatformRTCHost_SetInterruptsEnabled( true )
+#define PlatformInterrupt_DisableGlobalInterrupts()    PlatformRTCHost_SetInterruptsEnabled( false )
+
+void PlatformRTCHost_ClearTIFR2( const uint8_t inMask );
+void PlatformRTCHost_OverflowInterrupt( void );
+bool PlatformRTCHost_AreInterruptsEnabled( void );
+void PlatformRTCHost_SetInterruptsEnabled( const bool inIsEnabled );
+
+//===========//
+//    API    //
+//===========//
+
+/*!
+ *\brief    Resets the simulated registers and power state, with global interrupts disabled as they are out of reset. Call before PlatformRTC_Init().
+ */
+void PlatformRTCHost_Reset( void );
+
+/*!
+ *\brief    Runs the crystal for a number of counter ticks. Each overflow sets TOV2, and runs the ISR if it is enabled and global interrupts are enabled.
+ *
+ *\param    inNumSubSeconds - Counter ticks to run for, in 1/256ths of a second. Nothing is counted while Timer2 is stopped or not asynchronous.
+ */
+void PlatformRTCHost_Advance( const uint32_t inNumSubSeconds );
+
+/*!
+ *\brief    Gets whether Timer2 is powered on, through the PlatformPowerSave stand-ins.
+ */
+bool PlatformRTCHost_IsTimer2PoweredOn( void );
+
+#endif /* PLATFORM_RTC_HOST */
+
+#endif /* PLATFORMRTCHOST_H_ */
\ No newline at end of file
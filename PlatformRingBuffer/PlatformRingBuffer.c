@@ -109,7 +109,7 @@ PlatformStatus PlatformRingBuffer_WriteBuffer( PlatformRingBuffer *const inRingB
 	}
 	
 	// Copy the data, no further than final byte slot in the ring buffer
-	sizeToCopy = MAX( inDataLen, inRingBuffer->bufferSize - inRingBuffer->headIndex + 1 );
+	sizeToCopy = MIN( inDataLen, inRingBuffer->bufferSize - inRingBuffer->headIndex );
 	
 	memcpy( (void*)&inRingBuffer->buffer[ inRingBuffer->headIndex ], inData, sizeToCopy );
 	
@@ -117,7 +117,7 @@ PlatformStatus PlatformRingBuffer_WriteBuffer( PlatformRingBuffer *const inRingB
 	if ( sizeToCopy < inDataLen )
 	{
 		sizeCopied = sizeToCopy;
-		sizeToCopy = sizeCopied - inDataLen;
+		sizeToCopy = inDataLen - sizeCopied;
 		memcpy( (void*)&inRingBuffer->buffer[0], &inData[ sizeCopied ], sizeToCopy );
 	}
 
@@ -330,15 +330,39 @@ static inline size_t _PlatformRingBuffer_GetNumFreeBytes( PlatformRingBuffer *co
 
 static inline size_t _PlatformRingBuffer_GetNumUsedBytes( PlatformRingBuffer *const inRingBuffer )
 {		
-	return (( inRingBuffer->headIndex - inRingBuffer->tailIndex + inRingBuffer->bufferSize ) % inRingBuffer->bufferSize );
+	uint32_t headIndex = inRingBuffer->headIndex;
+	
+	// Compare rather than take a modulo; a 32-bit division is a long library call on the AVR, and this runs in ISRs
+	if ( headIndex >= inRingBuffer->tailIndex )
+	{
+		return headIndex - inRingBuffer->tailIndex;
+	}
+	
+	return headIndex + inRingBuffer->bufferSize - inRingBuffer->tailIndex;
 }
 
 static inline void _PlatformRingBuffer_UpdateHeadIndex( PlatformRingBuffer *const inRingBuffer, size_t inSizeToIncrease )
 {
-	inRingBuffer->headIndex = ( inRingBuffer->headIndex + inSizeToIncrease ) % inRingBuffer->bufferSize;
+	// Never more than the buffer size is written at once, so a single wrap is enough
+	uint32_t headIndex = inRingBuffer->headIndex + inSizeToIncrease;
+	
+	if ( headIndex >= inRingBuffer->bufferSize )
+	{
+		headIndex -= inRingBuffer->bufferSize;
+	}
+	
+	inRingBuffer->headIndex = headIndex;
 }
 
 static inline void _PlatformRingBuffer_UpdateTailIndex( PlatformRingBuffer *const inRingBuffer, size_t inSizeToIncrease )
 {
-	inRingBuffer->tailIndex = ( inRingBuffer->tailIndex + inSizeToIncrease ) % inRingBuffer->bufferSize;
+	// Never more than the used bytes are consumed at once, so a single wrap is enough
+	uint32_t tailIndex = inRingBuffer->tailIndex + inSizeToIncrease;
+	
+	if ( tailIndex >= inRingBuffer->bufferSize )
+	{
+		tailIndex -= inRingBuffer->bufferSize;
+	}
+	
+	inRingBuffer->tailIndex = tailIndex;
 }
\ No newline at end of file
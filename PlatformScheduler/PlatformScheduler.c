@@ -0,0 +1,195 @@
+/*
+ * PlatformScheduler.c
+ *
+ * Created: 2026-10-18 11:02:21 AM
+ *  Author: Felix
+ */ 
+
+#include "PlatformScheduler.h"
+#include "PlatformDeferredWork.h"
+#include "PlatformPowerSave.h"
+#include "PlatformRTC.h"
+#include "PlatformInterrupt.h"
+#include "require_macros.h"
+#include <stddef.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_SCHEDULER_GET_MASK( PRIORITY ) ( uint8_t )( 1 << ( PRIORITY ))
+
+//==================================//
+//    Static Structs & Variables    //
+//==================================//
+
+static PlatformScheduler_TaskCb mPlatformSchedulerTasks[ PLATFORM_SCHEDULER_MAX_TASKS ];
+static uint8_t                  mPlatformSchedulerRegisteredTasks;
+static volatile uint8_t         mPlatformSchedulerPendingTasks; // Changed in ISR
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void _PlatformScheduler_Idle( void );
+
+//===================================//
+//    Public Function Definitions    //
+//===================================//
+
+PlatformStatus PlatformScheduler_RegisterTask( const uint8_t inPriority, PlatformScheduler_TaskCb inTaskCb )
+{
+	PlatformStatus status = PlatformStatus_InvalidArgument;
+	
+	require_quiet( inPriority < PLATFORM_SCHEDULER_MAX_TASKS, exit );
+	require_quiet( inTaskCb, exit );
+	
+	// Check that this priority is not already taken
+	require_action_quiet(( mPlatformSchedulerRegisteredTasks & PLATFORM_SCHEDULER_GET_MASK( inPriority )) == 0, exit, status = PlatformStatus_AlreadyInitialized );
+	
+	mPlatformSchedulerTasks[ inPriority ] = inTaskCb;
+	mPlatformSchedulerRegisteredTasks    |= PLATFORM_SCHEDULER_GET_MASK( inPriority );
+	
+	status = PlatformStatus_Success;
+exit:
+	return status;
+}
+
+PlatformStatus PlatformScheduler_UnregisterTask( const uint8_t inPriority )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( inPriority < PLATFORM_SCHEDULER_MAX_TASKS, exit );
+	require_quiet( mPlatformSchedulerRegisteredTasks & PLATFORM_SCHEDULER_GET_MASK( inPriority ), exit );
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	// Discard any pending post, then remove the task
+	mPlatformSchedulerPendingTasks    &= ~PLATFORM_SCHEDULER_GET_MASK( inPriority );
+	mPlatformSchedulerRegisteredTasks &= ~PLATFORM_SCHEDULER_GET_MASK( inPriority );
+	mPlatformSchedulerTasks[ inPriority ] = NULL;
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+PlatformStatus PlatformScheduler_PostTask( const uint8_t inPriority )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
+	
+	require_quiet( inPriority < PLATFORM_SCHEDULER_MAX_TASKS, exit );
+	require_quiet( mPlatformSchedulerRegisteredTasks & PLATFORM_SCHEDULER_GET_MASK( inPriority ), exit );
+	
+	// Disable Global Interrupts, if enabled. Within an ISR they are already disabled.
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	mPlatformSchedulerPendingTasks |= PLATFORM_SCHEDULER_GET_MASK( inPriority );
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+bool PlatformScheduler_RunNextTask( void )
+{
+	PlatformScheduler_TaskCb task = NULL;
+	bool didDisableInterrupts = false;
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	// Find the highest priority pending task, and mark it as no longer pending
+	for ( uint8_t i = 0; i < PLATFORM_SCHEDULER_MAX_TASKS; i++ )
+	{
+		if ( mPlatformSchedulerPendingTasks & PLATFORM_SCHEDULER_GET_MASK( i ))
+		{
+			mPlatformSchedulerPendingTasks &= ~PLATFORM_SCHEDULER_GET_MASK( i );
+			task = mPlatformSchedulerTasks[i];
+			break;
+		}
+	}
+	
+	// Enable global interrupts, if we disabled them, so the task runs with interrupts enabled
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	
+	if ( task )
+	{
+		task();
+	}
+	
+	return ( task != NULL ) ? true : false;
+}
+
+void PlatformScheduler_Run( void )
+{
+	PlatformInterrupt_EnableGlobalInterrupts();
+	
+	for ( ;; )
+	{
+		// Run deferred ISR work ahead of any task, since tasks are often posted by it
+		PlatformDeferredWork_ProcessAll();
+		
+		// Run the highest priority task, then check for deferred work again
+		if ( PlatformScheduler_RunNextTask() )
+		{
+			continue;
+		}
+		
+		// Disable interrupts before the final check, so work posted after it will wake the CPU from sleep instead of being missed
+		PlatformInterrupt_DisableGlobalInterrupts();
+		
+		if (( mPlatformSchedulerPendingTasks == 0 ) && !PlatformDeferredWork_IsPending())
+		{
+			_PlatformScheduler_Idle();
+		}
+		
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static void _PlatformScheduler_Idle( void )
+{
+	PlatformPowerSaveSleepMode_t sleepMode = PlatformPowerSave_GetDeepestSleepMode();
+	
+	// The asynchronous RTC must be synchronized before Power-save sleep, or its interrupt may not wake the CPU
+	if ( sleepMode == PlatformPowerSaveSleepMode_PowerSave )
+	{
+		PlatformRTC_PrepareForSleep();
+	}
+	
+	// Sleep until an interrupt occurs; this enables global interrupts
+	PlatformPowerSave_Sleep( sleepMode );
+}
\ No newline at end of file
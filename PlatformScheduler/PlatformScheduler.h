@@ -0,0 +1,73 @@
+/*
+ * PlatformScheduler.h
+ *
+ * A cooperative, run-to-completion task scheduler. 
+ * Each task is a function registered at a unique priority. Tasks are posted from ISRs (e.g. a PlatformRingBuffer data received callback, 
+ * or a PlatformTimer tick callback) or from other tasks, and run one at a time from the main context, highest priority first.
+ * When no tasks are pending, the CPU sleeps in the deepest sleep mode that keeps the powered-on peripherals running.
+ *
+ * Created: 2026-10-18 11:02:40 AM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMSCHEDULER_H_
+#define PLATFORMSCHEDULER_H_
+
+#include "PlatformStatus.h"
+#include <stdint.h>
+#include <stdbool.h>
+
+// Priority 0 is the highest priority
+#define PLATFORM_SCHEDULER_MAX_TASKS ( 8 )
+
+typedef void ( *PlatformScheduler_TaskCb )( void );
+
+/*!
+ *\brief    Registers a task at a priority.
+ *
+ *\param    inPriority - Priority of the task, from 0 (highest) to PLATFORM_SCHEDULER_MAX_TASKS - 1. This also identifies the task when posting it.
+ *\param    inTaskCb   - Function to run when the task is posted.
+ *
+ *\return   PlatformStatus - PlatformStatus_Success            if successful,
+ *                         - PlatformStatus_AlreadyInitialized if a task is already registered at this priority,
+ *                         - PlatformStatus_InvalidArgument    if the priority or callback is invalid.
+ */
+PlatformStatus PlatformScheduler_RegisterTask( const uint8_t inPriority, PlatformScheduler_TaskCb inTaskCb );
+
+/*!
+ *\brief    Unregisters a task. Any pending post of the task is discarded.
+ *
+ *\param    inPriority - Priority of the task.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if no task is registered at this priority.
+ */
+PlatformStatus PlatformScheduler_UnregisterTask( const uint8_t inPriority );
+
+/*!
+ *\brief    Posts a task to be run. Safe to call from ISRs and from the main context.
+ *
+ *\details  Posting a task that is already pending has no effect; the task will run once.
+ *
+ *\param    inPriority - Priority of the task to post.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if no task is registered at this priority.
+ */
+PlatformStatus PlatformScheduler_PostTask( const uint8_t inPriority );
+
+/*!
+ *\brief    Runs the highest priority pending task, if any.
+ *
+ *\return   true if a task was run, false if no task was pending.
+ */
+bool PlatformScheduler_RunNextTask( void );
+
+/*!
+ *\brief    Runs pending tasks forever, sleeping whenever none are pending. Does not return.
+ *
+ *\details  Work queued with PlatformDeferredWork is processed before each task.
+ *          Global interrupts are enabled by this function.
+ */
+void PlatformScheduler_Run( void );
+
+#endif /* PLATFORMSCHEDULER_H_ */
\ No newline at end of file
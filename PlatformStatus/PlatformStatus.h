@@ -17,6 +17,7 @@ typedef enum
 	PlatformStatus_AlreadyInitialized,
 	PlatformStatus_NotSupported,
 	PlatformStatus_InvalidArgument,
+	PlatformStatus_Timeout,
 } PlatformStatus;
 
 
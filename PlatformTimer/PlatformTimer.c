@@ -17,6 +17,7 @@
 static bool mPlatformTimerInitialized;
 static bool mPlatformTimerEnabledGlobalInterrupts;
 static uint32_t mPlatformTimerCurrentMilliseconds;
+static PlatformTimer_TickCb mPlatformTimerTickCb;
 
 PlatformStatus PlatformTimer_Init( void )
 {
@@ -39,8 +40,8 @@ PlatformStatus PlatformTimer_Init( void )
 	TCCR1B &= ~(( 1 << CS12 ) | ( 1 << CS11 ));
 	TCCR1B |= ( 1 << CS10 );
 	
-	// Set the TOP value such that the timer overflows every 1ms
-	topVal = ( uint16_t )( F_CPU / 1000 );
+	// Set the TOP value such that the timer overflows every 1ms. The counter includes TOP, so it counts TOP + 1 ticks per period.
+	topVal = ( uint16_t )( PLATFORM_TIMER_TICKS_PER_MS - 1 );
 
 	OCR1AH = ( topVal >> 8 ) & 0xFF;
 	OCR1AL = topVal & 0xFF;
@@ -91,6 +92,76 @@ exit:
 	return status;
 }
 
+PlatformStatus PlatformTimer_GetTicks( uint32_t * const outTicks )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
+	
+	// Check if initialized
+	require_quiet( mPlatformTimerInitialized, exit );
+	require_quiet( outTicks, exit );
+	
+	// Disable Global Interrupts, if enabled
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	// Extend the current counter value with the millisecond count
+	*outTicks = PlatformTimer_GetTicksFromCount( TCNT1 );
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
+uint32_t PlatformTimer_GetTicksFromCount( const uint16_t inTimerCount )
+{
+	uint32_t milliseconds = mPlatformTimerCurrentMilliseconds;
+	
+	// If the compare match is pending but not yet serviced, a small count was taken after the counter wrapped to 0
+	if (( TIFR1 & ( 1 << OCF1A )) && ( inTimerCount < ( PLATFORM_TIMER_TICKS_PER_MS / 2 )))
+	{
+		milliseconds++;
+	}
+	
+	// The tick count wraps at 32 bits, which keeps differences between two timestamps valid across the wrap
+	return ( milliseconds * PLATFORM_TIMER_TICKS_PER_MS ) + inTimerCount;
+}
+
+PlatformStatus PlatformTimer_SetTickCallback( PlatformTimer_TickCb inOptionalTickCb )
+{
+	PlatformStatus status = PlatformStatus_NotInitialized;
+	bool didDisableInterrupts = false;
+	
+	// Check if initialized
+	require_quiet( mPlatformTimerInitialized, exit );
+	
+	// Disable Global Interrupts, if enabled, since the pointer cannot be written atomically
+	if ( PlatformInterrupt_AreGlobalInterruptsEnabled() )
+	{
+		PlatformInterrupt_DisableGlobalInterrupts();
+		didDisableInterrupts = true;
+	}
+	
+	mPlatformTimerTickCb = inOptionalTickCb;
+	
+	status = PlatformStatus_Success;
+exit:
+	// Enable global interrupts, if we disabled them
+	if ( didDisableInterrupts )
+	{
+		PlatformInterrupt_EnableGlobalInterrupts();
+	}
+	return status;
+}
+
 PlatformStatus PlatformTimer_Reset( void )
 {
 	PlatformStatus status = PlatformStatus_NotInitialized;
@@ -148,4 +219,10 @@ ISR( TIMER1_COMPA_vect )
 {
 	// Update the millisecond count
 	mPlatformTimerCurrentMilliseconds++;
+	
+	// Callback, if it exists
+	if ( mPlatformTimerTickCb )
+	{
+		mPlatformTimerTickCb( mPlatformTimerCurrentMilliseconds );
+	}
 }
\ No newline at end of file
@@ -14,12 +14,55 @@
 #define PLATFORMTIMER_H_
 
 #include "PlatformStatus.h"
+#include "PlatformClock.h"
 #include <stdint.h>
 
+// Timer1 runs with no prescaling, so one tick is one CPU clock cycle
+#define PLATFORM_TIMER_TICKS_PER_MS ( F_CPU / 1000 )
+
+/*!
+ *\brief    Millisecond tick callback; called from the Timer1 compare match ISR, so it should be kept short.
+ *
+ *\param    inMilliseconds - Millisecond count after this tick.
+ */
+typedef void ( *PlatformTimer_TickCb )( const uint32_t inMilliseconds );
+
 PlatformStatus PlatformTimer_Init( void );
 
 PlatformStatus PlatformTimer_GetTime( uint32_t * const outTime );
 
+/*!
+ *\brief    Gets the number of Timer1 ticks since initialization or the last call to PlatformTimer_Reset().
+ *
+ *\details  One tick is one CPU clock cycle. The count wraps at 32 bits (about 536 seconds at 8MHz),
+ *          so only use it to measure intervals shorter than that; differences remain valid across the wrap.
+ *
+ *\param    outTicks - Pointer to store the tick count.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the timer has not been initialized.
+ */
+PlatformStatus PlatformTimer_GetTicks( uint32_t * const outTicks );
+
+/*!
+ *\brief    Converts a raw 16-bit Timer1 count (e.g. TCNT1 or ICR1) into a full tick timestamp, as returned by PlatformTimer_GetTicks().
+ *
+ *\details  This must be called with global interrupts disabled, such as from within an ISR, and within 1ms of the count being taken.
+ *
+ *\param    inTimerCount - Raw Timer1 count.
+ *
+ *\return   Tick timestamp of the count.
+ */
+uint32_t PlatformTimer_GetTicksFromCount( const uint16_t inTimerCount );
+
+/*!
+ *\brief    Sets a callback to be called on every millisecond tick, e.g. to post periodic work to PlatformScheduler.
+ *
+ *\param    inOptionalTickCb - Callback to call on every tick. NULL to remove the callback.
+ *
+ *\return   PlatformStatus_Success if successful. PlatformStatus_NotInitialized if the timer has not been initialized.
+ */
+PlatformStatus PlatformTimer_SetTickCallback( PlatformTimer_TickCb inOptionalTickCb );
+
 PlatformStatus PlatformTimer_Reset( void );
 
 PlatformStatus PlatformTimer_Deinit( void );
@@ -0,0 +1,190 @@
+/*
+ * PlatformADCOversampleTest.c
+ *
+ * Host test of PlatformADCOversample with synthetic sample streams, for every supported number of extra bits.
+ * Each result is checked against a 64-bit sum of the same samples, and against the floating point mean.
+ * From the repository root:
+ *   gcc -std=gnu99 -O2 -Wall -Wextra -ITests -IPlatformADC -IPlatformStatus Tests/PlatformADCOversampleTest.c PlatformADC/PlatformADCOversample.c -o /tmp/PlatformADCOversampleTest && /tmp/PlatformADCOversampleTest
+ *
+ * Created: 2026-10-19 9:12:41 AM
+ *  Author: Felix
+ */ 
+
+#include "PlatformTest.h"
+#include "PlatformADCOversample.h"
+#include <math.h>
+#include <stdio.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_ADC_OVERSAMPLE_TEST_MAX_10_BIT  ( 1023 )
+#define PLATFORM_ADC_OVERSAMPLE_TEST_MAX_8_BIT   ( 255 )
+#define PLATFORM_ADC_OVERSAMPLE_TEST_NUM_RESULTS ( 8 ) // Results checked for each stream, so every result after the first is checked too
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+typedef enum
+{
+	PlatformADCOversampleTestStream_Constant,
+	PlatformADCOversampleTestStream_Ramp,
+	PlatformADCOversampleTestStream_Dithered,
+	PlatformADCOversampleTestStream_Count
+} PlatformADCOversampleTestStream_t;
+
+static const char *const kPlatformADCOversampleTestStreamNames[ PlatformADCOversampleTestStream_Count ] = { "constant", "ramp", "dithered" };
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static uint16_t _PlatformADCOversampleTest_GetSample( const PlatformADCOversampleTestStream_t inStream, const uint16_t inMaxSample, const uint32_t inIndex, uint32_t *const ioSeed );
+static void     _PlatformADCOversampleTest_CheckStream( const PlatformADCOversampleTestStream_t inStream, const uint16_t inMaxSample, const uint8_t inExtraBits );
+static void     _PlatformADCOversampleTest_Init( void );
+
+//============//
+//    Main    //
+//============//
+
+int main( void )
+{
+	_PlatformADCOversampleTest_Init();
+	
+	for ( uint8_t extraBits = 0; extraBits <= PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS; extraBits++ )
+	{
+		for ( int stream = 0; stream < PlatformADCOversampleTestStream_Count; stream++ )
+		{
+			_PlatformADCOversampleTest_CheckStream(( PlatformADCOversampleTestStream_t )stream, PLATFORM_ADC_OVERSAMPLE_TEST_MAX_10_BIT, extraBits );
+			_PlatformADCOversampleTest_CheckStream(( PlatformADCOversampleTestStream_t )stream, PLATFORM_ADC_OVERSAMPLE_TEST_MAX_8_BIT,  extraBits );
+		}
+	}
+	
+	return PLATFORM_TEST_RESULT();
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+// Constant streams are full scale, the worst case for the accumulator. Dithered streams add up to +/-2 LSBs of noise around three quarters of full scale.
+static uint16_t _PlatformADCOversampleTest_GetSample( const PlatformADCOversampleTestStream_t inStream, const uint16_t inMaxSample, const uint32_t inIndex, uint32_t *const ioSeed )
+{
+	uint16_t sample = inMaxSample;
+	
+	switch ( inStream )
+	{
+		case PlatformADCOversampleTestStream_Ramp:
+			sample = ( uint16_t )( inIndex % ( inMaxSample + 1UL ));
+			break;
+		
+		case PlatformADCOversampleTestStream_Dithered:
+			*ioSeed = *ioSeed * 1103515245UL + 12345UL;
+			sample  = ( uint16_t )((( inMaxSample * 3UL ) / 4 ) + (( *ioSeed >> 16 ) % 5 ) - 2 );
+			break;
+		
+		default:
+			break;
+	}
+	
+	return sample;
+}
+
+static void _PlatformADCOversampleTest_CheckStream( const PlatformADCOversampleTestStream_t inStream, const uint16_t inMaxSample, const uint8_t inExtraBits )
+{
+	const uint32_t kNumSamplesPerResult = 1UL << ( 2 * inExtraBits );
+	PlatformADCOversampler_t oversampler;
+	uint32_t seed           = 1;
+	uint32_t sampleIndex    = 0;
+	uint32_t numEarly       = 0;
+	uint32_t numMismatched  = 0;
+	uint32_t numInaccurate  = 0;
+	double   maxError       = 0.0;
+	
+	PLATFORM_TEST_CHECK( PlatformADCOversample_GetNumSamplesPerResult( inExtraBits ) == kNumSamplesPerResult );
+	PLATFORM_TEST_CHECK( PlatformADCOversample_Init( &oversampler, inExtraBits ) == PlatformStatus_Success );
+	
+	for ( uint32_t i = 0; i < PLATFORM_ADC_OVERSAMPLE_TEST_NUM_RESULTS; i++ )
+	{
+		uint64_t sum       = 0;
+		uint16_t result    = 0;
+		bool     isResult  = false;
+		double   mean;
+		double   error;
+		
+		for ( uint32_t j = 0; j < kNumSamplesPerResult; j++ )
+		{
+			uint16_t sample = _PlatformADCOversampleTest_GetSample( inStream, inMaxSample, sampleIndex, &seed );
+			
+			sampleIndex++;
+			sum += sample;
+			
+			isResult = PlatformADCOversample_AddSample( &oversampler, sample, &result );
+			
+			// A result only comes out on the 4^n-th sample
+			if ( isResult != ( j == ( kNumSamplesPerResult - 1 )))
+			{
+				numEarly++;
+			}
+		}
+		
+		// The accumulator holds the exact sum, so the result is exactly the 64-bit sum shifted
+		if ( !isResult || ( result != ( uint16_t )( sum >> inExtraBits )) || (( sum >> inExtraBits ) > UINT16_MAX ))
+		{
+			numMismatched++;
+		}
+		
+		// The mean of 4^n samples, scaled up by n bits
+		mean  = ( double )sum / ( double )kNumSamplesPerResult * ( double )( 1UL << inExtraBits );
+		error = fabs(( double )result - mean );
+		if ( error > maxError )
+		{
+			maxError = error;
+		}
+		if ( error >= 1.0 )
+		{
+			numInaccurate++;
+		}
+	}
+	
+	printf( "n = %u, %-8s %4u-scale: %4lu samples per result, max error %.3f LSB\n", 
+	        inExtraBits, kPlatformADCOversampleTestStreamNames[ inStream ], inMaxSample, ( unsigned long )kNumSamplesPerResult, maxError );
+	
+	PLATFORM_TEST_CHECK( numEarly == 0 );
+	PLATFORM_TEST_CHECK( numMismatched == 0 );
+	PLATFORM_TEST_CHECK( numInaccurate == 0 );
+	
+	// Full-scale input at the most extra bits is the largest sum the accumulator has to hold
+	if (( inStream == PlatformADCOversampleTestStream_Constant ) && ( inExtraBits == PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS ))
+	{
+		uint16_t result = 0;
+		
+		for ( uint32_t j = 0; j < kNumSamplesPerResult; j++ )
+		{
+			( void )PlatformADCOversample_AddSample( &oversampler, inMaxSample, &result );
+		}
+		PLATFORM_TEST_CHECK( result == ( uint16_t )(( uint32_t )inMaxSample << inExtraBits ));
+	}
+}
+
+static void _PlatformADCOversampleTest_Init( void )
+{
+	PlatformADCOversampler_t oversampler;
+	uint16_t result = 0;
+	
+	PLATFORM_TEST_CHECK( PlatformADCOversample_Init( NULL, 0 ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformADCOversample_Init( &oversampler, PLATFORM_ADC_OVERSAMPLE_MAX_EXTRA_BITS + 1 ) == PlatformStatus_InvalidArgument );
+	
+	// Re-initializing drops a partly accumulated result
+	PLATFORM_TEST_CHECK( PlatformADCOversample_Init( &oversampler, 1 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( !PlatformADCOversample_AddSample( &oversampler, 1000, &result ));
+	PLATFORM_TEST_CHECK( !PlatformADCOversample_AddSample( &oversampler, 1000, &result ));
+	PLATFORM_TEST_CHECK( PlatformADCOversample_Init( &oversampler, 1 ) == PlatformStatus_Success );
+	for ( int i = 0; i < 3; i++ )
+	{
+		PLATFORM_TEST_CHECK( !PlatformADCOversample_AddSample( &oversampler, 10, &result ));
+	}
+	PLATFORM_TEST_CHECK( PlatformADCOversample_AddSample( &oversampler, 10, &result ) && ( result == 20 ));
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+/*
+ * PlatformFilterTest.c
+ *
+ * Host accuracy tests for PlatformFilter against double-precision references, and a throughput benchmark of each filter.
+ * From the repository root:
+ *   gcc -std=gnu99 -O2 -Wall -Wextra -ITests -IPlatformFilter -IPlatformStatus Tests/PlatformFilterTest.c PlatformFilter/PlatformFilter.c -lm -o /tmp/PlatformFilterTest && /tmp/PlatformFilterTest
+ *
+ * Created: 2026-10-18 9:44:05 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformTest.h"
+#include "PlatformFilter.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_FILTER_TEST_NUM_SAMPLES    ( 4000 )
+#define PLATFORM_FILTER_TEST_NUM_BENCHMARK  ( 2000000UL )
+
+// Largest allowed difference from the double-precision reference, in output LSBs
+#define PLATFORM_FILTER_TEST_ROUNDING_TOLERANCE ( 0.5 + 1e-9 )
+#define PLATFORM_FILTER_TEST_IIR_TOLERANCE      ( 2.0 )
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+static int16_t mPlatformFilterTestInput[ PLATFORM_FILTER_TEST_NUM_SAMPLES ];
+static volatile int16_t mPlatformFilterTestSink; // Keeps the benchmark loops from being optimized away
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void   _PlatformFilterTest_MakeInput( const double inAmplitude, const int16_t inNoise );
+static double _PlatformFilterTest_Mean( const int16_t *const inSamples, const int inEnd, const int inCount );
+
+static void _PlatformFilterTest_MovingAverageQ15( void );
+static void _PlatformFilterTest_MovingAverageQ7( void );
+static void _PlatformFilterTest_IIR( void );
+static void _PlatformFilterTest_Median( void );
+static void _PlatformFilterTest_FIR( void );
+static void _PlatformFilterTest_Chain( void );
+static void _PlatformFilterTest_Benchmark( void );
+
+//============//
+//    Main    //
+//============//
+
+int main( void )
+{
+	_PlatformFilterTest_MovingAverageQ15();
+	_PlatformFilterTest_MovingAverageQ7();
+	_PlatformFilterTest_IIR();
+	_PlatformFilterTest_Median();
+	_PlatformFilterTest_FIR();
+	_PlatformFilterTest_Chain();
+	_PlatformFilterTest_Benchmark();
+	
+	return PLATFORM_TEST_RESULT();
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+// A slow sine with pseudo-random noise, so every filter sees both a trend and sample-to-sample changes
+static void _PlatformFilterTest_MakeInput( const double inAmplitude, const int16_t inNoise )
+{
+	uint32_t seed = 1;
+	
+	for ( int i = 0; i < PLATFORM_FILTER_TEST_NUM_SAMPLES; i++ )
+	{
+		seed = seed * 1103515245UL + 12345UL;
+		mPlatformFilterTestInput[i] = ( int16_t )( lround( inAmplitude * sin( i * 0.01 )) + ( int16_t )(( seed >> 16 ) % ( 2 * inNoise + 1 )) - inNoise );
+	}
+}
+
+// Mean of the inCount samples ending at inEnd
+static double _PlatformFilterTest_Mean( const int16_t *const inSamples, const int inEnd, const int inCount )
+{
+	double sum = 0;
+	
+	for ( int i = inEnd - inCount + 1; i <= inEnd; i++ )
+	{
+		sum += inSamples[i];
+	}
+	
+	return sum / inCount;
+}
+
+static void _PlatformFilterTest_MovingAverageQ15( void )
+{
+	PlatformFilterMovingAverageQ15_t filter;
+	int16_t history[ 16 ];
+	double  maxFillingError = 0;
+	double  maxError        = 0;
+	
+	_PlatformFilterTest_MakeInput( 30000.0, 1000 );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMovingAverageQ15( &filter, history, 4 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMovingAverageQ15( &filter, history, PLATFORM_FILTER_MOVING_AVERAGE_MAX_LOG2 + 1 ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMovingAverageQ15( &filter, history, 4 ) == PlatformStatus_Success );
+	
+	for ( int i = 0; i < PLATFORM_FILTER_TEST_NUM_SAMPLES; i++ )
+	{
+		int16_t output;
+		
+		PLATFORM_TEST_CHECK( PlatformFilter_ProcessMovingAverageQ15( &filter, mPlatformFilterTestInput[i], &output ));
+		
+		// Until the window is full, the average is over the samples so far, and truncated rather than rounded
+		if ( i < 16 )
+		{
+			maxFillingError = fmax( maxFillingError, fabs( output - _PlatformFilterTest_Mean( mPlatformFilterTestInput, i, i + 1 )));
+		}
+		else
+		{
+			maxError = fmax( maxError, fabs( output - _PlatformFilterTest_Mean( mPlatformFilterTestInput, i, 16 )));
+		}
+	}
+	
+	printf( "Moving average Q15: max error %.3f LSB, %.3f LSB while filling\n", maxError, maxFillingError );
+	PLATFORM_TEST_CHECK( maxError <= PLATFORM_FILTER_TEST_ROUNDING_TOLERANCE );
+	PLATFORM_TEST_CHECK( maxFillingError < 1.0 );
+}
+
+static void _PlatformFilterTest_MovingAverageQ7( void )
+{
+	PlatformFilterMovingAverageQ7_t filter;
+	int8_t  history[ 8 ];
+	int16_t input[ PLATFORM_FILTER_TEST_NUM_SAMPLES ];
+	double  maxError = 0;
+	
+	// Full-scale 8-bit data
+	_PlatformFilterTest_MakeInput( 120.0, 7 );
+	for ( int i = 0; i < PLATFORM_FILTER_TEST_NUM_SAMPLES; i++ )
+	{
+		input[i] = mPlatformFilterTestInput[i];
+	}
+	
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMovingAverageQ7( &filter, history, 3 ) == PlatformStatus_Success );
+	
+	for ( int i = 0; i < PLATFORM_FILTER_TEST_NUM_SAMPLES; i++ )
+	{
+		int8_t output;
+		
+		PLATFORM_TEST_CHECK( PlatformFilter_ProcessMovingAverageQ7( &filter, ( int8_t )input[i], &output ));
+		if ( i >= 8 )
+		{
+			maxError = fmax( maxError, fabs( output - _PlatformFilterTest_Mean( input, i, 8 )));
+		}
+	}
+	
+	printf( "Moving average Q7:  max error %.3f LSB\n", maxError );
+	PLATFORM_TEST_CHECK( maxError <= PLATFORM_FILTER_TEST_ROUNDING_TOLERANCE );
+}
+
+static void _PlatformFilterTest_IIR( void )
+{
+	PlatformFilterIIR_t filter;
+	
+	_PlatformFilterTest_MakeInput( 30000.0, 1000 );
+	
+	PLATFORM_TEST_CHECK( PlatformFilter_InitIIR( &filter, 0 ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitIIR( &filter, PLATFORM_FILTER_IIR_MAX_SHIFT + 1 ) == PlatformStatus_InvalidArgument );
+	
+	for ( uint8_t shift = 1; shift <= 8; shift++ )
+	{
+		double reference = mPlatformFilterTestInput[0];
+		double maxError  = 0;
+		
+		PLATFORM_TEST_CHECK( PlatformFilter_InitIIR( &filter, shift ) == PlatformStatus_Success );
+		
+		for ( int i = 0; i < PLATFORM_FILTER_TEST_NUM_SAMPLES; i++ )
+		{
+			int16_t output;
+			
+			// The filter starts at the first sample
+			if ( i > 0 )
+			{
+				reference += ( mPlatformFilterTestInput[i] - reference ) / ( 1 << shift );
+			}
+			
+			PLATFORM_TEST_CHECK( PlatformFilter_ProcessIIR( &filter, mPlatformFilterTestInput[i], &output ));
+			maxError = fmax( maxError, fabs( output - reference ));
+		}
+		
+		printf( "IIR shift %u:        max error %.3f LSB\n", shift, maxError );
+		PLATFORM_TEST_CHECK( maxError <= PLATFORM_FILTER_TEST_IIR_TOLERANCE );
+	}
+}
+
+static void _PlatformFilterTest_Median( void )
+{
+	PlatformFilterMedian_t filter;
+	int mismatches = 0;
+	
+	_PlatformFilterTest_MakeInput( 30000.0, 2000 );
+	
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMedian( &filter, 4 ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMedian( &filter, PLATFORM_FILTER_MEDIAN_MAX_WINDOW + 2 ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMedian( &filter, 5 ) == PlatformStatus_Success );
+	
+	for ( int i = 0; i < PLATFORM_FILTER_TEST_NUM_SAMPLES; i++ )
+	{
+		int16_t output;
+		int16_t window[ 5 ];
+		
+		PLATFORM_TEST_CHECK( PlatformFilter_ProcessMedian( &filter, mPlatformFilterTestInput[i], &output ));
+		
+		if ( i >= 4 )
+		{
+			// Sort a copy of the window
+			for ( int k = 0; k < 5; k++ )
+			{
+				window[k] = mPlatformFilterTestInput[ i - k ];
+			}
+			for ( int a = 1; a < 5; a++ )
+			{
+				for ( int b = a; ( b > 0 ) && ( window[ b - 1 ] > window[b] ); b-- )
+				{
+					const int16_t swap = window[b];
+					window[b]       = window[ b - 1 ];
+					window[ b - 1 ] = swap;
+				}
+			}
+			
+			mismatches += ( output != window[2] ) ? 1 : 0;
+		}
+	}
+	
+	printf( "Median 5:           %d mismatches\n", mismatches );
+	PLATFORM_TEST_CHECK( mismatches == 0 );
+}
+
+static void _PlatformFilterTest_FIR( void )
+{
+	// 8-tap low-pass, decimating by 4. The coefficients sum to 1.0.
+	static const int16_t kCoefficients[ 8 ] = { 1024, 3072, 5120, 7168, 7168, 5120, 3072, 1024 };
+	static const int16_t kGain[ 2 ]         = { 32767, 32767 };
+	PlatformFilterFIR_t filter;
+	int16_t history[ 8 ];
+	int16_t output;
+	double  maxError   = 0;
+	int     numOutputs = 0;
+	
+	_PlatformFilterTest_MakeInput( 30000.0, 1000 );
+	
+	PLATFORM_TEST_CHECK( PlatformFilter_InitFIR( &filter, kCoefficients, history, 8, 0 ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitFIR( &filter, kCoefficients, history, 8, 4 ) == PlatformStatus_Success );
+	
+	for ( int i = 0; i < PLATFORM_FILTER_TEST_NUM_SAMPLES; i++ )
+	{
+		if ( PlatformFilter_ProcessFIR( &filter, mPlatformFilterTestInput[i], &output ))
+		{
+			numOutputs++;
+			
+			// The history starts as zeros
+			double reference = 0;
+			for ( int k = 0; ( k < 8 ) && ( k <= i ); k++ )
+			{
+				reference += mPlatformFilterTestInput[ i - k ] * ( kCoefficients[k] / 32768.0 );
+			}
+			
+			maxError = fmax( maxError, fabs( output - reference ));
+		}
+	}
+	
+	printf( "FIR 8 taps / 4:     max error %.3f LSB, %d outputs\n", maxError, numOutputs );
+	PLATFORM_TEST_CHECK( maxError <= PLATFORM_FILTER_TEST_ROUNDING_TOLERANCE );
+	PLATFORM_TEST_CHECK( numOutputs == PLATFORM_FILTER_TEST_NUM_SAMPLES / 4 );
+	
+	// A gain above 1.0 saturates rather than wrapping
+	PLATFORM_TEST_CHECK( PlatformFilter_InitFIR( &filter, kGain, history, 2, 1 ) == PlatformStatus_Success );
+	PlatformFilter_ProcessFIR( &filter, 30000, &output );
+	PLATFORM_TEST_CHECK( PlatformFilter_ProcessFIR( &filter, 30000, &output ) && ( output == INT16_MAX ));
+	PlatformFilter_ProcessFIR( &filter, -30000, &output );
+	PLATFORM_TEST_CHECK( PlatformFilter_ProcessFIR( &filter, -30000, &output ) && ( output == INT16_MIN ));
+}
+
+static void _PlatformFilterTest_Chain( void )
+{
+	PlatformFilterMedian_t          median;
+	PlatformFilterMovingAverageQ7_t averageQ7;
+	int8_t                          historyQ7[ 4 ];
+	PlatformFilterFIR_t             fir;
+	int16_t                         historyFIR[ 2 ];
+	static const int16_t            kHalves[ 2 ] = { 16384, 16384 };
+	const PlatformFilterStage_t     stages[] = 
+	{
+		{ PlatformFilterType_Median,          &median    },
+		{ PlatformFilterType_MovingAverageQ7, &averageQ7 },
+		{ PlatformFilterType_FIR,             &fir       },
+	};
+	int16_t output;
+	int     numOutputs = 0;
+	
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMedian( &median, 3 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMovingAverageQ7( &averageQ7, historyQ7, 2 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformFilter_InitFIR( &fir, kHalves, historyFIR, 2, 2 ) == PlatformStatus_Success );
+	
+	// A 10-bit ADC reading scaled up to Q15 passes through the Q7 stage at 8-bit resolution, rather than being truncated to its low byte
+	for ( int i = 0; i < 40; i++ )
+	{
+		numOutputs += PlatformFilter_ProcessChain( stages, 3, ( int16_t )( 700 << 5 ), &output ) ? 1 : 0;
+	}
+	
+	printf( "Chain:              %d outputs, settled at %d for an input of %d\n", numOutputs, output, 700 << 5 );
+	PLATFORM_TEST_CHECK( numOutputs == 20 );
+	PLATFORM_TEST_CHECK( abs( output - ( 700 << 5 )) <= 128 );
+	
+	// The largest Q15 sample saturates in Q7 rather than wrapping negative
+	PLATFORM_TEST_CHECK( PlatformFilter_InitMovingAverageQ7( &averageQ7, historyQ7, 0 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformFilter_ProcessChain( &stages[1], 1, INT16_MAX, &output ) && ( output == 127 * 256 ));
+	PLATFORM_TEST_CHECK( PlatformFilter_ProcessChain( &stages[1], 1, INT16_MIN, &output ) && ( output == INT16_MIN ));
+}
+
+static void _PlatformFilterTest_Benchmark( void )
+{
+	static const int16_t kCoefficients[ 16 ] = { 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048, 2048 };
+	PlatformFilterMovingAverageQ15_t averageQ15;
+	PlatformFilterMovingAverageQ7_t  averageQ7;
+	PlatformFilterIIR_t              iir;
+	PlatformFilterMedian_t           median;
+	PlatformFilterFIR_t              fir;
+	int16_t historyQ15[ 16 ];
+	int8_t  historyQ7[ 16 ];
+	int16_t historyFIR[ 16 ];
+	const char *const kNames[] = { "Moving average Q15 (16)", "Moving average Q7 (16)", "IIR (shift 4)", "Median (5)", "FIR (16 taps, / 1)", "FIR (16 taps, / 4)" };
+	
+	_PlatformFilterTest_MakeInput( 30000.0, 1000 );
+	
+	printf( "\nHost benchmark, %lu samples each:\n", PLATFORM_FILTER_TEST_NUM_BENCHMARK );
+	
+	for ( int test = 0; test < 6; test++ )
+	{
+		const clock_t start = clock();
+		double nsPerSample;
+		
+		( void )PlatformFilter_InitMovingAverageQ15( &averageQ15, historyQ15, 4 );
+		( void )PlatformFilter_InitMovingAverageQ7( &averageQ7, historyQ7, 4 );
+		( void )PlatformFilter_InitIIR( &iir, 4 );
+		( void )PlatformFilter_InitMedian( &median, 5 );
+		( void )PlatformFilter_InitFIR( &fir, kCoefficients, historyFIR, 16, ( test == 5 ) ? 4 : 1 );
+		
+		for ( unsigned long i = 0; i < PLATFORM_FILTER_TEST_NUM_BENCHMARK; i++ )
+		{
+			const int16_t sample = mPlatformFilterTestInput[ i % PLATFORM_FILTER_TEST_NUM_SAMPLES ];
+			int16_t output = 0;
+			int8_t  outputQ7;
+			
+			switch ( test )
+			{
+				case 0:  PlatformFilter_ProcessMovingAverageQ15( &averageQ15, sample, &output ); break;
+				case 1:  PlatformFilter_ProcessMovingAverageQ7( &averageQ7, ( int8_t )sample, &outputQ7 ); output = outputQ7; break;
+				case 2:  PlatformFilter_ProcessIIR( &iir, sample, &output ); break;
+				case 3:  PlatformFilter_ProcessMedian( &median, sample, &output ); break;
+				default: PlatformFilter_ProcessFIR( &fir, sample, &output ); break;
+			}
+			
+			mPlatformFilterTestSink = output;
+		}
+		
+		nsPerSample = ( double )( clock() - start ) * 1e9 / CLOCKS_PER_SEC / PLATFORM_FILTER_TEST_NUM_BENCHMARK;
+		printf( "  %-24s %6.1f ns/sample\n", kNames[ test ], nsPerSample );
+	}
+}
\ No newline at end of file
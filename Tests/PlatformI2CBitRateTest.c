@@ -0,0 +1,153 @@
+/*
+ * PlatformI2CBitRateTest.c
+ *
+ * Host test of PlatformI2CBitRate_Calculate() across CPU clocks from 1 to 20MHz and targets up to UINT32_MAX, 
+ * against a brute-force search of every prescaler and TWBR value.
+ * From the repository root:
+ *   gcc -std=gnu99 -O2 -Wall -Wextra -ITests -IPlatformI2C -IPlatformStatus Tests/PlatformI2CBitRateTest.c PlatformI2C/PlatformI2CBitRate.c -o /tmp/PlatformI2CBitRateTest && /tmp/PlatformI2CBitRateTest
+ *
+ * Created: 2026-10-18 9:58:47 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformTest.h"
+#include "PlatformI2CBitRate.h"
+#include <stdio.h>
+#include <stddef.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_I2C_BIT_RATE_TEST_MAX_DIVIDER ( 16UL + 2UL * 255 * 64 )
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+static const uint8_t kPlatformI2CBitRateTestPrescalers[] = { 1, 4, 16, 64 };
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void _PlatformI2CBitRateTest_Check( const uint32_t inCPUFreqHz, const uint32_t inTargetSCLHz );
+
+//============//
+//    Main    //
+//============//
+
+int main( void )
+{
+	static const uint32_t kTargets[] = { 1, 100, 1000, 10000, 50000, 100000, 400000, 1000000, 3400000, 0xFFFFFFFFUL };
+	uint8_t  prescalerBits;
+	uint8_t  bitRate;
+	uint32_t actualSCLHz;
+	
+	// Every whole MHz
+	for ( uint32_t cpuFreqHz = 1000000; cpuFreqHz <= 20000000; cpuFreqHz += 1000000 )
+	{
+		for ( size_t i = 0; i < sizeof( kTargets ) / sizeof( kTargets[0] ); i++ )
+		{
+			_PlatformI2CBitRateTest_Check( cpuFreqHz, kTargets[i] );
+		}
+		
+		// A geometric sweep of targets, up to UINT32_MAX
+		for ( double target = 1.0; target < 4294967295.0; target *= 1.013 )
+		{
+			_PlatformI2CBitRateTest_Check( cpuFreqHz, ( uint32_t )target );
+		}
+		
+		// Every target around the fast end, where the steps are coarsest
+		for ( uint32_t target = cpuFreqHz / 600; target <= cpuFreqHz / 14; target += 97 )
+		{
+			_PlatformI2CBitRateTest_Check( cpuFreqHz, target );
+		}
+	}
+	
+	// Common UART crystals
+	_PlatformI2CBitRateTest_Check( 3686400,  100000 );
+	_PlatformI2CBitRateTest_Check( 7372800,  400000 );
+	_PlatformI2CBitRateTest_Check( 14745600, 400000 );
+	
+	// The known settings for this board's 8MHz clock
+	PLATFORM_TEST_CHECK( PlatformI2CBitRate_Calculate( 8000000, 400000, &prescalerBits, &bitRate, &actualSCLHz ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( prescalerBits == 0 ) && ( bitRate == 2 ) && ( actualSCLHz == 400000 ));
+	PLATFORM_TEST_CHECK( PlatformI2CBitRate_Calculate( 8000000, 100000, &prescalerBits, &bitRate, &actualSCLHz ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( prescalerBits == 0 ) && ( bitRate == 32 ) && ( actualSCLHz == 100000 ));
+	PLATFORM_TEST_CHECK( PlatformI2CBitRate_Calculate( 8000000, 0xFFFFFFFFUL, &prescalerBits, &bitRate, &actualSCLHz ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( prescalerBits == 0 ) && ( bitRate == 0 ) && ( actualSCLHz == 500000 ));
+	
+	// Invalid arguments
+	PLATFORM_TEST_CHECK( PlatformI2CBitRate_Calculate( 8000000, 0,      &prescalerBits, &bitRate, &actualSCLHz ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformI2CBitRate_Calculate( 8000000, 100000, NULL,           &bitRate, &actualSCLHz ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformI2CBitRate_Calculate( 8000000, 100000, &prescalerBits, NULL,     &actualSCLHz ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformI2CBitRate_Calculate( 8000000, 100000, &prescalerBits, &bitRate, NULL         ) == PlatformStatus_InvalidArgument );
+	
+	return PLATFORM_TEST_RESULT();
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static void _PlatformI2CBitRateTest_Check( const uint32_t inCPUFreqHz, const uint32_t inTargetSCLHz )
+{
+	uint8_t        prescalerBits = 0xFF;
+	uint8_t        bitRate       = 0;
+	uint32_t       actualSCLHz   = 0;
+	uint32_t       bestDivider   = 0;
+	uint8_t        bestPrescalerBits = 0;
+	PlatformStatus status;
+	
+	// Brute force: the smallest divider, so the fastest SCL, that doesn't exceed the target, using the smallest prescaler that reaches it
+	for ( uint8_t prescalerIndex = 0; prescalerIndex < sizeof( kPlatformI2CBitRateTestPrescalers ); prescalerIndex++ )
+	{
+		for ( uint32_t twbr = 0; twbr <= 255; twbr++ )
+		{
+			const uint32_t divider = 16UL + 2UL * twbr * kPlatformI2CBitRateTestPrescalers[ prescalerIndex ];
+			
+			if ((( uint64_t )inTargetSCLHz * divider >= inCPUFreqHz ) && (( bestDivider == 0 ) || ( divider < bestDivider )))
+			{
+				bestDivider       = divider;
+				bestPrescalerBits = prescalerIndex;
+			}
+		}
+	}
+	
+	status = PlatformI2CBitRate_Calculate( inCPUFreqHz, inTargetSCLHz, &prescalerBits, &bitRate, &actualSCLHz );
+	
+	if ( bestDivider == 0 )
+	{
+		// Slower than the largest divider allows
+		PLATFORM_TEST_CHECK(( uint64_t )inTargetSCLHz * PLATFORM_I2C_BIT_RATE_TEST_MAX_DIVIDER < inCPUFreqHz );
+		PLATFORM_TEST_CHECK( status == PlatformStatus_InvalidArgument );
+		return;
+	}
+	
+	PLATFORM_TEST_CHECK( status == PlatformStatus_Success );
+	if ( status != PlatformStatus_Success )
+	{
+		printf( "  F_CPU %lu, target %lu: status %d\n", ( unsigned long )inCPUFreqHz, ( unsigned long )inTargetSCLHz, status );
+		return;
+	}
+	
+	PLATFORM_TEST_CHECK( prescalerBits < sizeof( kPlatformI2CBitRateTestPrescalers ));
+	if ( prescalerBits >= sizeof( kPlatformI2CBitRateTestPrescalers ))
+	{
+		return;
+	}
+	
+	const uint32_t divider = 16UL + 2UL * bitRate * kPlatformI2CBitRateTestPrescalers[ prescalerBits ];
+	
+	if (( divider != bestDivider ) || ( prescalerBits != bestPrescalerBits ))
+	{
+		printf( "  F_CPU %lu, target %lu: got prescaler %u TWBR %u, expected divider %lu with prescaler %u\n", 
+		        ( unsigned long )inCPUFreqHz, ( unsigned long )inTargetSCLHz, prescalerBits, bitRate, ( unsigned long )bestDivider, bestPrescalerBits );
+	}
+	
+	PLATFORM_TEST_CHECK( divider == bestDivider );
+	PLATFORM_TEST_CHECK( prescalerBits == bestPrescalerBits );
+	PLATFORM_TEST_CHECK( actualSCLHz == inCPUFreqHz / divider );
+	PLATFORM_TEST_CHECK( actualSCLHz <= inTargetSCLHz );
+}
\ No newline at end of file
@@ -0,0 +1,458 @@
+/*
+ * PlatformI2CHostTest.c
+ *
+ * Host regression test of PlatformI2C and the drivers built on it, running against the simulated TWI and slave models of PlatformI2CHost. 
+ * Prints the bus transactions each operation takes.
+ * From the repository root:
+ *   gcc -std=gnu99 -O2 -Wall -Wextra -DPLATFORM_I2C_HOST -DPLATFORM_I2C_TRACE_ENABLED=1 -ITests -IPlatformI2C -IPlatformStatus -IPlatformTimer -IPlatformClock -IPlatformGPIO -IPlatformPowerSave Tests/PlatformI2CHostTest.c PlatformI2C/PlatformI2C*.c -o /tmp/PlatformI2CHostTest && /tmp/PlatformI2CHostTest
+ *
+ * Created: 2026-10-18 10:07:52 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformTest.h"
+#include "PlatformI2C.h"
+#include "PlatformI2CHost.h"
+#include "PlatformI2CEEPROM.h"
+#include "PlatformI2CRegCache.h"
+#include "PlatformTimer.h"
+#include "PlatformGPIO.h"
+#include <stdio.h>
+#include <string.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR     ( 0x20 )
+#define PLATFORM_I2C_HOST_TEST_REGISTERS16_ADDR   ( 0x28 )
+#define PLATFORM_I2C_HOST_TEST_HANGING_ADDR       ( 0x30 )
+#define PLATFORM_I2C_HOST_TEST_STRETCHING_ADDR    ( 0x38 )
+#define PLATFORM_I2C_HOST_TEST_EEPROM_ADDR        ( 0x50 )
+#define PLATFORM_I2C_HOST_TEST_ABSENT_ADDR        ( 0x7E )
+
+#define PLATFORM_I2C_HOST_TEST_EEPROM_SIZE        ( 4096 )
+#define PLATFORM_I2C_HOST_TEST_EEPROM_PAGE_SIZE   ( 32 )
+#define PLATFORM_I2C_HOST_TEST_EEPROM_WRITE_TICKS ( 5 * PLATFORM_TIMER_TICKS_PER_MS )
+#define PLATFORM_I2C_HOST_TEST_STRETCH_TICKS      ( 1000 )
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+static uint8_t mPlatformI2CHostTestRegisters[ 16 ];
+static uint8_t mPlatformI2CHostTestRegisters16[ 512 ];
+static uint8_t mPlatformI2CHostTestHangingRegisters[ 4 ];
+static uint8_t mPlatformI2CHostTestStretchingRegisters[ 8 ];
+static uint8_t mPlatformI2CHostTestEEPROMMemory[ PLATFORM_I2C_HOST_TEST_EEPROM_SIZE ];
+
+static PlatformI2CHostRegisterFile_t mPlatformI2CHostTestRegisterFile;
+static PlatformI2CHostRegisterFile_t mPlatformI2CHostTestRegisterFile16;
+static PlatformI2CHostRegisterFile_t mPlatformI2CHostTestHangingDevice;
+static PlatformI2CHostRegisterFile_t mPlatformI2CHostTestStretchingDevice;
+static PlatformI2CHostEEPROM_t       mPlatformI2CHostTestEEPROM;
+
+static PlatformI2CHostStats_t mPlatformI2CHostTestLastStats;
+static uint32_t               mPlatformI2CHostTestLastTicks;
+
+static volatile uint8_t mPlatformI2CHostTestNumCallbacks;
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void _PlatformI2CHostTest_Setup( void );
+static void _PlatformI2CHostTest_StartMeasuring( void );
+static void _PlatformI2CHostTest_Report( const char *const inName, PlatformI2CHostStats_t *const outDelta );
+static void _PlatformI2CHostTest_TransactionCompleteCb( PlatformI2CTransaction_t *const inTransaction, const PlatformStatus inStatus );
+
+static void _PlatformI2CHostTest_ReadWrite( void );
+static void _PlatformI2CHostTest_NACKs( void );
+static void _PlatformI2CHostTest_ScatterGather( void );
+static void _PlatformI2CHostTest_ClockStretching( void );
+static void _PlatformI2CHostTest_BusHang( const bool inAreInterruptsEnabled );
+static void _PlatformI2CHostTest_Submit( void );
+static void _PlatformI2CHostTest_EEPROM( void );
+static void _PlatformI2CHostTest_RegCache( void );
+
+//============//
+//    Main    //
+//============//
+
+int main( void )
+{
+	_PlatformI2CHostTest_Setup();
+	
+	printf( "%-36s %6s %6s %6s %6s %9s\n", "Operation", "STARTs", "STOPs", "Bytes", "NACKs", "Bus (us)" );
+	
+	_PlatformI2CHostTest_ReadWrite();
+	_PlatformI2CHostTest_NACKs();
+	_PlatformI2CHostTest_ScatterGather();
+	_PlatformI2CHostTest_ClockStretching();
+	_PlatformI2CHostTest_BusHang( true );
+	_PlatformI2CHostTest_BusHang( false );
+	_PlatformI2CHostTest_Submit();
+	_PlatformI2CHostTest_EEPROM();
+	_PlatformI2CHostTest_RegCache();
+	
+	PLATFORM_TEST_CHECK( PlatformI2C_Deinit() == PlatformStatus_Success );
+	
+	return PLATFORM_TEST_RESULT();
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static void _PlatformI2CHostTest_Setup( void )
+{
+	uint32_t actualSCLHz = 0;
+	
+	PlatformI2CHost_Reset();
+	
+	PlatformI2CHost_InitRegisterFile( &mPlatformI2CHostTestRegisterFile, PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 
+	                                  mPlatformI2CHostTestRegisters, sizeof( mPlatformI2CHostTestRegisters ), 1 );
+	PlatformI2CHost_InitRegisterFile( &mPlatformI2CHostTestRegisterFile16, PLATFORM_I2C_HOST_TEST_REGISTERS16_ADDR, 
+	                                  mPlatformI2CHostTestRegisters16, sizeof( mPlatformI2CHostTestRegisters16 ), 2 );
+	PlatformI2CHost_InitRegisterFile( &mPlatformI2CHostTestHangingDevice, PLATFORM_I2C_HOST_TEST_HANGING_ADDR, 
+	                                  mPlatformI2CHostTestHangingRegisters, sizeof( mPlatformI2CHostTestHangingRegisters ), 1 );
+	PlatformI2CHost_InitRegisterFile( &mPlatformI2CHostTestStretchingDevice, PLATFORM_I2C_HOST_TEST_STRETCHING_ADDR, 
+	                                  mPlatformI2CHostTestStretchingRegisters, sizeof( mPlatformI2CHostTestStretchingRegisters ), 1 );
+	
+	memset( mPlatformI2CHostTestEEPROMMemory, 0xFF, sizeof( mPlatformI2CHostTestEEPROMMemory ));
+	PlatformI2CHost_InitEEPROM( &mPlatformI2CHostTestEEPROM, PLATFORM_I2C_HOST_TEST_EEPROM_ADDR, mPlatformI2CHostTestEEPROMMemory, 
+	                            PLATFORM_I2C_HOST_TEST_EEPROM_SIZE, 2, PLATFORM_I2C_HOST_TEST_EEPROM_PAGE_SIZE, PLATFORM_I2C_HOST_TEST_EEPROM_WRITE_TICKS );
+	
+	PLATFORM_TEST_CHECK( PlatformI2CHost_AddSlave( &mPlatformI2CHostTestRegisterFile.slave )    == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CHost_AddSlave( &mPlatformI2CHostTestRegisterFile16.slave )  == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CHost_AddSlave( &mPlatformI2CHostTestHangingDevice.slave )   == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CHost_AddSlave( &mPlatformI2CHostTestStretchingDevice.slave ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CHost_AddSlave( &mPlatformI2CHostTestEEPROM.slave )          == PlatformStatus_Success );
+	
+	// Timeouts need PlatformTimer, so I2C can't start without it
+	PlatformI2CHost_SetTimerInitialized( false );
+	PLATFORM_TEST_CHECK( PlatformI2C_Init( PLATFORM_I2C_FAST_MODE_HZ, &actualSCLHz ) == PlatformStatus_NotInitialized );
+	PlatformI2CHost_SetTimerInitialized( true );
+	
+	PLATFORM_TEST_CHECK( PlatformI2C_Init( PLATFORM_I2C_FAST_MODE_HZ, &actualSCLHz ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( actualSCLHz == PLATFORM_I2C_FAST_MODE_HZ );
+	PLATFORM_TEST_CHECK( PlatformI2C_Init( PLATFORM_I2C_FAST_MODE_HZ, NULL ) == PlatformStatus_AlreadyInitialized );
+}
+
+static void _PlatformI2CHostTest_StartMeasuring( void )
+{
+	PlatformI2CHost_GetStats( &mPlatformI2CHostTestLastStats );
+	mPlatformI2CHostTestLastTicks = PlatformI2CHost_GetTicks();
+}
+
+// Prints the bus activity since _PlatformI2CHostTest_StartMeasuring()
+static void _PlatformI2CHostTest_Report( const char *const inName, PlatformI2CHostStats_t *const outDelta )
+{
+	PlatformI2CHostStats_t stats;
+	
+	PlatformI2CHost_GetStats( &stats );
+	
+	outDelta->numStarts         = stats.numStarts         - mPlatformI2CHostTestLastStats.numStarts;
+	outDelta->numStops          = stats.numStops          - mPlatformI2CHostTestLastStats.numStops;
+	outDelta->numAddressNACKs   = stats.numAddressNACKs   - mPlatformI2CHostTestLastStats.numAddressNACKs;
+	outDelta->numBytes          = stats.numBytes          - mPlatformI2CHostTestLastStats.numBytes;
+	outDelta->busTicks          = stats.busTicks          - mPlatformI2CHostTestLastStats.busTicks;
+	outDelta->numRecoveryClocks = stats.numRecoveryClocks - mPlatformI2CHostTestLastStats.numRecoveryClocks;
+	
+	printf( "%-36s %6lu %6lu %6lu %6lu %9lu\n", inName, 
+	        ( unsigned long )outDelta->numStarts, ( unsigned long )outDelta->numStops, ( unsigned long )outDelta->numBytes, 
+	        ( unsigned long )outDelta->numAddressNACKs, ( unsigned long )( outDelta->busTicks / ( F_CPU / 1000000UL )));
+}
+
+static void _PlatformI2CHostTest_TransactionCompleteCb( PlatformI2CTransaction_t *const inTransaction, const PlatformStatus inStatus )
+{
+	PLATFORM_TEST_CHECK( inTransaction->status == inStatus );
+	mPlatformI2CHostTestNumCallbacks++;
+}
+
+static void _PlatformI2CHostTest_ReadWrite( void )
+{
+	static const uint8_t kData[ 4 ] = { 0x11, 0x22, 0x33, 0x44 };
+	PlatformI2CHostStats_t delta;
+	uint8_t readData[ 4 ] = { 0 };
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Write( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 3, kData, sizeof( kData )) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "Write 4 bytes", &delta );
+	PLATFORM_TEST_CHECK( memcmp( &mPlatformI2CHostTestRegisters[3], kData, sizeof( kData )) == 0 );
+	PLATFORM_TEST_CHECK(( delta.numStarts == 1 ) && ( delta.numStops == 1 ) && ( delta.numBytes == 6 ));
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 4, readData, 3 ) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "Read 3 bytes", &delta );
+	PLATFORM_TEST_CHECK(( readData[0] == 0x22 ) && ( readData[1] == 0x33 ) && ( readData[2] == 0x44 ));
+	PLATFORM_TEST_CHECK(( delta.numStarts == 2 ) && ( delta.numStops == 1 ) && ( delta.numBytes == 6 ));
+	
+	PLATFORM_TEST_CHECK( PlatformI2C_WriteByte( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 0, 0xA5 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( mPlatformI2CHostTestRegisters[0] == 0xA5 );
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Probe( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR ) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "Probe", &delta );
+	PLATFORM_TEST_CHECK(( delta.numStarts == 1 ) && ( delta.numStops == 1 ) && ( delta.numBytes == 1 ));
+	
+	PLATFORM_TEST_CHECK( !PlatformI2C_IsBusy() );
+}
+
+static void _PlatformI2CHostTest_NACKs( void )
+{
+	static const uint8_t kData[ 4 ] = { 0 };
+	PlatformI2CHostStats_t delta;
+	uint8_t readData[ 2 ];
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_ABSENT_ADDR, 0, readData, sizeof( readData )) == PlatformStatus_Failed );
+	PLATFORM_TEST_CHECK( PlatformI2C_Probe( PLATFORM_I2C_HOST_TEST_ABSENT_ADDR ) == PlatformStatus_Failed );
+	_PlatformI2CHostTest_Report( "Read and probe an absent device", &delta );
+	PLATFORM_TEST_CHECK(( delta.numAddressNACKs == 2 ) && ( delta.numStops == 2 ));
+	
+	// The register file NACKs writes past its last register
+	PLATFORM_TEST_CHECK( PlatformI2C_Write( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 14, kData, sizeof( kData )) == PlatformStatus_Failed );
+	
+	// A device that stops acknowledging its address, then comes back
+	mPlatformI2CHostTestRegisterFile.slave.isNACKingAddress = true;
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 0, readData, 1 ) == PlatformStatus_Failed );
+	mPlatformI2CHostTestRegisterFile.slave.isNACKingAddress = false;
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 0, readData, 1 ) == PlatformStatus_Success );
+}
+
+static void _PlatformI2CHostTest_ScatterGather( void )
+{
+	uint8_t header[ 2 ]   = { 0xDE, 0xAD };
+	uint8_t payload[ 3 ]  = { 0xBE, 0xEF, 0x01 };
+	uint8_t readHead[ 2 ] = { 0 };
+	uint8_t readTail[ 3 ] = { 0 };
+	const PlatformI2CSegment_t segments[] = 
+	{
+		// Gather two buffers into one write to register 0x0123, then scatter a read of it into two buffers
+		{ PlatformI2CDirection_Write, 0x0123, 2, header,   sizeof( header )   },
+		{ PlatformI2CDirection_Write, 0,      0, payload,  sizeof( payload )  },
+		{ PlatformI2CDirection_Read,  0x0123, 2, readHead, sizeof( readHead ) },
+		{ PlatformI2CDirection_Read,  0,      0, readTail, sizeof( readTail ) },
+	};
+	PlatformI2CHostStats_t delta;
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Transfer( PLATFORM_I2C_HOST_TEST_REGISTERS16_ADDR, segments, 4 ) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "Scatter-gather, 16-bit register", &delta );
+	
+	PLATFORM_TEST_CHECK(( mPlatformI2CHostTestRegisters16[ 0x0123 ] == 0xDE ) && ( mPlatformI2CHostTestRegisters16[ 0x0127 ] == 0x01 ));
+	PLATFORM_TEST_CHECK( memcmp( readHead, header, sizeof( header )) == 0 );
+	PLATFORM_TEST_CHECK( memcmp( readTail, payload, sizeof( payload )) == 0 );
+	
+	// START for the write, repeated START for the read's register address, and repeated START for SLA+R
+	PLATFORM_TEST_CHECK(( delta.numStarts == 3 ) && ( delta.numStops == 1 ));
+	PLATFORM_TEST_CHECK( delta.numBytes == ( 1 + 2 + 5 ) + ( 1 + 2 ) + ( 1 + 5 ));
+	
+	// Malformed transactions are rejected before touching the bus
+	PLATFORM_TEST_CHECK( PlatformI2C_Transfer( PLATFORM_I2C_HOST_TEST_REGISTERS16_ADDR, segments, 0 ) == PlatformStatus_InvalidArgument );
+	PLATFORM_TEST_CHECK( PlatformI2C_Transfer( PLATFORM_I2C_HOST_TEST_REGISTERS16_ADDR, NULL, 1 ) == PlatformStatus_InvalidArgument );
+}
+
+static void _PlatformI2CHostTest_ClockStretching( void )
+{
+	PlatformI2CHostStats_t delta;
+	uint8_t  readData[ 4 ];
+	uint32_t plainTicks;
+	uint32_t stretchedTicks;
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_STRETCHING_ADDR, 0, readData, sizeof( readData )) == PlatformStatus_Success );
+	plainTicks = PlatformI2CHost_GetTicks() - mPlatformI2CHostTestLastTicks;
+	
+	mPlatformI2CHostTestStretchingDevice.slave.stretchTicks = PLATFORM_I2C_HOST_TEST_STRETCH_TICKS;
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_STRETCHING_ADDR, 0, readData, sizeof( readData )) == PlatformStatus_Success );
+	stretchedTicks = PlatformI2CHost_GetTicks() - mPlatformI2CHostTestLastTicks;
+	_PlatformI2CHostTest_Report( "Read 4 bytes, stretched", &delta );
+	
+	// The register address and each data byte are stretched, but stay well inside the timeout
+	printf( "  stretching added %lu us\n", ( unsigned long )(( stretchedTicks - plainTicks ) / ( F_CPU / 1000000UL )));
+	PLATFORM_TEST_CHECK(( stretchedTicks - plainTicks ) >= 5 * PLATFORM_I2C_HOST_TEST_STRETCH_TICKS );
+	
+	mPlatformI2CHostTestStretchingDevice.slave.stretchTicks = 0;
+}
+
+static void _PlatformI2CHostTest_BusHang( const bool inAreInterruptsEnabled )
+{
+	PlatformI2CRecoveryCounters_t before;
+	PlatformI2CRecoveryCounters_t after;
+	PlatformI2CHostStats_t delta;
+	uint8_t  readData;
+	uint32_t elapsedTicks;
+#if PLATFORM_I2C_TRACE_ENABLED
+	PlatformI2CTraceRecord_t records[ PLATFORM_I2C_TRACE_SIZE ];
+	uint8_t numRecords = 0;
+#endif
+	
+	PLATFORM_TEST_CHECK( PlatformI2C_GetRecoveryCounters( &before ) == PlatformStatus_Success );
+	
+	// The device holds SDA low after its address, until the bus is recovered
+	mPlatformI2CHostTestHangingDevice.slave.numBusHangs = 1;
+	
+	// One run with the internal pull-up on SDA, one without
+	PORTC = inAreInterruptsEnabled ? PLATFORM_GPIO_PIN_MASK( PlatformGPIO_PTC4 ) : 0;
+	
+	if ( !inAreInterruptsEnabled )
+	{
+		PlatformI2CHost_SetInterruptsEnabled( false );
+	}
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_HANGING_ADDR, 0, &readData, 1 ) == PlatformStatus_Timeout );
+	elapsedTicks = PlatformI2CHost_GetTicks() - mPlatformI2CHostTestLastTicks;
+	_PlatformI2CHostTest_Report( inAreInterruptsEnabled ? "Bus hang, recovered" : "Bus hang, interrupts off, recovered", &delta );
+	
+	// Without interrupts PlatformTimer stops, so the timeout must still end the transfer
+	printf( "  timed out after %lu us\n", ( unsigned long )( elapsedTicks / ( F_CPU / 1000000UL )));
+	PLATFORM_TEST_CHECK( elapsedTicks >= PLATFORM_I2C_TIMEOUT_MS * PLATFORM_TIMER_TICKS_PER_MS );
+	PLATFORM_TEST_CHECK( elapsedTicks < 2 * PLATFORM_I2C_TIMEOUT_MS * PLATFORM_TIMER_TICKS_PER_MS );
+	PLATFORM_TEST_CHECK( delta.numRecoveryClocks >= 1 );
+	
+	PLATFORM_TEST_CHECK( PlatformI2C_GetRecoveryCounters( &after ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( after.numTimeouts == before.numTimeouts + 1 );
+	PLATFORM_TEST_CHECK( after.numRecoveries == before.numRecoveries + 1 );
+	PLATFORM_TEST_CHECK( after.numFailedRecoveries == before.numFailedRecoveries );
+	
+#if PLATFORM_I2C_TRACE_ENABLED
+	// The trace keeps the status the transaction was stuck on, not the reset status left by the recovery
+	PLATFORM_TEST_CHECK( PlatformI2C_GetTraceRecords( records, PLATFORM_I2C_TRACE_SIZE, &numRecords ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( numRecords > 0 );
+	if ( numRecords > 0 )
+	{
+		printf( "  traced TWSR status 0x%02X\n", records[ numRecords - 1 ].twsrStatus );
+		PLATFORM_TEST_CHECK( records[ numRecords - 1 ].status     == PlatformStatus_Timeout );
+		PLATFORM_TEST_CHECK( records[ numRecords - 1 ].twsrStatus != 0xF8 );
+	}
+#endif
+	
+	// Recovery leaves the internal pull-ups as it found them
+	PLATFORM_TEST_CHECK( PORTC == ( inAreInterruptsEnabled ? PLATFORM_GPIO_PIN_MASK( PlatformGPIO_PTC4 ) : 0 ));
+	
+	// The bus works again after recovery
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_HANGING_ADDR, 0, &readData, 1 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2C_Read( PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 0, &readData, 1 ) == PlatformStatus_Success );
+	
+	PlatformI2CHost_SetInterruptsEnabled( true );
+}
+
+static void _PlatformI2CHostTest_Submit( void )
+{
+	uint8_t data[ 2 ][ 2 ] = {{ 0x5A, 0x5B }, { 0x6A, 0x6B }};
+	const PlatformI2CSegment_t segments[ 2 ] = 
+	{
+		{ PlatformI2CDirection_Write, 8,  1, data[0], 2 },
+		{ PlatformI2CDirection_Write, 10, 1, data[1], 2 },
+	};
+	PlatformI2CTransaction_t transactions[ 2 ] = 
+	{
+		{ .deviceAddr = PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, .segments = &segments[0], .numSegments = 1, .completeCb = _PlatformI2CHostTest_TransactionCompleteCb },
+		{ .deviceAddr = PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, .segments = &segments[1], .numSegments = 1, .completeCb = _PlatformI2CHostTest_TransactionCompleteCb },
+	};
+	
+	mPlatformI2CHostTestNumCallbacks = 0;
+	
+	// Queue the second behind the first by holding off the ISR
+	PlatformI2CHost_SetInterruptsEnabled( false );
+	PLATFORM_TEST_CHECK( PlatformI2C_Submit( &transactions[0] ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2C_Submit( &transactions[1] ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2C_IsBusy() );
+	PlatformI2CHost_SetInterruptsEnabled( true );
+	
+	PLATFORM_TEST_CHECK( transactions[0].isComplete && ( transactions[0].status == PlatformStatus_Success ));
+	PLATFORM_TEST_CHECK( transactions[1].isComplete && ( transactions[1].status == PlatformStatus_Success ));
+	PLATFORM_TEST_CHECK( mPlatformI2CHostTestNumCallbacks == 2 );
+	PLATFORM_TEST_CHECK(( mPlatformI2CHostTestRegisters[8] == 0x5A ) && ( mPlatformI2CHostTestRegisters[11] == 0x6B ));
+	PLATFORM_TEST_CHECK( !PlatformI2C_IsBusy() );
+}
+
+static void _PlatformI2CHostTest_EEPROM( void )
+{
+	PlatformI2CEEPROM_t    eeprom;
+	PlatformI2CHostStats_t delta;
+	uint8_t  data[ 100 ];
+	uint8_t  readData[ 100 ];
+	uint32_t elapsedTicks;
+	
+	for ( size_t i = 0; i < sizeof( data ); i++ )
+	{
+		data[i] = ( uint8_t )( i * 3 );
+	}
+	
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Init( &eeprom, PLATFORM_I2C_HOST_TEST_EEPROM_ADDR, 2, 
+	                                             PLATFORM_I2C_HOST_TEST_EEPROM_PAGE_SIZE, PLATFORM_I2C_HOST_TEST_EEPROM_SIZE ) == PlatformStatus_Success );
+	
+	// 100 bytes from address 20 spans 4 pages: 12, 32, 32 and 24 bytes
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Write( &eeprom, 20, data, sizeof( data )) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Sync( &eeprom ) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "EEPROM write 100 bytes over 4 pages", &delta );
+	PLATFORM_TEST_CHECK( memcmp( &mPlatformI2CHostTestEEPROMMemory[20], data, sizeof( data )) == 0 );
+	PLATFORM_TEST_CHECK(( mPlatformI2CHostTestEEPROMMemory[19] == 0xFF ) && ( mPlatformI2CHostTestEEPROMMemory[120] == 0xFF ));
+	
+	// The write cycle is polled for with the address NACKed, rather than waited out with a fixed delay
+	PLATFORM_TEST_CHECK( delta.numAddressNACKs > 0 );
+	
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Read( &eeprom, 20, readData, sizeof( readData )) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "EEPROM read 100 bytes", &delta );
+	PLATFORM_TEST_CHECK( memcmp( readData, data, sizeof( data )) == 0 );
+	PLATFORM_TEST_CHECK( delta.numStops == 1 );
+	
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Read( &eeprom, PLATFORM_I2C_HOST_TEST_EEPROM_SIZE - 1, readData, 2 ) == PlatformStatus_InvalidArgument );
+	
+	// A device that dies in its write cycle times out, even with global interrupts disabled and PlatformTimer stopped
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Write( &eeprom, 0, data, 1 ) == PlatformStatus_Success );
+	mPlatformI2CHostTestEEPROM.slave.isNACKingAddress = true;
+	PlatformI2CHost_SetInterruptsEnabled( false );
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Sync( &eeprom ) == PlatformStatus_Timeout );
+	elapsedTicks = PlatformI2CHost_GetTicks() - mPlatformI2CHostTestLastTicks;
+	PlatformI2CHost_SetInterruptsEnabled( true );
+	printf( "  dead EEPROM timed out after %lu us\n", ( unsigned long )( elapsedTicks / ( F_CPU / 1000000UL )));
+	PLATFORM_TEST_CHECK( elapsedTicks >= PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_MS * PLATFORM_TIMER_TICKS_PER_MS );
+	PLATFORM_TEST_CHECK( elapsedTicks < 4 * PLATFORM_I2C_EEPROM_WRITE_TIMEOUT_MS * PLATFORM_TIMER_TICKS_PER_MS );
+	
+	mPlatformI2CHostTestEEPROM.slave.isNACKingAddress = false;
+	PLATFORM_TEST_CHECK( PlatformI2CEEPROM_Sync( &eeprom ) == PlatformStatus_Success );
+}
+
+static void _PlatformI2CHostTest_RegCache( void )
+{
+	PlatformI2CRegCache_t  cache;
+	PlatformI2CHostStats_t delta;
+	uint8_t shadow[ 8 ];
+	uint8_t value;
+	
+	memset( mPlatformI2CHostTestRegisters, 0, sizeof( mPlatformI2CHostTestRegisters ));
+	PLATFORM_TEST_CHECK( PlatformI2CRegCache_Init( &cache, PLATFORM_I2C_HOST_TEST_REGISTERS_ADDR, 8, shadow, sizeof( shadow ), true ) == PlatformStatus_Success );
+	
+	// Two read-modify-writes of one register read it once, and write nothing until the flush
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2CRegCache_Update( &cache, 8, 0xF0, 0x50 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CRegCache_Update( &cache, 8, 0x0F, 0x03 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CRegCache_Write( &cache, 9, 0xAA ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformI2CRegCache_Write( &cache, 12, 0xBB ) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "Register cache updates", &delta );
+	PLATFORM_TEST_CHECK( delta.numStops == 1 );
+	PLATFORM_TEST_CHECK( mPlatformI2CHostTestRegisters[9] == 0 );
+	
+	// Registers 8-9 and 12 are two runs, flushed as two segments of one transaction
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK( PlatformI2CRegCache_Flush( &cache ) == PlatformStatus_Success );
+	_PlatformI2CHostTest_Report( "Register cache flush", &delta );
+	PLATFORM_TEST_CHECK(( mPlatformI2CHostTestRegisters[8] == 0x53 ) && ( mPlatformI2CHostTestRegisters[9] == 0xAA ) && ( mPlatformI2CHostTestRegisters[12] == 0xBB ));
+	PLATFORM_TEST_CHECK(( delta.numStarts == 2 ) && ( delta.numStops == 1 ));
+	
+	// Cached reads don't touch the bus
+	_PlatformI2CHostTest_StartMeasuring();
+	PLATFORM_TEST_CHECK(( PlatformI2CRegCache_Read( &cache, 9, &value ) == PlatformStatus_Success ) && ( value == 0xAA ));
+	_PlatformI2CHostTest_Report( "Register cache read, cached", &delta );
+	PLATFORM_TEST_CHECK( delta.numStarts == 0 );
+}
\ No newline at end of file
@@ -0,0 +1,328 @@
+/*
+ * PlatformRTCTest.c
+ *
+ * Host test of PlatformRTC and its calendar and alarm logic, running against the simulated Timer2 of PlatformRTCHost.
+ * Calendar conversions are checked against the C library's gmtime_r() over the whole 2000 - 2135 range.
+ * From the repository root:
+ *   gcc -std=gnu99 -O2 -Wall -Wextra -DPLATFORM_RTC_HOST -ITests -IPlatformRTC -IPlatformStatus -IPlatformPowerSave Tests/PlatformRTCTest.c PlatformRTC/PlatformRTC.c PlatformRTC/PlatformRTCCalendar.c PlatformRTC/PlatformRTCHost.c -o /tmp/PlatformRTCTest && /tmp/PlatformRTCTest
+ *
+ * Created: 2026-10-18 11:15:06 PM
+ *  Author: Felix
+ */ 
+
+#include "PlatformTest.h"
+#include "PlatformRTC.h"
+#include "PlatformRTCHost.h"
+#include <stdio.h>
+#include <time.h>
+
+//===============//
+//    Defines    //
+//===============//
+
+#define PLATFORM_RTC_TEST_EPOCH_UNIX_SECONDS ( 946684800LL ) // 2000-01-01 00:00:00 UTC
+#define PLATFORM_RTC_TEST_SECONDS_PER_DAY    ( 86400UL )
+#define PLATFORM_RTC_TEST_MAX_ALARMS         ( 1024 )
+
+//===========================//
+//    Structs & Variables    //
+//===========================//
+
+static uint32_t mPlatformRTCTestAlarms[ PLATFORM_RTC_TEST_MAX_ALARMS ];
+static uint32_t mPlatformRTCTestNumAlarms;
+
+//====================================//
+//    Static Function Declarations    //
+//====================================//
+
+static void _PlatformRTCTest_AlarmCb( const uint32_t inSeconds );
+static void _PlatformRTCTest_RunSeconds( const uint32_t inNumSeconds );
+static void _PlatformRTCTest_CheckConversion( const uint32_t inSeconds );
+
+static void _PlatformRTCTest_InitDeinit( void );
+static void _PlatformRTCTest_TimeKeeping( void );
+static void _PlatformRTCTest_Calendar( void );
+static void _PlatformRTCTest_OneShotAlarms( void );
+static void _PlatformRTCTest_RepeatingAlarms( void );
+
+//============//
+//    Main    //
+//============//
+
+int main( void )
+{
+	PlatformRTCHost_Reset();
+	
+	_PlatformRTCTest_InitDeinit();
+	_PlatformRTCTest_TimeKeeping();
+	_PlatformRTCTest_Calendar();
+	_PlatformRTCTest_OneShotAlarms();
+	_PlatformRTCTest_RepeatingAlarms();
+	
+	PLATFORM_TEST_CHECK( PlatformRTC_Deinit() == PlatformStatus_Success );
+	
+	return PLATFORM_TEST_RESULT();
+}
+
+//===================================//
+//    Static Function Definitions    //
+//===================================//
+
+static void _PlatformRTCTest_AlarmCb( const uint32_t inSeconds )
+{
+	uint32_t seconds = 0;
+	
+	// The callback runs from the ISR, after the count has been updated
+	PLATFORM_TEST_CHECK( !PlatformRTCHost_AreInterruptsEnabled() );
+	PLATFORM_TEST_CHECK(( PlatformRTC_GetTime( &seconds, NULL ) == PlatformStatus_Success ) && ( seconds == inSeconds ));
+	
+	if ( mPlatformRTCTestNumAlarms < PLATFORM_RTC_TEST_MAX_ALARMS )
+	{
+		mPlatformRTCTestAlarms[ mPlatformRTCTestNumAlarms ] = inSeconds;
+	}
+	mPlatformRTCTestNumAlarms++;
+}
+
+static void _PlatformRTCTest_RunSeconds( const uint32_t inNumSeconds )
+{
+	for ( uint32_t i = 0; i < inNumSeconds; i++ )
+	{
+		PlatformRTCHost_Advance( PLATFORM_RTC_SUB_SECONDS_PER_SECOND );
+	}
+}
+
+static void _PlatformRTCTest_CheckConversion( const uint32_t inSeconds )
+{
+	PlatformRTCDateTime_t dateTime;
+	struct tm reference;
+	time_t    unixSeconds = ( time_t )( PLATFORM_RTC_TEST_EPOCH_UNIX_SECONDS + inSeconds );
+	uint32_t  seconds     = 0;
+	
+	gmtime_r( &unixSeconds, &reference );
+	
+	PLATFORM_TEST_CHECK( PlatformRTCCalendar_SecondsToDateTime( inSeconds, &dateTime ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( dateTime.year    == reference.tm_year + 1900 ) && 
+	                    ( dateTime.month   == reference.tm_mon + 1 )     && 
+	                    ( dateTime.day     == reference.tm_mday )        && 
+	                    ( dateTime.hour    == reference.tm_hour )        && 
+	                    ( dateTime.minute  == reference.tm_min )         && 
+	                    ( dateTime.second  == reference.tm_sec )         && 
+	                    ( dateTime.weekday == reference.tm_wday ));
+	
+	// Dates past the last supported year can't be converted back
+	if ( dateTime.year <= PLATFORM_RTC_CALENDAR_MAX_YEAR )
+	{
+		PLATFORM_TEST_CHECK( PlatformRTCCalendar_DateTimeToSeconds( &dateTime, &seconds ) == PlatformStatus_Success );
+		PLATFORM_TEST_CHECK( seconds == inSeconds );
+	}
+	else
+	{
+		PLATFORM_TEST_CHECK( PlatformRTCCalendar_DateTimeToSeconds( &dateTime, &seconds ) == PlatformStatus_InvalidArgument );
+	}
+}
+
+static void _PlatformRTCTest_InitDeinit( void )
+{
+	uint32_t seconds;
+	
+	PLATFORM_TEST_CHECK( PlatformRTC_GetTime( &seconds, NULL ) == PlatformStatus_NotInitialized );
+	PLATFORM_TEST_CHECK( PlatformRTC_Deinit() == PlatformStatus_NotInitialized );
+	
+	// Global interrupts start disabled, so Init enables them and Deinit disables them again
+	PLATFORM_TEST_CHECK( !PlatformRTCHost_AreInterruptsEnabled() );
+	PLATFORM_TEST_CHECK( PlatformRTC_Init( 0 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTCHost_AreInterruptsEnabled() );
+	PLATFORM_TEST_CHECK( PlatformRTCHost_IsTimer2PoweredOn() );
+	PLATFORM_TEST_CHECK( PlatformRTC_Init( 0 ) == PlatformStatus_AlreadyInitialized );
+	PLATFORM_TEST_CHECK( PlatformRTC_Deinit() == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( !PlatformRTCHost_AreInterruptsEnabled() );
+	PLATFORM_TEST_CHECK( !PlatformRTCHost_IsTimer2PoweredOn() );
+	
+	// Global interrupts the application already enabled are left alone
+	PlatformRTCHost_SetInterruptsEnabled( true );
+	PLATFORM_TEST_CHECK( PlatformRTC_Init( 0 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTC_Deinit() == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTCHost_AreInterruptsEnabled() );
+	
+	// Nothing is counted while deinitialized
+	PlatformRTCHost_Advance( 10 * PLATFORM_RTC_SUB_SECONDS_PER_SECOND );
+	PLATFORM_TEST_CHECK( PlatformRTC_Init( 1000 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( PlatformRTC_GetTime( &seconds, NULL ) == PlatformStatus_Success ) && ( seconds == 1000 ));
+	PLATFORM_TEST_CHECK( PlatformRTC_GetTime( NULL, NULL ) == PlatformStatus_InvalidArgument );
+}
+
+static void _PlatformRTCTest_TimeKeeping( void )
+{
+	uint32_t seconds    = 0;
+	uint8_t  subSeconds = 0;
+	
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( 1000 ) == PlatformStatus_Success );
+	PlatformRTCHost_Advance( 10 * PLATFORM_RTC_SUB_SECONDS_PER_SECOND + 100 );
+	PLATFORM_TEST_CHECK( PlatformRTC_GetTime( &seconds, &subSeconds ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( seconds == 1010 ) && ( subSeconds == 100 ));
+	
+	// An overflow that the ISR has not serviced yet is still counted
+	PlatformRTCHost_SetInterruptsEnabled( false );
+	PlatformRTCHost_Advance( PLATFORM_RTC_SUB_SECONDS_PER_SECOND - 100 + 5 );
+	PLATFORM_TEST_CHECK( PlatformRTC_GetTime( &seconds, &subSeconds ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( seconds == 1011 ) && ( subSeconds == 5 ));
+	PLATFORM_TEST_CHECK( !PlatformRTCHost_AreInterruptsEnabled() );
+	PlatformRTCHost_SetInterruptsEnabled( true );
+	PLATFORM_TEST_CHECK( PlatformRTC_GetTime( &seconds, &subSeconds ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( seconds == 1011 ) && ( subSeconds == 5 ));
+	
+	// Setting the time restarts the second, and drops an unserviced overflow
+	PlatformRTCHost_SetInterruptsEnabled( false );
+	PlatformRTCHost_Advance( PLATFORM_RTC_SUB_SECONDS_PER_SECOND );
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( 6000 ) == PlatformStatus_Success );
+	PlatformRTCHost_SetInterruptsEnabled( true );
+	PLATFORM_TEST_CHECK( PlatformRTC_GetTime( &seconds, &subSeconds ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( seconds == 6000 ) && ( subSeconds == 0 ));
+	
+	// A long run loses nothing
+	_PlatformRTCTest_RunSeconds( 7 * PLATFORM_RTC_TEST_SECONDS_PER_DAY );
+	PLATFORM_TEST_CHECK( PlatformRTC_GetTime( &seconds, &subSeconds ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( seconds == 6000 + 7 * PLATFORM_RTC_TEST_SECONDS_PER_DAY ) && ( subSeconds == 0 ));
+	
+	// The count wraps at the end of its range
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( UINT32_MAX ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 2 );
+	PLATFORM_TEST_CHECK(( PlatformRTC_GetTime( &seconds, NULL ) == PlatformStatus_Success ) && ( seconds == 1 ));
+}
+
+static void _PlatformRTCTest_Calendar( void )
+{
+	static const PlatformRTCDateTime_t kInvalidDateTimes[] = 
+	{
+		// year, month, day, hour, minute, second, weekday
+		{ 1999, 12, 31, 23, 59, 59, 0 },
+		{ 2136,  1,  1,  0,  0,  0, 0 },
+		{ 2001,  2, 29,  0,  0,  0, 0 },
+		{ 2100,  2, 29,  0,  0,  0, 0 },
+		{ 2024,  4, 31,  0,  0,  0, 0 },
+		{ 2024,  0,  1,  0,  0,  0, 0 },
+		{ 2024, 13,  1,  0,  0,  0, 0 },
+		{ 2024,  1,  0,  0,  0,  0, 0 },
+		{ 2024,  1,  1, 24,  0,  0, 0 },
+		{ 2024,  1,  1,  0, 60,  0, 0 },
+		{ 2024,  1,  1,  0,  0, 60, 0 },
+	};
+	const PlatformRTCDateTime_t kLeapDay = { 2024, 2, 29, 12, 34, 56, 0 };
+	PlatformRTCDateTime_t dateTime;
+	uint32_t seconds;
+	uint32_t day;
+	
+	// Every midnight and the last second of every day, from the epoch to the end of the range
+	for ( day = 0; day <= ( UINT32_MAX / PLATFORM_RTC_TEST_SECONDS_PER_DAY ); day++ )
+	{
+		_PlatformRTCTest_CheckConversion( day * PLATFORM_RTC_TEST_SECONDS_PER_DAY );
+		
+		if ( day < ( UINT32_MAX / PLATFORM_RTC_TEST_SECONDS_PER_DAY ))
+		{
+			_PlatformRTCTest_CheckConversion( day * PLATFORM_RTC_TEST_SECONDS_PER_DAY + PLATFORM_RTC_TEST_SECONDS_PER_DAY - 1 );
+		}
+	}
+	
+	// Times of day, stepping by a prime so every hour, minute and second is covered
+	for ( seconds = 0; seconds < ( UINT32_MAX - 7919 ); seconds += 7919 )
+	{
+		_PlatformRTCTest_CheckConversion( seconds );
+	}
+	_PlatformRTCTest_CheckConversion( UINT32_MAX );
+	
+	for ( size_t i = 0; i < ( sizeof( kInvalidDateTimes ) / sizeof( kInvalidDateTimes[0] )); i++ )
+	{
+		PLATFORM_TEST_CHECK( PlatformRTCCalendar_DateTimeToSeconds( &kInvalidDateTimes[i], &seconds ) == PlatformStatus_InvalidArgument );
+	}
+	PLATFORM_TEST_CHECK( PlatformRTCCalendar_SecondsToDateTime( 0, NULL ) == PlatformStatus_InvalidArgument );
+	
+	// Through the RTC, a leap day rolls over into March
+	PLATFORM_TEST_CHECK( PlatformRTC_SetDateTime( &kLeapDay ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( PLATFORM_RTC_TEST_SECONDS_PER_DAY );
+	PLATFORM_TEST_CHECK( PlatformRTC_GetDateTime( &dateTime ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK(( dateTime.year == 2024 ) && ( dateTime.month == 3 ) && ( dateTime.day == 1 ) && ( dateTime.weekday == 5 ));
+	PLATFORM_TEST_CHECK(( dateTime.hour == 12 ) && ( dateTime.minute == 34 ) && ( dateTime.second == 56 ));
+	PLATFORM_TEST_CHECK( PlatformRTC_SetDateTime( &kInvalidDateTimes[2] ) == PlatformStatus_InvalidArgument );
+}
+
+static void _PlatformRTCTest_OneShotAlarms( void )
+{
+	mPlatformRTCTestNumAlarms = 0;
+	
+	PLATFORM_TEST_CHECK( PlatformRTC_SetAlarm( 0, 0, NULL ) != PlatformStatus_Success );
+	
+	// Fires once, on the second it is set for
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( 1000 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTC_SetAlarm( 1005, 0, _PlatformRTCTest_AlarmCb ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 4 );
+	PLATFORM_TEST_CHECK( mPlatformRTCTestNumAlarms == 0 );
+	_PlatformRTCTest_RunSeconds( 10 );
+	PLATFORM_TEST_CHECK(( mPlatformRTCTestNumAlarms == 1 ) && ( mPlatformRTCTestAlarms[0] == 1005 ));
+	
+	// An alarm already in the past fires on the next second
+	mPlatformRTCTestNumAlarms = 0;
+	PLATFORM_TEST_CHECK( PlatformRTC_SetAlarm( 500, 0, _PlatformRTCTest_AlarmCb ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 3 );
+	PLATFORM_TEST_CHECK(( mPlatformRTCTestNumAlarms == 1 ) && ( mPlatformRTCTestAlarms[0] == 1015 ));
+	
+	// A cancelled alarm never fires
+	mPlatformRTCTestNumAlarms = 0;
+	PLATFORM_TEST_CHECK( PlatformRTC_SetAlarm( 1020, 0, _PlatformRTCTest_AlarmCb ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTC_CancelAlarm() == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 10 );
+	PLATFORM_TEST_CHECK( mPlatformRTCTestNumAlarms == 0 );
+	
+	// An alarm just past the wrap of the count is not mistaken for one in the past
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( UINT32_MAX - 5 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTC_SetAlarm( 2, 0, _PlatformRTCTest_AlarmCb ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 7 );
+	PLATFORM_TEST_CHECK( mPlatformRTCTestNumAlarms == 0 );
+	_PlatformRTCTest_RunSeconds( 1 );
+	PLATFORM_TEST_CHECK(( mPlatformRTCTestNumAlarms == 1 ) && ( mPlatformRTCTestAlarms[0] == 2 ));
+}
+
+static void _PlatformRTCTest_RepeatingAlarms( void )
+{
+	const uint32_t kStart    = 20000;
+	const uint32_t kFirst    = kStart + 3;
+	const uint32_t kInterval = 7;
+	uint32_t numExpected = 0;
+	bool     isMatching  = true;
+	
+	// Every occurrence fires, on its second, against a count of the seconds that should have fired
+	mPlatformRTCTestNumAlarms = 0;
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( kStart ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTC_SetAlarm( kFirst, kInterval, _PlatformRTCTest_AlarmCb ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 5000 );
+	
+	for ( uint32_t seconds = kStart + 1; seconds <= kStart + 5000; seconds++ )
+	{
+		if (( seconds >= kFirst ) && ((( seconds - kFirst ) % kInterval ) == 0 ))
+		{
+			isMatching = isMatching && ( numExpected < mPlatformRTCTestNumAlarms ) && ( mPlatformRTCTestAlarms[ numExpected ] == seconds );
+			numExpected++;
+		}
+	}
+	PLATFORM_TEST_CHECK( isMatching );
+	PLATFORM_TEST_CHECK( mPlatformRTCTestNumAlarms == numExpected );
+	
+	// Jumping the time forward fires once for the missed occurrences, then carries on at the same phase
+	mPlatformRTCTestNumAlarms = 0;
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( kStart + 10000 ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 1 );
+	PLATFORM_TEST_CHECK(( mPlatformRTCTestNumAlarms == 1 ) && ( mPlatformRTCTestAlarms[0] == kStart + 10001 ));
+	_PlatformRTCTest_RunSeconds( kInterval );
+	PLATFORM_TEST_CHECK( mPlatformRTCTestNumAlarms == 2 );
+	PLATFORM_TEST_CHECK((( mPlatformRTCTestAlarms[1] - kFirst ) % kInterval ) == 0 );
+	PLATFORM_TEST_CHECK(( mPlatformRTCTestAlarms[1] > kStart + 10001 ) && ( mPlatformRTCTestAlarms[1] <= kStart + 10001 + kInterval ));
+	
+	// An hourly alarm over 30 days
+	mPlatformRTCTestNumAlarms = 0;
+	PLATFORM_TEST_CHECK( PlatformRTC_SetTime( 0 ) == PlatformStatus_Success );
+	PLATFORM_TEST_CHECK( PlatformRTC_SetAlarm( 3600, 3600, _PlatformRTCTest_AlarmCb ) == PlatformStatus_Success );
+	_PlatformRTCTest_RunSeconds( 30 * PLATFORM_RTC_TEST_SECONDS_PER_DAY );
+	PLATFORM_TEST_CHECK( mPlatformRTCTestNumAlarms == 30 * 24 );
+	PLATFORM_TEST_CHECK(( mPlatformRTCTestAlarms[0] == 3600 ) && ( mPlatformRTCTestAlarms[ 30 * 24 - 1 ] == 30 * PLATFORM_RTC_TEST_SECONDS_PER_DAY ));
+	
+	PLATFORM_TEST_CHECK( PlatformRTC_CancelAlarm() == PlatformStatus_Success );
+}
\ No newline at end of file
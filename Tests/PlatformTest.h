@@ -0,0 +1,35 @@
+/*
+ * PlatformTest.h
+ *
+ * Minimal check macros for the host tests in this directory. Each test is a single program that returns non-zero if any check failed.
+ *
+ * Created: 2026-10-18 9:42:30 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef PLATFORMTEST_H_
+#define PLATFORMTEST_H_
+
+#include <stdio.h>
+
+static unsigned int mPlatformTestNumChecks;
+static unsigned int mPlatformTestNumFailures;
+
+#define PLATFORM_TEST_CHECK( COND )                                                    \
+	do                                                                                 \
+	{                                                                                  \
+		mPlatformTestNumChecks++;                                                      \
+		if ( !( COND ))                                                                \
+		{                                                                              \
+			printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #COND );          \
+			mPlatformTestNumFailures++;                                                \
+		}                                                                              \
+	} while ( 0 )
+
+// Prints the summary, and evaluates to the exit code for main()
+#define PLATFORM_TEST_RESULT()                                                                                \
+	( printf( "%u checks, %u failed\n", mPlatformTestNumChecks, mPlatformTestNumFailures ),                  \
+	  ( mPlatformTestNumFailures == 0 ) ? 0 : 1 )
+
+#endif /* PLATFORMTEST_H_ */
\ No newline at end of file
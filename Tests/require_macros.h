@@ -0,0 +1,23 @@
+/*
+ * require_macros.h
+ *
+ * Host stand-in for the require macros used throughout the Platform modules, so the host tests in this directory build without the full toolchain.
+ * Only the forms the modules use are defined, and none of them log.
+ *
+ * Created: 2026-10-18 9:41:12 PM
+ *  Author: Felix
+ */ 
+
+
+#ifndef REQUIRE_MACROS_H_
+#define REQUIRE_MACROS_H_
+
+#define require( COND, LABEL )                              do { if ( !( COND )) { goto LABEL; } } while ( 0 )
+#define require_quiet( COND, LABEL )                        do { if ( !( COND )) { goto LABEL; } } while ( 0 )
+#define require_action( COND, LABEL, ACTION )               do { if ( !( COND )) { ACTION; goto LABEL; } } while ( 0 )
+#define require_action_quiet( COND, LABEL, ACTION )         do { if ( !( COND )) { ACTION; goto LABEL; } } while ( 0 )
+#define require_noerr( ERR, LABEL )                         do { if ( ERR ) { goto LABEL; } } while ( 0 )
+#define require_noerr_quiet( ERR, LABEL )                   do { if ( ERR ) { goto LABEL; } } while ( 0 )
+#define require_noerr_action_quiet( ERR, LABEL, ACTION )    do { if ( ERR ) { ACTION; goto LABEL; } } while ( 0 )
+
+#endif /* REQUIRE_MACROS_H_ */
\ No newline at end of file